@@ -56,6 +56,9 @@ ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
 
 static const float MIN_RADIUS = 110.0f;
 
+//! Only used by the pathfinder thread - wander paths replay identically for a given seed.
+static RandomStream pathRandom("pathfinder");
+
 #define frnd() (1.0f - 2 * rnd())
 
 const float PathFinder::HEURISTIC_MIN = 0.0f;
@@ -353,17 +356,17 @@ bool PathFinder::wanderAround(NodeId from, float rad, Result & rlist, bool steal
 	
 	NodeId last = from;
 	
-	unsigned int step_c = Random::get(4, 9);
+	unsigned int step_c = pathRandom.get(4, 9);
 	for(unsigned int i = 0; i < step_c; i++) {
 		
 		NodeId next = from;
 		
 		// Select the next node.
-		unsigned int nb = Random::get(0, rad / 50);
+		unsigned int nb = pathRandom.get(0, rad / 50);
 		for(unsigned int j = 0; j < nb && map_d[next].nblinked; j++) {
 			for(int notfinished = 0; notfinished < 4; notfinished++) {
 				
-				size_t r = Random::get(0, map_d[next].nblinked - 1);
+				size_t r = pathRandom.get(0, map_d[next].nblinked - 1);
 				arx_assert(r < (size_t)map_d[next].nblinked);
 				
 				arx_assert(map_d[next].linked[r] >= 0);
@@ -424,10 +427,11 @@ bool PathFinder::lookFor(NodeId from, const Vec3f & pos, float radius, Result &
 	
 	NodeId last = from;
 	
-	unsigned long step_c = Random::get(4, 9);
+	unsigned long step_c = pathRandom.get(4, 9);
 	for(unsigned long i = 0; i < step_c; i++) {
 		
-		Vec3f pos = map_d[to].pos + randomVec(-1.f, 1.f) * radius;
+		Vec3f offset(pathRandom.getf(-1.f, 1.f), pathRandom.getf(-1.f, 1.f), pathRandom.getf(-1.f, 1.f));
+		Vec3f pos = map_d[to].pos + offset * radius;
 		
 		NodeId next = getNearestNode(pos);
 		
@@ -79,6 +79,7 @@ ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
 #include "math/Random.h"
 
 #include "platform/Platform.h"
+#include "platform/Profiler.h"
 
 #include "physics/Box.h"
 #include "physics/Collisions.h"
@@ -201,6 +202,7 @@ ARX_PATH * ARX_PATH_CheckPlayerInZone()
 long JUST_RELOADED = 0;
 
 void ARX_PATH_UpdateAllZoneInOutInside() {
+	ARX_PROFILE_FUNC();
 	
 	if(EDITMODE) {
 		return;
@@ -58,6 +58,7 @@ ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
 #include <boost/lexical_cast.hpp>
 
 #include "animation/AnimationRender.h"
+#include "animation/AnimationTracks.h"
 
 #include "core/Application.h"
 #include "core/GameTime.h"
@@ -308,10 +309,23 @@ long EERIE_ANIMMANAGER_Count( std::string& tex, long * memsize)
 			char txx[256];
 			strcpy(txx,animations[i].path.string().c_str());
 			long totsize=0;
+			long rawsize=0;
+			
+			for(long k = 0; k < animations[i].alt_nb; k++) {
+				const EERIE_ANIM * anim = animations[i].anims[k];
+				if(!anim) {
+					continue;
+				}
+				totsize += sizeof(EERIE_ANIM) + sizeof(EERIE_FRAME) * anim->nb_key_frames
+				           + anim->nb_groups + anim->groups->memorySize();
+				rawsize += sizeof(EERIE_ANIM) + sizeof(EERIE_FRAME) * anim->nb_key_frames
+				           + anim->nb_groups + anim->groups->rawSize();
+			}
 
-			sprintf(temp, "%3ld[%3lu] %s size %ld Locks %ld Alt %d\r\n", count, (unsigned long)i,
-			        txx, totsize, animations[i].locks, animations[i].alt_nb - 1);
-			memsize+=totsize;
+			sprintf(temp, "%3ld[%3lu] %s size %ld (raw %ld) Locks %ld Alt %d\r\n",
+			        count, (unsigned long)i, txx, totsize, rawsize, animations[i].locks,
+			        animations[i].alt_nb - 1);
+			*memsize += totsize;
 			tex += temp;
 		}
 	}
@@ -590,7 +604,8 @@ static void StoreEntityMovement(Entity * io, Vec3f & ftr, float scale) {
 
 extern bool EXTERNALVIEW;
 
-void EERIEDrawAnimQuat(EERIE_3DOBJ *eobj, ANIM_USE *eanim, Anglef *angle, Vec3f *pos, unsigned long time, Entity *io, bool render, bool update_movement) {
+bool EERIEPrepareAnimQuat(EERIE_3DOBJ * eobj, ANIM_USE * eanim, unsigned long time, Entity * io,
+                          bool update_movement, Vec3f & ftr, float & scale) {
 	
 	if(io) {
 		float speedfactor = io->basespeed + io->speed_modif;
@@ -614,10 +629,10 @@ void EERIEDrawAnimQuat(EERIE_3DOBJ *eobj, ANIM_USE *eanim, Anglef *angle, Vec3f
 	}
 
 	// Reset Frame Translate
-	Vec3f ftr = Vec3f::ZERO;
+	ftr = Vec3f::ZERO;
 
 	// Set scale and invisibility factors
-	float scale = Cedric_GetScale(io);
+	scale = Cedric_GetScale(io);
 
 
 	if(!io)
@@ -629,12 +644,14 @@ void EERIEDrawAnimQuat(EERIE_3DOBJ *eobj, ANIM_USE *eanim, Anglef *angle, Vec3f
 		StoreEntityMovement(io, ftr, scale);
 
 	if(io && io != entities.player() && !Cedric_IO_Visible(&io->pos))
-		return;
-
-
-	Cedric_AnimateDrawEntity(eobj, eanim, angle, pos, io, ftr, scale);
-
+		return false;
+	
+	return true;
+}
 
+void EERIEFinishAnimQuat(EERIE_3DOBJ * eobj, Vec3f * pos, Vec3f & ftr, Entity * io, bool render,
+                         bool detailedLighting) {
+	
 	bool isFightingNpc = io &&
 						 (io->ioflags & IO_NPC) &&
 						 (io->_npcdata->behavior & BEHAVIOUR_FIGHT) &&
@@ -644,7 +661,20 @@ void EERIEDrawAnimQuat(EERIE_3DOBJ *eobj, ANIM_USE *eanim, Anglef *angle, Vec3f
 		return;
 
 	if(render)
-		Cedric_AnimateDrawEntityRender(eobj, pos, ftr, io);
+		Cedric_AnimateDrawEntityRender(eobj, pos, ftr, io, detailedLighting);
+}
+
+void EERIEDrawAnimQuat(EERIE_3DOBJ *eobj, ANIM_USE *eanim, Anglef *angle, Vec3f *pos, unsigned long time, Entity *io, bool render, bool update_movement) {
+	
+	Vec3f ftr;
+	float scale;
+	if(!EERIEPrepareAnimQuat(eobj, eanim, time, io, update_movement, ftr, scale)) {
+		return;
+	}
+	
+	Cedric_AnimateDrawEntity(eobj, eanim, angle, pos, io, ftr, scale);
+	
+	EERIEFinishAnimQuat(eobj, pos, ftr, io, render);
 }
 
 // List of TO-TREAT vertex for MIPMESHING
@@ -90,6 +90,25 @@ void EERIE_ANIMMANAGER_ReloadAll();
 
 void EERIEDrawAnimQuat(EERIE_3DOBJ *eobj, ANIM_USE *eanim, Anglef *angle, Vec3f *pos, unsigned long time, Entity *io, bool render = true, bool update_movement = true);
 
+/*!
+ * First part of EERIEDrawAnimQuat(): advance the animation and update the entity movement.
+ * 
+ * Must be called from the main thread.
+ * @return false if the entity is not visible and doesn't need to be posed.
+ */
+bool EERIEPrepareAnimQuat(EERIE_3DOBJ * eobj, ANIM_USE * eanim, unsigned long time, Entity * io,
+                          bool update_movement, Vec3f & ftr, float & scale);
+
+/*!
+ * Last part of EERIEDrawAnimQuat(): draw an entity that has been posed using
+ * Cedric_AnimateEntity().
+ * 
+ * Must be called from the main thread.
+ * @param detailedLighting see Cedric_AnimateDrawEntityRender()
+ */
+void EERIEFinishAnimQuat(EERIE_3DOBJ * eobj, Vec3f * pos, Vec3f & ftr, Entity * io, bool render,
+                         bool detailedLighting = true);
+
 void DrawEERIEInter(EERIE_3DOBJ *eobj, const EERIE_QUAT *rotation, Vec3f *pos, Entity *io, EERIE_MOD_INFO *modinfo = NULL, bool thrownEntity = false);
 
 #endif // ARX_ANIMATION_ANIMATION_H
@@ -49,6 +49,7 @@ ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
 #include <algorithm>
 
 #include "animation/Animation.h"
+#include "animation/AnimationTracks.h"
 
 #include "core/Application.h"
 #include "core/GameTime.h"
@@ -70,6 +71,7 @@ ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
 #include "graphics/data/Mesh.h"
 #include "graphics/data/MeshManipulation.h"
 #include "graphics/data/TextureContainer.h"
+#include "graphics/data/VertexKernels.h"
 #include "graphics/particle/ParticleEffects.h"
 
 #include "math/Angle.h"
@@ -98,18 +100,9 @@ extern long TSU_TEST_NB_LIGHT;
 	float SOFTNEARCLIPPZ=1.f;
 #endif
 
-/* Init bounding box */
-inline	static	void	Cedric_ResetBoundingBox(Entity * io)
-{
-	// resets 2D Bounding Box
-	BBOXMIN.y = BBOXMIN.x = 32000;
-	BBOXMAX.y = BBOXMAX.x = -32000;
-	// Resets 3D Bounding Box
-	ResetBBox3D(io);
-}
-
 extern float INVISIBILITY_OVERRIDE;
 extern bool EXTERNALVIEW;
+extern EERIEMATRIX ProjectionMatrix;
 float Cedric_GetScale(Entity * io) {
 	if(io) {
 		// Scaling Value for this object (Movements will also be scaled)
@@ -153,7 +146,15 @@ static void Cedric_AnimateObject(Entity *io, EERIE_3DOBJ *eobj, ANIM_USE *animus
 {
 	EERIE_C_DATA	* obj = eobj->c_data;
 
-	std::vector<unsigned char> grps(eobj->nbgroups);
+	// Groups that have already been set by a higher animation layer
+	unsigned char grpsBuffer[128];
+	std::vector<unsigned char> grpsHeap;
+	unsigned char * grps = grpsBuffer;
+	if(size_t(eobj->nbgroups) > ARRAY_SIZE(grpsBuffer)) {
+		grpsHeap.resize(eobj->nbgroups);
+		grps = &grpsHeap[0];
+	}
+	std::fill(grps, grps + std::max(eobj->nbgroups, 0l), 0);
 
 	for(long count = MAX_ANIM_LAYERS - 1; count >= 0; count--) {
 		EERIE_QUAT		t, temp;
@@ -187,21 +188,22 @@ static void Cedric_AnimateObject(Entity *io, EERIE_3DOBJ *eobj, ANIM_USE *animus
 			if(grps[j])
 				continue;
 
-			EERIE_GROUP * sGroup = &eanim->groups[j+(animuse->fr*eanim->nb_groups)];
-			EERIE_GROUP * eGroup = &eanim->groups[j+(animuse->fr*eanim->nb_groups)+eanim->nb_groups];
-
 			if(!eanim->voidgroups[j])
 				grps[j] = 1;
 
 			if(eanim->nb_key_frames != 1) {
-				Quat_Slerp(&t, &sGroup->quat, &eGroup->quat, animuse->pour);
+				EERIE_GROUP sGroup, eGroup;
+				eanim->groups->sample(j, animuse->fr, sGroup);
+				eanim->groups->sample(j, animuse->fr + 1, eGroup);
+				
+				Quat_Slerp(&t, &sGroup.quat, &eGroup.quat, animuse->pour);
 				Quat_Copy(&temp, &obj->bones[j].quatinit);
 				Quat_Multiply(&obj->bones[j].quatinit, &temp, &t);
 
-				Vec3f vect = sGroup->translate + (eGroup->translate - sGroup->translate) * animuse->pour;
+				Vec3f vect = sGroup.translate + (eGroup.translate - sGroup.translate) * animuse->pour;
 				obj->bones[j].transinit = vect + obj->bones[j].transinit_global;
 
-				Vec3f scale = sGroup->zoom + (eGroup->zoom - sGroup->zoom) * animuse->pour;
+				Vec3f scale = sGroup.zoom + (eGroup.zoom - sGroup.zoom) * animuse->pour;
 				if(BH_MODE && j == eobj->fastaccess.head_group) {
 					scale += Vec3f::ONE;
 				}
@@ -253,7 +255,26 @@ void EE_RT(Vec3f * in, Vec3f * out);
 void EE_P(Vec3f * in, TexturedVertex * out);
 
 /* Transform object vertices  */
-void Cedric_TransformVerts(Entity *io, EERIE_3DOBJ *eobj, EERIE_C_DATA *obj, Vec3f *pos) {
+static vertexkernels::ProjectionParams Cedric_GetProjectionParams() {
+	
+	const EERIE_TRANSFORM & trans = ACTIVECAM->orgTrans;
+	
+	vertexkernels::ProjectionParams params;
+	params.pos = trans.pos;
+	params.xsin = trans.xsin, params.xcos = trans.xcos;
+	params.ysin = trans.ysin, params.ycos = trans.ycos;
+	params.zsin = trans.zsin, params.zcos = trans.zcos;
+	params.scaleX = ProjectionMatrix._11;
+	params.scaleY = ProjectionMatrix._22;
+	params.depthScale = ProjectionMatrix._33;
+	params.depthOffset = ProjectionMatrix._43;
+	params.offset = trans.mod;
+	
+	return params;
+}
+
+static void Cedric_TransformVerts(Entity *io, EERIE_3DOBJ *eobj, EERIE_C_DATA *obj, Vec3f *pos,
+                                  Vec2f & bboxMin, Vec2f & bboxMax) {
 
  	/* Transform & project all vertices */
 	for(long i = 0; i != obj->nb_bones; i++) {
@@ -275,13 +296,8 @@ void Cedric_TransformVerts(Entity *io, EERIE_3DOBJ *eobj, EERIE_C_DATA *obj, Vec
 		matrix._32 *= obj->bones[i].scaleanim.z;
 		matrix._33 *= obj->bones[i].scaleanim.z;
 		
-		for(int v = 0; v != obj->bones[i].nb_idxvertices; v++) {
-			EERIE_3DPAD * inVert  = &eobj->vertexlocal[obj->bones[i].idxvertices[v]];
-			EERIE_VERTEX * outVert = &eobj->vertexlist3[obj->bones[i].idxvertices[v]];
-			TransformVertexMatrix(&matrix, inVert, &outVert->v);
-			outVert->v += vector;
-			outVert->vert.p = outVert->v;
-		}
+		vertexkernels::skinVertices(matrix, vector, eobj->vertexlocal, obj->bones[i].idxvertices,
+		                            size_t(obj->bones[i].nb_idxvertices), &eobj->vertexlist3[0]);
 	}
 
 	if(eobj->cdata && eobj->sdata) {
@@ -290,26 +306,25 @@ void Cedric_TransformVerts(Entity *io, EERIE_3DOBJ *eobj, EERIE_C_DATA *obj, Vec
 		}
 	}
 
-	for(size_t i = 0; i < eobj->vertexlist.size(); i++) {
-		EERIE_VERTEX * outVert = &eobj->vertexlist3[i];
-		AddToBBox3D(io, &outVert->v);
-		EE_RT(&outVert->vert.p, &outVert->vworld);
-		EE_P(&outVert->vworld, &outVert->vert);
-
-		// Updates 2D Bounding Box
-		if(outVert->vert.rhw > 0.f) {
-			BBOXMIN.x = min(BBOXMIN.x, outVert->vert.p.x);
-			BBOXMAX.x = max(BBOXMAX.x, outVert->vert.p.x);
-			BBOXMIN.y = min(BBOXMIN.y, outVert->vert.p.y);
-			BBOXMAX.y = max(BBOXMAX.y, outVert->vert.p.y);
-		}
+	// Without an entity, the 3D bounding box is computed but not stored
+	Vec3f min3D, max3D;
+	if(io) {
+		min3D = io->bbox3D.min, max3D = io->bbox3D.max;
+	} else {
+		min3D = max3D = Vec3f::ZERO;
+	}
+	
+	if(!eobj->vertexlist.empty()) {
+		vertexkernels::projectVertices(Cedric_GetProjectionParams(), &eobj->vertexlist3[0],
+		                               eobj->vertexlist.size(), min3D, max3D, bboxMin, bboxMax);
 	}
 
 	if(io) {
-		io->bbox1.x = (short)BBOXMIN.x;
-		io->bbox2.x = (short)BBOXMAX.x;
-		io->bbox1.y = (short)BBOXMIN.y;
-		io->bbox2.y = (short)BBOXMAX.y;
+		io->bbox3D.min = min3D, io->bbox3D.max = max3D;
+		io->bbox1.x = (short)bboxMin.x;
+		io->bbox2.x = (short)bboxMax.x;
+		io->bbox1.y = (short)bboxMin.y;
+		io->bbox2.y = (short)bboxMax.y;
 	}
 }
 
@@ -471,7 +486,17 @@ void Cedric_ApplyLightingFirstPartRefactor(Entity *io, Color3f &special_color, l
 }
 
 /* Object dynamic lighting */
-static void Cedric_ApplyLighting(EERIE_3DOBJ * eobj, EERIE_C_DATA * obj, Entity * io, Vec3f * pos, Color3f &special_color, long &special_color_flag) {
+namespace {
+
+//! A dynamic light evaluated at the origin of a bone
+struct BoneLight {
+	Vec3f dir; //!< Direction to the light in bone space
+	Color3f color; //!< Light color scaled by the attenuation
+};
+
+} // anonymous namespace
+
+static void Cedric_ApplyLighting(EERIE_3DOBJ * eobj, EERIE_C_DATA * obj, Entity * io, Vec3f * pos, Color3f &special_color, long &special_color_flag, bool detailed) {
 		
 	Color3f infra = Color3f::black;
 	if(Project.improve) {
@@ -502,10 +527,37 @@ static void Cedric_ApplyLighting(EERIE_3DOBJ * eobj, EERIE_C_DATA * obj, Entity
 		Insertllight(PDL[i], dist(PDL[i]->pos, tv));
 	}
 
+	BoneLight boneLights[ARRAY_SIZE(llights)];
+	
 	/* Apply light on all vertices */
 	for(int i = 0; i != obj->nb_bones; i++) {
 
 		EERIE_QUAT *qt1 = &obj->bones[i].quatanim;
+		
+		// For small objects, only evaluate the lights once per bone
+		size_t nbBoneLights = 0;
+		for(int l = 0; !detailed && l != MAX_LLIGHTS; l++) {
+			EERIE_LIGHT * light = llights[l];
+			if(!light) {
+				break;
+			}
+			
+			Vec3f tl = light->pos - obj->bones[i].transanim;
+			float distance = ffsqrt(tl.lengthSqr());
+			if(distance >= light->fallend) {
+				continue;
+			}
+			
+			float intensity = light->precalc;
+			if(distance > light->fallstart) {
+				intensity *= (light->fallend - distance) * light->falldiffmul;
+			}
+			
+			tl *= 1.f / distance;
+			BoneLight & boneLight = boneLights[nbBoneLights++];
+			TransformInverseVertexQuat(qt1, &tl, &boneLight.dir);
+			boneLight.color = light->rgb255 * intensity;
+		}
 
 		/* Get light value for each vertex */
 		for(int v = 0; v != obj->bones[i].nb_idxvertices; v++) {
@@ -518,9 +570,16 @@ static void Cedric_ApplyLighting(EERIE_3DOBJ * eobj, EERIE_C_DATA * obj, Entity
 				tempColor = ACTIVEBKG->ambient255;
 
 			Vec3f posVert = eobj->vertexlist[obj->bones[i].idxvertices[v]].norm;
+			
+			for(size_t l = 0; l != nbBoneLights; l++) {
+				float cosangle = dot(posVert, boneLights[l].dir);
+				if(cosangle > 0.f) {
+					tempColor = tempColor + boneLights[l].color * cosangle;
+				}
+			}
 
 			// Dynamic lights
-			for(int l = 0; l != MAX_LLIGHTS; l++) {
+			for(int l = 0; detailed && l != MAX_LLIGHTS; l++) {
 				EERIE_LIGHT *Cur_llights = llights[l];
 
 				if(!Cur_llights)
@@ -1339,6 +1398,15 @@ void Cedric_BlendAnimation(Entity *io, EERIE_C_DATA *c_data) {
 	}
 }
 
+static void Cedric_RestoreBlendData(EERIE_C_DATA * c_data) {
+	for(long i = 0; i < c_data->nb_bones; i++) {
+		EERIE_BONE & bone = c_data->bones[i];
+		Quat_Copy(&bone.quatinit, &bone.quatlast);
+		bone.scaleinit = bone.scalelast;
+		bone.transinit = bone.translast;
+	}
+}
+
 void Cedric_SaveBlendData(EERIE_C_DATA *c_data) {
 	if (c_data)
 	{
@@ -1402,26 +1470,36 @@ bool Cedric_IO_Visible(Vec3f * pos) {
 
 
 
-/*!
- * \brief Apply animation and draw object
- */
-void Cedric_AnimateDrawEntity(EERIE_3DOBJ *eobj, ANIM_USE *animuse, Anglef *angle, Vec3f *pos, Entity *io, Vec3f & ftr, float scale) {
+void Cedric_AnimateEntity(EERIE_3DOBJ * eobj, ANIM_USE * animuse, Anglef * angle, Vec3f * pos,
+                          Entity * io, Vec3f & ftr, float scale, Vec2f & bboxMin, Vec2f & bboxMax,
+                          bool updatePose) {
 	
-	// Init some data
-	Cedric_ResetBoundingBox(io);
+	// resets 2D Bounding Box
+	bboxMin = Vec2f(32000.f, 32000.f);
+	bboxMax = Vec2f(-32000.f, -32000.f);
+	// Resets 3D Bounding Box
+	ResetBBox3D(io);
 	
-	// Manage Extra Rotations in Local Space
-	Cedric_ManageExtraRotationsFirst(io, eobj);
-
-	// Perform animation in Local space
-	Cedric_AnimateObject(io, eobj, animuse);
-
-	// Check for Animation Blending in Local space
-	if(io) {
-		// Is There any Between-Animations Interpolation to make ?
-		Cedric_BlendAnimation(io, eobj->c_data);
-
-		Cedric_SaveBlendData(io->obj->c_data);
+	if(!updatePose && io) {
+		
+		// The blend data holds the local pose from the last update
+		Cedric_RestoreBlendData(eobj->c_data);
+		
+	} else {
+		
+		// Manage Extra Rotations in Local Space
+		Cedric_ManageExtraRotationsFirst(io, eobj);
+		
+		// Perform animation in Local space
+		Cedric_AnimateObject(io, eobj, animuse);
+		
+		// Check for Animation Blending in Local space
+		if(io) {
+			// Is There any Between-Animations Interpolation to make ?
+			Cedric_BlendAnimation(io, eobj->c_data);
+			
+			Cedric_SaveBlendData(io->obj->c_data);
+		}
 	}
 
 
@@ -1439,10 +1517,23 @@ void Cedric_AnimateDrawEntity(EERIE_3DOBJ *eobj, ANIM_USE *animuse, Anglef *angl
 	if(!obj)
 		return;
 
-	Cedric_TransformVerts(io, eobj, obj, pos);
+	Cedric_TransformVerts(io, eobj, obj, pos, bboxMin, bboxMax);
+}
+
+/*!
+ * \brief Apply animation and draw object
+ */
+void Cedric_AnimateDrawEntity(EERIE_3DOBJ *eobj, ANIM_USE *animuse, Anglef *angle, Vec3f *pos, Entity *io, Vec3f & ftr, float scale) {
+	
+	Vec2f bboxMin, bboxMax;
+	Cedric_AnimateEntity(eobj, animuse, angle, pos, io, ftr, scale, bboxMin, bboxMax);
+	
+	BBOXMIN.x = bboxMin.x, BBOXMIN.y = bboxMin.y;
+	BBOXMAX.x = bboxMax.x, BBOXMAX.y = bboxMax.y;
 }
 
-void Cedric_AnimateDrawEntityRender(EERIE_3DOBJ *eobj, Vec3f *pos, Vec3f &ftr, Entity *io) {
+void Cedric_AnimateDrawEntityRender(EERIE_3DOBJ *eobj, Vec3f *pos, Vec3f &ftr, Entity *io,
+                                    bool detailedLighting) {
 
 	float invisibility = Cedric_GetInvisibility(io);
 
@@ -1461,7 +1552,7 @@ void Cedric_AnimateDrawEntityRender(EERIE_3DOBJ *eobj, Vec3f *pos, Vec3f &ftr, E
 		special_color = io->special_color;
 	}
 
-	Cedric_ApplyLighting(eobj, obj, io, pos, special_color, special_color_flag);
+	Cedric_ApplyLighting(eobj, obj, io, pos, special_color, special_color_flag, detailedLighting);
 
 	Cedric_RenderObject(eobj, obj, io, pos, ftr, invisibility);
 
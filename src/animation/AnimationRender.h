@@ -54,8 +54,30 @@ struct EERIEMATRIX;
 struct EERIE_QUAT;
 struct TexturedVertex;
 
+/*!
+ * Evaluate the skeleton pose and transform the vertices of an animated object.
+ * 
+ * This only writes to eobj and io and does not touch any global state, so it can be run
+ * for several entities in parallel as long as they do not share the same object.
+ * The 2D bounding box of the projected vertices is returned in bboxMin and bboxMax.
+ * 
+ * @param updatePose false to reuse the local bone transforms of the last update for
+ *                   this entity instead of sampling the animations. The skeleton is
+ *                   still placed at the current position.
+ */
+void Cedric_AnimateEntity(EERIE_3DOBJ * eobj, ANIM_USE * animuse, Anglef * angle, Vec3f * pos,
+                          Entity * io, Vec3f & ftr, float scale, Vec2f & bboxMin, Vec2f & bboxMax,
+                          bool updatePose = true);
+
+//! Like Cedric_AnimateEntity(), but stores the 2D bounding box in BBOXMIN and BBOXMAX
 void Cedric_AnimateDrawEntity(EERIE_3DOBJ * eobj, ANIM_USE * animuse, Anglef * angle, Vec3f * pos, Entity * io, Vec3f & ftr, float scale);
-void Cedric_AnimateDrawEntityRender(EERIE_3DOBJ *eobj, Vec3f *pos, Vec3f &ftr, Entity *io);
+/*!
+ * Light and draw a posed object.
+ * @param detailedLighting false to evaluate dynamic lights once per bone instead of
+ *                         once per vertex.
+ */
+void Cedric_AnimateDrawEntityRender(EERIE_3DOBJ *eobj, Vec3f *pos, Vec3f &ftr, Entity *io,
+                                    bool detailedLighting = true);
 
 void ARX_DrawPrimitive(TexturedVertex *, TexturedVertex *, TexturedVertex *, float _fAdd = 0.0f);
 
@@ -0,0 +1,348 @@
+/*
+ * Copyright 2013 Arx Libertatis Team (see the AUTHORS file)
+ *
+ * This file is part of Arx Libertatis.
+ *
+ * Arx Libertatis is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Arx Libertatis is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Arx Libertatis.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "animation/AnimationTracks.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+const char CACHE_MAGIC[4] = { 'A', 'N', 'T', 'R' };
+const u32 CACHE_VERSION = 2;
+
+struct CacheHeader {
+	char magic[4];
+	u32 version;
+	u32 sourceHash;
+	u32 keys;
+	u32 groups;
+	u32 keyIndices;
+	u32 values;
+};
+
+//! Interpolate between two keys, renormalizing rotations
+void interpolate(const float * a, const float * b, float f, size_t components, float * out) {
+	
+	if(components == 4) {
+		
+		float dot = a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3];
+		float sign = (dot < 0.f) ? -1.f : 1.f;
+		
+		float length = 0.f;
+		for(size_t c = 0; c < 4; c++) {
+			out[c] = a[c] + (b[c] * sign - a[c]) * f;
+			length += out[c] * out[c];
+		}
+		
+		if(length > 0.f) {
+			float scale = 1.f / std::sqrt(length);
+			for(size_t c = 0; c < 4; c++) {
+				out[c] *= scale;
+			}
+		}
+		
+	} else {
+		for(size_t c = 0; c < components; c++) {
+			out[c] = a[c] + (b[c] - a[c]) * f;
+		}
+	}
+}
+
+bool withinTolerance(const float * a, const float * b, size_t components, float tolerance) {
+	
+	// q and -q are the same rotation
+	float sign = 1.f;
+	if(components == 4 && a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3] < 0.f) {
+		sign = -1.f;
+	}
+	
+	for(size_t c = 0; c < components; c++) {
+		if(std::fabs(a[c] - b[c] * sign) > tolerance) {
+			return false;
+		}
+	}
+	
+	return true;
+}
+
+s16 quantize(float value, float base, float scale) {
+	if(scale == 0.f) {
+		return 0;
+	}
+	float q = std::floor((value - base) / scale + 0.5f);
+	return s16(std::max(-32767.f, std::min(q, 32767.f)));
+}
+
+template <class T>
+void append(std::string & buffer, const T * data, size_t count) {
+	buffer.append(reinterpret_cast<const char *>(data), sizeof(T) * count);
+}
+
+template <class T>
+bool extract(const char * & data, const char * end, std::vector<T> & out, size_t count) {
+	if(size_t(end - data) < sizeof(T) * count) {
+		return false;
+	}
+	out.resize(count);
+	if(count) {
+		std::memcpy(&out[0], data, sizeof(T) * count);
+	}
+	data += sizeof(T) * count;
+	return true;
+}
+
+} // anonymous namespace
+
+void AnimationTracks::build(const EERIE_GROUP * groups, const float * keyTimes,
+                            size_t keyCount, size_t groupCount, const Tolerance & tolerance) {
+	
+	m_keys = keyCount;
+	m_groups = groupCount;
+	m_keyTimes.assign(keyTimes, keyTimes + keyCount);
+	m_tracks.resize(groupCount * TrackTypes);
+	m_keyIndices.clear();
+	m_values.clear();
+	
+	const size_t stride = groupCount * (sizeof(EERIE_GROUP) / sizeof(float));
+	
+	for(size_t i = 0; i < groupCount; i++) {
+		const EERIE_GROUP & first = groups[i];
+		buildTrack(track(i, Rotation), 4, &first.quat.x, stride, tolerance.rotation);
+		buildTrack(track(i, Translation), 3, &first.translate.x, stride, tolerance.translation);
+		buildTrack(track(i, Zoom), 3, &first.zoom.x, stride, tolerance.zoom);
+	}
+}
+
+void AnimationTracks::build(const EERIE_GROUP * groups, const EERIE_FRAME * frames,
+                            size_t keyCount, size_t groupCount, const Tolerance & tolerance) {
+	
+	std::vector<float> keyTimes(keyCount);
+	for(size_t i = 0; i < keyCount; i++) {
+		keyTimes[i] = frames[i].time;
+	}
+	
+	build(groups, keyTimes.empty() ? NULL : &keyTimes[0], keyCount, groupCount, tolerance);
+}
+
+void AnimationTracks::buildTrack(Track & track, size_t components, const float * values,
+                                 size_t stride, float tolerance) {
+	
+	track.keyOffset = u32(m_keyIndices.size());
+	track.valueOffset = u32(m_values.size());
+	std::fill(track.base, track.base + 4, 0.f);
+	std::fill(track.scale, track.scale + 4, 0.f);
+	
+	// Constant tracks store the first key exactly
+	bool constant = true;
+	for(size_t k = 1; k < m_keys && constant; k++) {
+		constant = withinTolerance(values, values + k * stride, components, tolerance);
+	}
+	if(constant) {
+		track.count = 1;
+		if(m_keys) {
+			std::copy(values, values + components, track.base);
+		}
+		return;
+	}
+	
+	// Choose the quantization range
+	for(size_t c = 0; c < components; c++) {
+		if(components == 4) {
+			track.scale[c] = 1.f / 32767.f;
+			continue;
+		}
+		float minimum = values[c], maximum = values[c];
+		for(size_t k = 1; k < m_keys; k++) {
+			minimum = std::min(minimum, values[k * stride + c]);
+			maximum = std::max(maximum, values[k * stride + c]);
+		}
+		track.base[c] = minimum + (maximum - minimum) * 0.5f;
+		track.scale[c] = (maximum - minimum) / 65534.f;
+	}
+	
+	std::vector<float> decoded(m_keys * components);
+	for(size_t k = 0; k < m_keys; k++) {
+		for(size_t c = 0; c < components; c++) {
+			float value = values[k * stride + c];
+			s16 q = quantize(value, track.base[c], track.scale[c]);
+			decoded[k * components + c] = track.base[c] + float(q) * track.scale[c];
+		}
+	}
+	
+	// Greedily drop keys that can be interpolated from the last stored key
+	std::vector<u32> stored(1, 0);
+	size_t anchor = 0;
+	for(size_t end = 2; end < m_keys; end++) {
+		
+		bool ok = true;
+		for(size_t k = anchor + 1; k < end && ok; k++) {
+			float span = m_keyTimes[end] - m_keyTimes[anchor];
+			float f = (span > 0.f) ? (m_keyTimes[k] - m_keyTimes[anchor]) / span
+			                       : float(k - anchor) / float(end - anchor);
+			float result[4];
+			interpolate(&decoded[anchor * components], &decoded[end * components], f,
+			            components, result);
+			ok = withinTolerance(result, values + k * stride, components, tolerance);
+		}
+		
+		if(!ok) {
+			anchor = end - 1;
+			stored.push_back(u32(anchor));
+		}
+	}
+	stored.push_back(u32(m_keys - 1));
+	
+	track.count = u32(stored.size());
+	for(size_t i = 0; i < stored.size(); i++) {
+		m_keyIndices.push_back(stored[i]);
+		for(size_t c = 0; c < components; c++) {
+			float value = values[stored[i] * stride + c];
+			m_values.push_back(quantize(value, track.base[c], track.scale[c]));
+		}
+	}
+}
+
+void AnimationTracks::decode(const Track & track, size_t components, size_t key,
+                             float * out) const {
+	
+	if(track.count == 1) {
+		std::copy(track.base, track.base + components, out);
+		return;
+	}
+	
+	const u32 * begin = &m_keyIndices[track.keyOffset];
+	const u32 * end = begin + track.count;
+	size_t i = size_t(std::upper_bound(begin, end, u32(key)) - begin);
+	i = std::max(i, size_t(1)) - 1;
+	
+	float a[4];
+	const s16 * value = &m_values[track.valueOffset + i * components];
+	for(size_t c = 0; c < components; c++) {
+		a[c] = track.base[c] + float(value[c]) * track.scale[c];
+	}
+	
+	if(begin[i] == key || i + 1 == track.count) {
+		std::copy(a, a + components, out);
+		return;
+	}
+	
+	float b[4];
+	value += components;
+	for(size_t c = 0; c < components; c++) {
+		b[c] = track.base[c] + float(value[c]) * track.scale[c];
+	}
+	
+	size_t first = begin[i], last = begin[i + 1];
+	float span = m_keyTimes[last] - m_keyTimes[first];
+	float f = (span > 0.f) ? (m_keyTimes[key] - m_keyTimes[first]) / span
+	                       : float(key - first) / float(last - first);
+	interpolate(a, b, f, components, out);
+}
+
+void AnimationTracks::sample(size_t group, size_t key, EERIE_GROUP & out) const {
+	decode(track(group, Rotation), 4, key, &out.quat.x);
+	decode(track(group, Translation), 3, key, &out.translate.x);
+	decode(track(group, Zoom), 3, key, &out.zoom.x);
+}
+
+size_t AnimationTracks::storedKeys() const {
+	size_t count = 0;
+	for(size_t i = 0; i < m_tracks.size(); i++) {
+		count += m_tracks[i].count;
+	}
+	return count;
+}
+
+size_t AnimationTracks::memorySize() const {
+	return sizeof(*this)
+	       + m_keyTimes.capacity() * sizeof(float)
+	       + m_tracks.capacity() * sizeof(Track)
+	       + m_keyIndices.capacity() * sizeof(u32)
+	       + m_values.capacity() * sizeof(s16);
+}
+
+void AnimationTracks::serialize(std::string & buffer, u32 sourceHash) const {
+	
+	CacheHeader header;
+	std::copy(CACHE_MAGIC, CACHE_MAGIC + 4, header.magic);
+	header.version = CACHE_VERSION;
+	header.sourceHash = sourceHash;
+	header.keys = u32(m_keys);
+	header.groups = u32(m_groups);
+	header.keyIndices = u32(m_keyIndices.size());
+	header.values = u32(m_values.size());
+	
+	buffer.clear();
+	append(buffer, &header, 1);
+	append(buffer, m_keyTimes.empty() ? NULL : &m_keyTimes[0], m_keyTimes.size());
+	append(buffer, m_tracks.empty() ? NULL : &m_tracks[0], m_tracks.size());
+	append(buffer, m_keyIndices.empty() ? NULL : &m_keyIndices[0], m_keyIndices.size());
+	append(buffer, m_values.empty() ? NULL : &m_values[0], m_values.size());
+}
+
+bool AnimationTracks::deserialize(const char * data, size_t size, u32 sourceHash) {
+	
+	const char * end = data + size;
+	
+	CacheHeader header;
+	if(size < sizeof(header)) {
+		return false;
+	}
+	std::memcpy(&header, data, sizeof(header));
+	data += sizeof(header);
+	if(!std::equal(CACHE_MAGIC, CACHE_MAGIC + 4, header.magic)
+	   || header.version != CACHE_VERSION || header.sourceHash != sourceHash) {
+		return false;
+	}
+	
+	AnimationTracks result;
+	result.m_keys = header.keys;
+	result.m_groups = header.groups;
+	if(!extract(data, end, result.m_keyTimes, header.keys)
+	   || !extract(data, end, result.m_tracks, size_t(header.groups) * TrackTypes)
+	   || !extract(data, end, result.m_keyIndices, header.keyIndices)
+	   || !extract(data, end, result.m_values, header.values)
+	   || data != end) {
+		return false;
+	}
+	
+	// Make sure sample() can't read out of bounds
+	for(size_t i = 0; i < result.m_tracks.size(); i++) {
+		const Track & track = result.m_tracks[i];
+		size_t components = (i % TrackTypes == Rotation) ? 4 : 3;
+		if(track.count == 0 || (track.count > 1
+		   && (size_t(track.keyOffset) + track.count > result.m_keyIndices.size()
+		       || size_t(track.valueOffset) + track.count * components > result.m_values.size()))) {
+			return false;
+		}
+		for(size_t k = 0; track.count > 1 && k < track.count; k++) {
+			u32 key = result.m_keyIndices[track.keyOffset + k];
+			if(key >= result.m_keys || (k > 0 && key <= result.m_keyIndices[track.keyOffset + k - 1])
+			   || (k == 0 && key != 0)) {
+				return false;
+			}
+		}
+	}
+	
+	std::swap(*this, result);
+	
+	return true;
+}
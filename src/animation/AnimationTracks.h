@@ -0,0 +1,138 @@
+/*
+ * Copyright 2013 Arx Libertatis Team (see the AUTHORS file)
+ *
+ * This file is part of Arx Libertatis.
+ *
+ * Arx Libertatis is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Arx Libertatis is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Arx Libertatis.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ARX_ANIMATION_ANIMATIONTRACKS_H
+#define ARX_ANIMATION_ANIMATIONTRACKS_H
+
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+#include "graphics/GraphicsTypes.h"
+#include "platform/Platform.h"
+
+/*!
+ * Compressed per-group key frames of an animation.
+ * 
+ * Each group has separate rotation, translation and scale tracks:
+ *  - Tracks that don't change within the tolerance are stored once.
+ *  - Rotations are quantized to 16 bits per component, translations and
+ *    scales to 16 bits within the range of the track.
+ *  - Keys that can be interpolated from the surrounding stored keys within
+ *    the tolerance are dropped.
+ * 
+ * Keys are decoded on demand with sample().
+ */
+class AnimationTracks {
+	
+public:
+	
+	//! Maximum per-component error allowed when compressing
+	struct Tolerance {
+		
+		float rotation;
+		float translation;
+		float zoom;
+		
+		Tolerance(float _rotation = 0.001f, float _translation = 0.1f, float _zoom = 0.001f)
+			: rotation(_rotation), translation(_translation), zoom(_zoom) { }
+		
+	};
+	
+	AnimationTracks() : m_keys(0), m_groups(0) { }
+	
+	/*!
+	 * Compress key frames.
+	 * @param groups   Transformations of every group at every key, stored as
+	 *                 groups[group + key * groupCount].
+	 * @param keyTimes Time of each key since the start of the animation, used
+	 *                 to interpolate dropped keys.
+	 */
+	void build(const EERIE_GROUP * groups, const float * keyTimes, size_t keyCount,
+	           size_t groupCount, const Tolerance & tolerance = Tolerance());
+	
+	//! Compress key frames, using the (absolute) time of each frame as the key time.
+	void build(const EERIE_GROUP * groups, const EERIE_FRAME * frames, size_t keyCount,
+	           size_t groupCount, const Tolerance & tolerance = Tolerance());
+	
+	//! Decode the transformation of one group at one key frame, out.key is not changed.
+	void sample(size_t group, size_t key, EERIE_GROUP & out) const;
+	
+	size_t keys() const { return m_keys; }
+	float keyTime(size_t key) const { return m_keyTimes[key]; }
+	size_t groups() const { return m_groups; }
+	
+	//! Number of keys actually stored, summed over all tracks
+	size_t storedKeys() const;
+	
+	//! Heap memory used by the compressed data
+	size_t memorySize() const;
+	
+	//! Memory that the uncompressed key frames would use
+	size_t rawSize() const { return m_keys * m_groups * sizeof(EERIE_GROUP); }
+	
+	/*!
+	 * Store the compressed data in a buffer.
+	 * @param sourceHash identifies the data the tracks were built from
+	 */
+	void serialize(std::string & buffer, u32 sourceHash) const;
+	
+	/*!
+	 * Load data written by serialize().
+	 * @return false if the data is invalid or was built from a different source.
+	 */
+	bool deserialize(const char * data, size_t size, u32 sourceHash);
+	
+private:
+	
+	enum TrackType {
+		Rotation,
+		Translation,
+		Zoom,
+		TrackTypes
+	};
+	
+	struct Track {
+		u32 keyOffset; //!< First stored key in m_keyIndices
+		u32 valueOffset; //!< First quantized component in m_values
+		u32 count; //!< Number of stored keys, 1 for constant tracks
+		float base[4]; //!< Constant value, or offset of the quantized values
+		float scale[4]; //!< Step between quantized values
+	};
+	
+	Track & track(size_t group, TrackType type) { return m_tracks[group * TrackTypes + type]; }
+	const Track & track(size_t group, TrackType type) const {
+		return m_tracks[group * TrackTypes + type];
+	}
+	
+	void buildTrack(Track & track, size_t components, const float * values, size_t stride,
+	                float tolerance);
+	void decode(const Track & track, size_t components, size_t key, float * out) const;
+	
+	size_t m_keys;
+	size_t m_groups;
+	
+	std::vector<float> m_keyTimes;
+	std::vector<Track> m_tracks;
+	std::vector<u32> m_keyIndices;
+	std::vector<s16> m_values;
+	
+};
+
+#endif // ARX_ANIMATION_ANIMATIONTRACKS_H
@@ -58,6 +58,7 @@ ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
 
 #include "core/Config.h"
 #include "core/GameTime.h"
+#include "core/Replay.h"
 
 #include "graphics/Renderer.h"
 
@@ -109,6 +110,13 @@ bool Application::initialize() {
 		return false;
 	}
 	
+	// Replays bring their own config and random seed
+	init = replay::init();
+	if(!init) {
+		LogCritical << "Failed to initialize the replay.";
+		return false;
+	}
+	
 	init = initWindow();
 	if(!init) {
 		LogCritical << "Failed to initialize the windowing subsystem.";
@@ -127,12 +135,15 @@ bool Application::initialize() {
 		return false;
 	}
 	
-	Random::seed();
+	if(replay::getMode() == replay::Disabled) {
+		Random::seed();
+	}
 	
 	return true;
 }
 
 void Application::shutdown() {
+	replay::shutdown();
 	delete m_MainWindow, m_MainWindow = NULL;
 }
 
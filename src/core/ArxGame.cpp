@@ -48,6 +48,7 @@ ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
 #include <cstring>
 #include <algorithm>
 #include <sstream>
+#include <vector>
 
 #include <boost/foreach.hpp>
 
@@ -61,6 +62,7 @@ ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
 #include "core/Config.h"
 #include "core/GameTime.h"
 #include "core/Localisation.h"
+#include "core/Replay.h"
 #include "core/SaveGame.h"
 #include "core/Version.h"
 
@@ -79,6 +81,7 @@ ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
 #include "graphics/GraphicsModes.h"
 #include "graphics/GraphicsTypes.h"
 #include "graphics/Math.h"
+#include "graphics/RenderBatcher.h"
 #include "graphics/Renderer.h"
 #include "graphics/Vertex.h"
 #include "graphics/VertexBuffer.h"
@@ -89,6 +92,7 @@ ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
 #include "graphics/particle/ParticleEffects.h"
 #include "graphics/particle/ParticleManager.h"
 #include "graphics/texture/TextureStage.h"
+#include "graphics/texture/TextureStream.h"
 
 #include "gui/Interface.h"
 #include "gui/Menu.h"
@@ -115,6 +119,8 @@ ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
 
 #include "platform/Flags.h"
 #include "platform/Platform.h"
+#include "platform/Profiler.h"
+#include "platform/ProgramOptions.h"
 
 #include "scene/ChangeLevel.h"
 #include "scene/Interactive.h"
@@ -127,6 +133,7 @@ ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
 #include "Configure.h"
 #include "core/URLConstants.h"
 
+#include "window/NullWindow.h"
 #ifdef ARX_HAVE_D3D9
 #include "window/D3D9Window.h"
 #endif
@@ -139,6 +146,9 @@ enum InfoPanels {
 	InfoPanelFps,
 	InfoPanelDebug,
 	InfoPanelTest,
+#ifdef BUILD_PROFILER
+	InfoPanelProfiler,
+#endif
 
 	InfoPanelEnumSize
 };
@@ -218,8 +228,39 @@ Anglef LASTCAMANGLE;
 Entity * CAMERACONTROLLER=NULL;
 Entity *lastCAMERACONTROLLER=NULL;
 
+//! Simulation ticks per second, 0 to simulate once per rendered frame
+static float simulationRate = 60.f;
+
+static void setSimulationRate(const std::string & rate) {
+	std::istringstream iss(rate);
+	float value;
+	if(!(iss >> value) || value < 0.f) {
+		LogWarning << "Invalid tick rate: " << rate;
+		return;
+	}
+	simulationRate = value;
+}
+
+ARX_PROGRAM_OPTION("tick-rate", "t",
+                   "Simulation ticks per second (default 60, 0 to tick once per frame)",
+                   &setSimulationRate, "HZ");
+
+//! Copy the position and physics box vertices of a simulated entity.
+static void savePhysicsState(const Entity & io, Vec3f & pos, std::vector<Vec3f> & verts) {
+	pos = io.pos;
+	const PHYSICS_BOX_DATA & pbox = *io.obj->pbox;
+	verts.resize(pbox.nb_physvert);
+	for(long i = 0; i < pbox.nb_physvert; i++) {
+		verts[i] = pbox.vert[i].pos;
+	}
+}
+
 // ArxGame constructor. Sets attributes for the app.
-ArxGame::ArxGame() : wasResized(false) { }
+ArxGame::ArxGame()
+	: wasResized(false)
+	, m_simulation(simulationRate > 0.f ? 1000.f / simulationRate : 1.f)
+	, m_simulationTicks(0)
+{ }
 
 ArxGame::~ArxGame() {
 }
@@ -245,6 +286,8 @@ bool ArxGame::initialize()
 	
 	create();
 	
+	texturestream::init();
+	
 	return true;
 }
 
@@ -372,6 +415,15 @@ bool ArxGame::initWindow() {
 		}
 		#endif
 		
+		// The null framework is only used if explicitly requested
+		if(!m_MainWindow && first && config.window.framework == "null") {
+			matched = true;
+			RenderWindow * window = new NullWindow;
+			if(!initWindow(window)) {
+				delete window;
+			}
+		}
+		
 		if(first && !matched) {
 			LogError << "Unknown windowing framework: " << config.window.framework;
 		}
@@ -589,10 +641,18 @@ void ArxGame::run() {
 		}
 		
 		if(m_MainWindow->hasFocus() && m_bReady) {
+			
+			if(!replay::beginFrame()) {
+				quit();
+				break;
+			}
+			
 			doFrame();
 			
 			// Show the frame on the primary surface.
 			m_MainWindow->showFrame();
+			
+			replay::endFrame();
 		}
 	}
 }
@@ -601,9 +661,14 @@ void ArxGame::run() {
  * \brief Draws the scene.
  */
 void ArxGame::doFrame() {
-		
+	
+	profiler::frameStart();
+	ARX_PROFILE_FUNC();
+	
 	updateTime();
 
+	texturestream::update();
+
 	updateInput();
 
 	if(wasResized) {
@@ -652,12 +717,45 @@ void ArxGame::doFrame() {
 		
 	if(FirstFrame) {
 		FirstFrameHandling();
+		// Level loads and time restores must not be caught up in simulation ticks
+		m_simulation.reset();
+		m_interpolated.clear();
 	} else {
 		update();
 		render();
 	}
 }
 
+#ifdef BUILD_PROFILER
+
+/*!
+ * \brief Shows the per-thread time breakdown of the last frame.
+ */
+static void ShowProfilerInfo() {
+	
+	std::vector<profiler::Stat> stats;
+	profiler::getFrameStats(stats);
+	
+	int y = 32;
+	size_t thread = size_t(-1);
+	
+	for(std::vector<profiler::Stat>::const_iterator i = stats.begin(); i != stats.end(); ++i) {
+		
+		if(i->thread != thread) {
+			thread = i->thread;
+			mainApp->outputText(10, y, "[" + profiler::getThreadName(thread) + "]");
+			y += 16;
+		}
+		
+		char tex[256];
+		sprintf(tex, "%*s%s %.2fms (%u)", int(i->depth * 2), "", i->tag, i->time / 1000.f, i->count);
+		mainApp->outputText(10, y, tex);
+		y += 16;
+	}
+}
+
+#endif // BUILD_PROFILER
+
 /*!
  * \brief Cleanup scene objects
  */
@@ -1251,6 +1349,113 @@ void ArxGame::updateTime() {
 	// limit fps above 10fps
 	const float max_framedelay = 1000.0f / 10.0f;
 	framedelay = framedelay > max_framedelay ? max_framedelay : framedelay;
+	
+	if(simulationRate > 0.f) {
+		unsigned dropped = m_simulation.getDroppedTicks();
+		m_simulationTicks = m_simulation.advance(framedelay);
+		dropped = m_simulation.getDroppedTicks() - dropped;
+		if(dropped != 0) {
+			LogDebug("dropped " << dropped << " simulation ticks ("
+			         << m_simulation.getDroppedTicks() << " total)");
+		}
+	} else {
+		m_simulationTicks = 1;
+	}
+}
+
+void ArxGame::updatePhysics() {
+	ARX_PROFILE_FUNC();
+	
+	if(simulationRate <= 0.f) {
+		m_interpolated.clear();
+		ARX_PHYSICS_Apply();
+		return;
+	}
+	
+	if(m_simulationTicks == 0) {
+		return;
+	}
+	
+	float frameDelay = framedelay;
+	framedelay = m_simulation.getTickMs();
+	
+	for(unsigned tick = 0; tick < m_simulationTicks; tick++) {
+		
+		if(tick + 1 == m_simulationTicks) {
+			// Remember where physics-driven entities were before the last tick
+			m_interpolated.clear();
+			for(long i = 1; i < TREATZONE_CUR; i++) {
+				Entity * io = treatio[i].io;
+				if(io && io->obj && io->obj->pbox && io->obj->pbox->active == 1) {
+					m_interpolated.push_back(InterpolatedEntity());
+					InterpolatedEntity & entry = m_interpolated.back();
+					entry.entity = io;
+					entry.index = treatio[i].num;
+					entry.applied = false;
+					savePhysicsState(*io, entry.previousPos, entry.previousVerts);
+				}
+			}
+		}
+		
+		ARX_PHYSICS_Apply();
+	}
+	
+	for(size_t i = 0; i < m_interpolated.size(); i++) {
+		InterpolatedEntity & entry = m_interpolated[i];
+		if(ValidIONum(entry.index) && entities[entry.index] == entry.entity
+		   && entry.entity->obj && entry.entity->obj->pbox) {
+			savePhysicsState(*entry.entity, entry.currentPos, entry.currentVerts);
+		} else {
+			entry.entity = NULL;
+		}
+	}
+	
+	framedelay = frameDelay;
+}
+
+void ArxGame::applyInterpolatedState() {
+	
+	float alpha = m_simulation.getAlpha();
+	
+	for(size_t i = 0; i < m_interpolated.size(); i++) {
+		
+		InterpolatedEntity & entry = m_interpolated[i];
+		
+		// Skip entities that were destroyed or moved by something else since the last tick
+		entry.applied = entry.entity && ValidIONum(entry.index)
+		                && entities[entry.index] == entry.entity
+		                && entry.entity->pos == entry.currentPos
+		                && entry.entity->obj && entry.entity->obj->pbox
+		                && size_t(entry.entity->obj->pbox->nb_physvert) == entry.currentVerts.size();
+		if(!entry.applied) {
+			continue;
+		}
+		
+		// Blending the box vertices also blends the rotation derived from them
+		entry.entity->pos = entry.previousPos + (entry.currentPos - entry.previousPos) * alpha;
+		PHYSVERT * vert = entry.entity->obj->pbox->vert;
+		for(size_t j = 0; j < entry.currentVerts.size(); j++) {
+			vert[j].pos = entry.previousVerts[j] + (entry.currentVerts[j] - entry.previousVerts[j]) * alpha;
+		}
+	}
+}
+
+void ArxGame::restoreSimulatedState() {
+	
+	for(size_t i = 0; i < m_interpolated.size(); i++) {
+		
+		InterpolatedEntity & entry = m_interpolated[i];
+		if(!entry.applied) {
+			continue;
+		}
+		
+		entry.entity->pos = entry.currentPos;
+		PHYSVERT * vert = entry.entity->obj->pbox->vert;
+		for(size_t j = 0; j < entry.currentVerts.size(); j++) {
+			vert[j].pos = entry.currentVerts[j];
+		}
+		entry.applied = false;
+	}
 }
 
 void ArxGame::updateInput() {
@@ -1313,6 +1518,7 @@ extern int iHighLight;
 extern void Cedric_ApplyLightingFirstPartRefactor(Entity *io, Color3f &special_color, long &special_color_flag);
 
 void ArxGame::renderLevel() {
+	ARX_PROFILE_FUNC();
 
 	if(!PLAYER_PARALYSED) {
 		manageEditorControls();
@@ -1425,7 +1631,7 @@ void ArxGame::renderLevel() {
 	}
 
 	PrepareIOTreatZone();
-	ARX_PHYSICS_Apply();
+	updatePhysics();
 
 	PrecalcIOLighting(&ACTIVECAM->orgTrans.pos, ACTIVECAM->cdepth * 0.6f);
 
@@ -1487,7 +1693,10 @@ void ArxGame::renderLevel() {
 		GRenderer->GetTextureStage(0)->SetMipMapLODBias(10.f);
 
 	ARX_SCENE_Update();
+	// Draw physics-driven entities between their state after the last two ticks
+	applyInterpolatedState();
 	ARX_SCENE_Render();
+	restoreSimulatedState();
 
 	if(uw_mode)
 		GRenderer->GetTextureStage(0)->SetMipMapLODBias(-0.3f);
@@ -1700,6 +1909,7 @@ void ArxGame::renderLevel() {
 }
 
 void ArxGame::update() {
+	ARX_PROFILE_FUNC();
 	
 	if(!WILL_LAUNCH_CINE.empty()) {
 		// A cinematic is waiting to be played...
@@ -1708,6 +1918,7 @@ void ArxGame::update() {
 }
 
 void ArxGame::render() {
+	ARX_PROFILE_FUNC();
 	
 	ACTIVECAM = &subj;
 
@@ -1724,6 +1935,7 @@ void ArxGame::render() {
 
 	PULSATE = EEsin(arxtime.get_frame_time() / 800);
 	EERIEDrawnPolys = 0;
+	RenderBatcher::resetFrameStats();
 
 	// EditMode Specific code
 	if(EDITMODE) {
@@ -1813,6 +2025,12 @@ void ArxGame::render() {
 			ShowTestText();
 			break;
 		}
+#ifdef BUILD_PROFILER
+		case InfoPanelProfiler: {
+			ShowProfilerInfo();
+			break;
+		}
+#endif
 		default: break;
 		}
 		GRenderer->EndScene();
@@ -2006,6 +2224,8 @@ bool ArxGame::initDeviceObjects() {
 
 bool ArxGame::finalCleanup() {
 	
+	texturestream::shutdown();
+	
 	EERIE_PATHFINDER_Release();
 	ARX_INPUT_Release();
 	ARX_SOUND_Release();
@@ -45,11 +45,15 @@ ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
 #define ARX_CORE_ARXGAME_H
 
 #include <string>
+#include <vector>
 
 #include "core/Application.h"
+#include "core/FixedTimestep.h"
+#include "math/Vector3.h"
 #include "window/Window.h"
 #include "window/RenderWindow.h"
 
+class Entity;
 class Font;
 
 class ArxGame : public Application, public Window::Listener, public RenderWindow::RendererListener {
@@ -117,6 +121,11 @@ private:
 	void renderMenu();
 	void renderCinematic();
 	void renderLevel();
+	
+	void updatePhysics();
+	//! Move physics-driven entities between their last two simulated states for rendering.
+	void applyInterpolatedState();
+	void restoreSimulatedState();
 
 	
 	virtual void onWindowGotFocus(const Window & window);
@@ -128,6 +137,22 @@ private:
 	
 	bool wasResized;
 	
+	FixedTimestep m_simulation;
+	unsigned m_simulationTicks;
+	
+	//! A physics-driven entity and its state after the last two simulation ticks.
+	struct InterpolatedEntity {
+		Entity * entity;
+		long index;
+		Vec3f previousPos;
+		Vec3f currentPos;
+		std::vector<Vec3f> previousVerts;
+		std::vector<Vec3f> currentVerts;
+		bool applied;
+	};
+	
+	std::vector<InterpolatedEntity> m_interpolated;
+	
 	void onRendererInit(RenderWindow &);
 	void onRendererShutdown(RenderWindow &);
 	
@@ -52,6 +52,7 @@ const string
 	resolution = "auto",
 	audioBackend = "auto",
 	windowFramework = "auto",
+	nullRendererLog = string(),
 	windowSize = BOOST_PP_STRINGIZE(ARX_DEFAULT_WIDTH) "x"
 	             BOOST_PP_STRINGIZE(ARX_DEFAULT_HEIGHT),
 	inputBackend = "auto",
@@ -160,7 +161,8 @@ const string
 // Window options
 const string
 	windowSize = "size",
-	windowFramework = "framework";
+	windowFramework = "framework",
+	nullRendererLog = "null_renderer_log";
 
 // Audio options
 const string
@@ -358,6 +360,11 @@ bool Config::save() {
 		return false;
 	}
 	
+	return save(out);
+}
+
+bool Config::save(std::ostream & out) const {
+	
 	ConfigWriter writer(out);
 	
 	// language
@@ -387,6 +394,10 @@ bool Config::save() {
 	oss << window.size.x << 'x' << window.size.y;
 	writer.writeKey(Key::windowSize, oss.str());
 	writer.writeKey(Key::windowFramework, window.framework);
+	if(!window.nullRendererLog.empty()) {
+		// Debugging option - don't clutter the config of normal users
+		writer.writeKey(Key::nullRendererLog, window.nullRendererLog);
+	}
 	
 	// audio
 	writer.beginSection(Section::Audio);
@@ -446,9 +457,16 @@ bool Config::init(const fs::path & file) {
 	ifs.open(file);
 	bool loaded = ifs.is_open();
 	
+	init(ifs);
+	
+	return loaded;
+}
+
+void Config::init(std::istream & is) {
+	
 	ConfigReader reader;
 	
-	if(!reader.read(ifs)) {
+	if(!reader.read(is)) {
 		LogWarning << "Errors while parsing config file";
 	}
 	
@@ -474,6 +492,7 @@ bool Config::init(const fs::path & file) {
 	string windowSize = reader.getKey(Section::Window, Key::windowSize, Default::windowSize);
 	window.size = parseResolution(windowSize);
 	window.framework = reader.getKey(Section::Window, Key::windowFramework, Default::windowFramework);
+	window.nullRendererLog = reader.getKey(Section::Window, Key::nullRendererLog, Default::nullRendererLog);
 	
 	// Get audio settings
 	audio.volume = reader.getKey(Section::Audio, Key::volume, Default::volume);
@@ -503,5 +522,4 @@ bool Config::init(const fs::path & file) {
 	misc.quicksaveSlots = std::max(reader.getKey(Section::Misc, Key::quicksaveSlots, Default::quicksaveSlots), 1);
 	misc.debug = reader.getKey(Section::Misc, Key::debugLevels, Default::debugLevels);
 	
-	return loaded;
 }
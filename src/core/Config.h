@@ -20,6 +20,7 @@
 #ifndef ARX_CORE_CONFIG_H
 #define ARX_CORE_CONFIG_H
 
+#include <iosfwd>
 #include <string>
 
 #include "input/InputKey.h"
@@ -126,6 +127,9 @@ public:
 		
 		std::string framework;
 		
+		//! File to write the null renderer's command log to (empty to disable)
+		std::string nullRendererLog;
+		
 	} window;
 	
 	// section 'audio'
@@ -188,8 +192,14 @@ public:
 	 */
 	bool save();
 	
+	//! Writes all config entries to a stream.
+	bool save(std::ostream & out) const;
+	
 	bool init(const fs::path & file);
 	
+	//! Reads config entries from a stream - missing entries get their default values.
+	void init(std::istream & is);
+	
 	void setOutputFile(const fs::path & _file);
 	
 private:
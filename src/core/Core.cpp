@@ -95,6 +95,7 @@ ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
 #include "graphics/GraphicsModes.h"
 #include "graphics/GraphicsTypes.h"
 #include "graphics/Math.h"
+#include "graphics/RenderBatcher.h"
 #include "graphics/Renderer.h"
 #include "graphics/Vertex.h"
 #include "graphics/data/FTL.h"
@@ -104,6 +105,7 @@ ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
 #include "graphics/particle/ParticleEffects.h"
 #include "graphics/particle/ParticleManager.h"
 #include "graphics/texture/TextureStage.h"
+#include "graphics/texture/TextureStream.h"
 
 #include "gui/Interface.h"
 #include "gui/Text.h"
@@ -1729,6 +1731,9 @@ void FirstFrameHandling() {
 	PROGRESS_BAR_COUNT+=1.f;
 	LoadLevelScreen();
 
+	// Don't show placeholders for the level textures
+	texturestream::finish();
+
 	FirstFrame=false;
 	PrepareIOTreatZone(1);
 	CURRENTLEVEL=GetLevelNumByName(LastLoadedScene.string());
@@ -3151,6 +3156,29 @@ void ShowInfoText() {
 
 	sprintf(tex,"Velocity %3.0f %3.0f %3.0f Slope %3.3f",player.physics.velocity.x,player.physics.velocity.y,player.physics.velocity.z,slope);
 	mainApp->outputText( 70, 128, tex );
+	
+	const RenderBatcher::Stats & batchStats = RenderBatcher::getFrameStats();
+	sprintf(tex, "Batched draws %lu -> %lu, state changes %lu (%lu saved)",
+	        (unsigned long)batchStats.draws, (unsigned long)batchStats.batches,
+	        (unsigned long)batchStats.stateChanges, (unsigned long)batchStats.stateChangesSaved);
+	mainApp->outputText(70, 144, tex);
+	
+	TextureContainer::LookupStats textureStats = TextureContainer::getLookupStats();
+	sprintf(tex, "Textures %lu, lookups %lu (%lu hits)",
+	        (unsigned long)textureStats.textures, (unsigned long)textureStats.lookups,
+	        (unsigned long)textureStats.hits);
+	mainApp->outputText(70, 160, tex);
+	
+	sprintf(tex, "Script events %lu (max %lu)",
+	        (unsigned long)ARX_SCRIPT_EventStackSize(),
+	        (unsigned long)ARX_SCRIPT_EventStackHighWaterMark());
+	mainApp->outputText(70, 176, tex);
+	
+	const AnimationLODStats & lodStats = ARX_INTERACTIVE_GetAnimationLODStats();
+	sprintf(tex, "Animation LOD full %lu, reduced %lu, low %lu, reused poses %lu",
+	        (unsigned long)lodStats.full, (unsigned long)lodStats.reduced,
+	        (unsigned long)lodStats.low, (unsigned long)lodStats.skippedPoses);
+	mainApp->outputText(70, 192, tex);
 
 	sprintf(tex, "nblights %ld - nb %ld", TSU_TEST_NB_LIGHT, TSU_TEST_NB);
 	mainApp->outputText( 100, 208, tex );
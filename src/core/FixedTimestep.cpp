@@ -0,0 +1,51 @@
+/*
+ * Copyright 2013 Arx Libertatis Team (see the AUTHORS file)
+ *
+ * This file is part of Arx Libertatis.
+ *
+ * Arx Libertatis is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Arx Libertatis is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Arx Libertatis.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "core/FixedTimestep.h"
+
+#include "platform/Platform.h"
+
+FixedTimestep::FixedTimestep(float _tickMs, unsigned _maxTicks)
+	: tickMs(_tickMs), maxTicks(_maxTicks), accumulator(0.f), droppedTicks(0) {
+	arx_assert(tickMs > 0.f);
+	arx_assert(maxTicks > 0);
+}
+
+unsigned FixedTimestep::advance(float frameMs) {
+	
+	if(frameMs > 0.f) {
+		accumulator += frameMs;
+	}
+	
+	unsigned ticks = 0;
+	while(accumulator >= tickMs) {
+		accumulator -= tickMs;
+		if(ticks == maxTicks) {
+			droppedTicks++;
+		} else {
+			ticks++;
+		}
+	}
+	
+	return ticks;
+}
+
+void FixedTimestep::reset() {
+	accumulator = 0.f;
+}
@@ -0,0 +1,63 @@
+/*
+ * Copyright 2013 Arx Libertatis Team (see the AUTHORS file)
+ *
+ * This file is part of Arx Libertatis.
+ *
+ * Arx Libertatis is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Arx Libertatis is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Arx Libertatis.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ARX_CORE_FIXEDTIMESTEP_H
+#define ARX_CORE_FIXEDTIMESTEP_H
+
+/*!
+ * Splits variable frame times into fixed-length simulation ticks.
+ * 
+ * Time that does not fill a whole tick is carried over to the next frame and is
+ * available as an interpolation factor for rendering. At most maxTicks ticks are
+ * run per frame - any time beyond that is dropped so that one slow frame does not
+ * make the following frames even slower.
+ */
+class FixedTimestep {
+	
+public:
+	
+	explicit FixedTimestep(float _tickMs = 1000.f / 60.f, unsigned _maxTicks = 5);
+	
+	/*!
+	 * Add the time elapsed in this frame.
+	 * @return the number of ticks to simulate for this frame.
+	 */
+	unsigned advance(float frameMs);
+	
+	//! Forget carried over time, e.g. after loading a level.
+	void reset();
+	
+	float getTickMs() const { return tickMs; }
+	
+	//! Fraction of a tick carried over to the next frame, in [0, 1).
+	float getAlpha() const { return accumulator / tickMs; }
+	
+	//! Total number of ticks dropped by the catch-up limit.
+	unsigned getDroppedTicks() const { return droppedTicks; }
+	
+private:
+	
+	float tickMs;
+	unsigned maxTicks;
+	float accumulator;
+	unsigned droppedTicks;
+	
+};
+
+#endif // ARX_CORE_FIXEDTIMESTEP_H
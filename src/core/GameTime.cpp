@@ -61,11 +61,13 @@ arx::time::time() {
 	frame_time_us      = 0;
 	last_frame_time_us = 0;
 	frame_delay_ms     = 0.0f;
+	clock_latched      = false;
+	latched_time_us    = 0;
 }
 
 void arx::time::init() {
 	
-	start_time         = Time::getUs();
+	start_time         = now();
 	pause_time         = 0;
 	paused             = false;
 	delta_time_us      = 0;
@@ -76,14 +78,14 @@ void arx::time::init() {
 
 void arx::time::pause() {
 	if(!is_paused()) {
-		pause_time = Time::getUs();
+		pause_time = now();
 		paused     = true;
 	}
 }
 
 void arx::time::resume() {
 	if(is_paused()) {
-		start_time += Time::getElapsedUs(pause_time);
+		start_time += Time::getElapsedUs(pause_time, now());
 		pause_time = 0;
 		paused     = false;
 	}
@@ -93,7 +95,7 @@ void arx::time::force_time_restore(const float &time) {
 	
 	u64 requested_time = u64(time * 1000.0f);
 	
-	start_time = Time::getElapsedUs(requested_time);
+	start_time = Time::getElapsedUs(requested_time, now());
 	delta_time_us = requested_time;
 	
 	pause_time = 0;
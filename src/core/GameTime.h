@@ -99,7 +99,7 @@ namespace arx
 			if (is_paused() && use_pause) {
 				delta_time_us = Time::getElapsedUs(start_time, pause_time);
 			} else {
-				delta_time_us = Time::getElapsedUs(start_time);
+				delta_time_us = Time::getElapsedUs(start_time, now());
 			}
 		}
 
@@ -146,9 +146,31 @@ namespace arx
 			last_frame_time_us = frame_time_us;
 		}
 
+		/*!
+		 * Make all following time queries see the given clock value instead of the
+		 * system clock, until the clock is latched again or released.
+		 * Used to make recorded and replayed games advance by identical steps.
+		 */
+		inline void latch_clock(u64 time_us) {
+			clock_latched = true;
+			latched_time_us = time_us;
+		}
+
+		inline void release_clock() {
+			clock_latched = false;
+		}
+
 	private:
+
+		inline u64 now() const {
+			return clock_latched ? latched_time_us : Time::getUs();
+		}
+
 		bool paused;
 
+		bool clock_latched;
+		u64 latched_time_us;
+
 		// these values are expected to wrap
 		u64 pause_time;
 		u64 start_time;
@@ -31,6 +31,7 @@
 #include "io/resource/ResourcePath.h"
 #include "io/resource/PakReader.h"
 #include "io/IniReader.h"
+#include "io/IniTable.h"
 #include "io/log/Logger.h"
 
 #include "platform/Platform.h"
@@ -40,7 +41,7 @@
 using std::string;
 
 namespace {
-IniReader localisation;
+IniTable localisation;
 }
 
 static PakFile * autodetectLanguage() {
@@ -155,10 +156,12 @@ bool initLocalisation() {
 	if(!out.empty()) {
 		LogDebug("Preparing to parse localisation file");
 		std::istringstream iss(out);
-		if(!::localisation.read(iss)) {
+		IniReader reader;
+		if(!reader.read(iss)) {
 			LogWarning << "Error parsing localisation file localisation/utext_"
 			           << config.language << ".ini";
 		}
+		::localisation.build(reader);
 	}
 	
 	free(data);
@@ -170,9 +173,18 @@ long getLocalisedKeyCount(const string & sectionname) {
 	return localisation.getKeyCount(sectionname);
 }
 
+const string & getLocalised(const string & name) {
+	
+	arx_assert(name.find_first_of("ABCDEFGHIJKLMNOPQRSTUVWXYZ[]") == string::npos);
+	
+	static const string empty;
+	
+	return localisation.get(name, string(), empty);
+}
+
 string getLocalised(const string & name, const string & default_value) {
 	
 	arx_assert(name.find_first_of("ABCDEFGHIJKLMNOPQRSTUVWXYZ[]") == string::npos);
 	
-	return localisation.getKey(name, string(), default_value);
+	return localisation.get(name, string(), default_value);
 }
@@ -30,9 +30,19 @@ bool initLocalisation();
 /*!
  * Returns the localized string for the given key name
  * @param name The string to be looked up
- * @return The localized string based on the currently loaded locale file
+ * @return The localized string based on the currently loaded locale file,
+ *         or an empty string if there is none.
+ *         The reference stays valid until the localisation is reloaded.
  */
-std::string getLocalised( const std::string& name, const std::string& default_value = "" );
+const std::string & getLocalised(const std::string & name);
+
+/*!
+ * Returns the localized string for the given key name
+ * @param name The string to be looked up
+ * @param default_value The value to return if there is no localized string.
+ * @return The localized string or a copy of default_value.
+ */
+std::string getLocalised(const std::string & name, const std::string & default_value);
 
 long getLocalisedKeyCount(const std::string & sectionname);
 
@@ -0,0 +1,625 @@
+/*
+ * Copyright 2013 Arx Libertatis Team (see the AUTHORS file)
+ *
+ * This file is part of Arx Libertatis.
+ *
+ * Arx Libertatis is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Arx Libertatis is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Arx Libertatis.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "core/Replay.h"
+
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "core/Config.h"
+#include "core/GameTime.h"
+#include "input/InputBackend.h"
+#include "input/Keyboard.h"
+#include "input/Mouse.h"
+#include "io/fs/FilePath.h"
+#include "io/fs/FileStream.h"
+#include "io/fs/Filesystem.h"
+#include "io/log/Logger.h"
+#include "math/Random.h"
+#include "platform/Platform.h"
+#include "platform/ProgramOptions.h"
+#include "platform/Time.h"
+
+namespace replay {
+
+namespace {
+
+const char MAGIC[4] = { 'A', 'R', 'X', 'R' };
+const u64 VERSION = 1;
+
+//! Resolution and range of the frame time histogram
+const u64 BUCKET_US = 100;
+const size_t BUCKET_COUNT = 1000;
+
+//! Complete input backend state for one update.
+struct InputState {
+	
+	struct Button {
+		bool pressed;
+		int deltaTime;
+		int clicks;
+		int unclicks;
+	};
+	
+	bool keys[Keyboard::KeyCount];
+	char text[Keyboard::KeyCount];
+	Button buttons[Mouse::ButtonCount];
+	bool mouseInWindow;
+	int absX, absY;
+	int relX, relY;
+	int wheel;
+	
+	void reset() {
+		std::memset(this, 0, sizeof(*this));
+	}
+	
+};
+
+void writeVarint(std::string & out, u64 value) {
+	while(value >= 0x80) {
+		out += char(u8(value) | 0x80);
+		value >>= 7;
+	}
+	out += char(u8(value));
+}
+
+void writeSigned(std::string & out, s64 value) {
+	// Zigzag encoding keeps small negative values small
+	writeVarint(out, (u64(value) << 1) ^ u64(value >> 63));
+}
+
+class Reader {
+	
+	const std::string & m_data;
+	size_t m_pos;
+	bool m_ok;
+	
+public:
+	
+	Reader(const std::string & data, size_t pos) : m_data(data), m_pos(pos), m_ok(true) { }
+	
+	bool ok() const { return m_ok; }
+	bool atEnd() const { return m_pos >= m_data.size(); }
+	size_t position() const { return m_pos; }
+	
+	u8 byte() {
+		if(atEnd()) {
+			m_ok = false;
+			return 0;
+		}
+		return u8(m_data[m_pos++]);
+	}
+	
+	u64 varint() {
+		u64 value = 0;
+		for(unsigned shift = 0; shift < 64; shift += 7) {
+			u8 b = byte();
+			value |= u64(b & 0x7f) << shift;
+			if(!(b & 0x80)) {
+				return value;
+			}
+		}
+		m_ok = false;
+		return value;
+	}
+	
+	s64 signedVarint() {
+		u64 value = varint();
+		return s64(value >> 1) ^ -s64(value & 1);
+	}
+	
+	std::string bytes(size_t count) {
+		if(count > m_data.size() - m_pos) {
+			m_ok = false;
+			return std::string();
+		}
+		m_pos += count;
+		return m_data.substr(m_pos - count, count);
+	}
+	
+};
+
+bool operator!=(const InputState::Button & a, const InputState::Button & b) {
+	return a.pressed != b.pressed || a.deltaTime != b.deltaTime
+	       || a.clicks != b.clicks || a.unclicks != b.unclicks;
+}
+
+//! Write the changes from prev to cur.
+void encodeInput(std::string & out, const InputState & prev, const InputState & cur) {
+	
+	size_t changedKeys = 0;
+	for(size_t i = 0; i < size_t(Keyboard::KeyCount); i++) {
+		if(cur.keys[i] != prev.keys[i] || cur.text[i] != prev.text[i]) {
+			changedKeys++;
+		}
+	}
+	writeVarint(out, changedKeys);
+	for(size_t i = 0; i < size_t(Keyboard::KeyCount); i++) {
+		if(cur.keys[i] != prev.keys[i] || cur.text[i] != prev.text[i]) {
+			writeVarint(out, i);
+			out += char(cur.keys[i]);
+			out += cur.text[i];
+		}
+	}
+	
+	u32 changedButtons = 0;
+	for(size_t i = 0; i < size_t(Mouse::ButtonCount); i++) {
+		if(cur.buttons[i] != prev.buttons[i]) {
+			changedButtons |= u32(1) << i;
+		}
+	}
+	writeVarint(out, changedButtons);
+	for(size_t i = 0; i < size_t(Mouse::ButtonCount); i++) {
+		if(changedButtons & (u32(1) << i)) {
+			out += char(cur.buttons[i].pressed);
+			writeSigned(out, cur.buttons[i].deltaTime);
+			writeSigned(out, cur.buttons[i].clicks);
+			writeSigned(out, cur.buttons[i].unclicks);
+		}
+	}
+	
+	out += char(cur.mouseInWindow);
+	writeSigned(out, s64(cur.absX) - prev.absX);
+	writeSigned(out, s64(cur.absY) - prev.absY);
+	writeSigned(out, cur.relX);
+	writeSigned(out, cur.relY);
+	writeSigned(out, cur.wheel);
+}
+
+//! Apply changes written by encodeInput() to state.
+void decodeInput(Reader & in, InputState & state) {
+	
+	u64 changedKeys = in.varint();
+	for(u64 i = 0; i < changedKeys && in.ok(); i++) {
+		u64 key = in.varint();
+		bool pressed = (in.byte() != 0);
+		char text = char(in.byte());
+		if(key < u64(Keyboard::KeyCount)) {
+			state.keys[key] = pressed;
+			state.text[key] = text;
+		}
+	}
+	
+	u64 changedButtons = in.varint();
+	for(size_t i = 0; i < size_t(Mouse::ButtonCount); i++) {
+		if(changedButtons & (u64(1) << i)) {
+			state.buttons[i].pressed = (in.byte() != 0);
+			state.buttons[i].deltaTime = int(in.signedVarint());
+			state.buttons[i].clicks = int(in.signedVarint());
+			state.buttons[i].unclicks = int(in.signedVarint());
+		}
+	}
+	
+	state.mouseInWindow = (in.byte() != 0);
+	state.absX += int(in.signedVarint());
+	state.absY += int(in.signedVarint());
+	state.relX = int(in.signedVarint());
+	state.relY = int(in.signedVarint());
+	state.wheel = int(in.signedVarint());
+}
+
+void captureInput(InputBackend & backend, InputState & state) {
+	
+	for(int i = 0; i < Keyboard::KeyCount; i++) {
+		state.keys[i] = backend.isKeyboardKeyPressed(Keyboard::KeyBase + i);
+		char text = '\0';
+		if(!state.keys[i] || !backend.getKeyAsText(Keyboard::KeyBase + i, text)) {
+			text = '\0';
+		}
+		state.text[i] = text;
+	}
+	
+	for(int i = 0; i < Mouse::ButtonCount; i++) {
+		InputState::Button & button = state.buttons[i];
+		button.pressed = backend.isMouseButtonPressed(Mouse::ButtonBase + i, button.deltaTime);
+		backend.getMouseButtonClickCount(Mouse::ButtonBase + i, button.clicks, button.unclicks);
+	}
+	
+	state.mouseInWindow = backend.getAbsoluteMouseCoords(state.absX, state.absY);
+	backend.getRelativeMouseCoords(state.relX, state.relY, state.wheel);
+}
+
+std::string g_recordFile;
+std::string g_replayFile;
+
+Mode g_mode = Disabled;
+fs::path g_file;
+
+// Recording
+fs::ofstream g_output;
+u64 g_clockStart = 0;
+u64 g_frameClock = 0;
+size_t g_inputUpdates = 0;
+std::string g_frameInput;
+
+// Playback
+std::string g_data;
+size_t g_offset = 0;
+std::deque<InputState> g_pendingInput;
+bool g_desyncReported = false;
+
+//! Last recorded or replayed input state, used as the base for the next delta
+InputState g_lastInput;
+u64 g_lastClock = 0;
+
+// Frame time statistics
+u64 g_frameStart = 0;
+std::vector<u32> g_histogram;
+u64 g_frames = 0;
+u64 g_totalUs = 0;
+u64 g_maxUs = 0;
+
+//! Serves all queries from a snapshot taken once per update, so that recording
+//! and playback see exactly the same values.
+class ReplayInputBackend : public InputBackend {
+	
+	InputBackend * m_backend;
+	InputState m_state;
+	
+public:
+	
+	explicit ReplayInputBackend(InputBackend * backend) : m_backend(backend) {
+		m_state.reset();
+	}
+	
+	~ReplayInputBackend() {
+		delete m_backend;
+	}
+	
+	bool init() { return m_backend->init(); }
+	void acquireDevices() { m_backend->acquireDevices(); }
+	void unacquireDevices() { m_backend->unacquireDevices(); }
+	
+	bool update() {
+		
+		bool result = m_backend->update();
+		
+		if(g_mode == Recording) {
+			captureInput(*m_backend, m_state);
+			encodeInput(g_frameInput, g_lastInput, m_state);
+			g_lastInput = m_state;
+			g_inputUpdates++;
+		} else if(!g_pendingInput.empty()) {
+			m_state = g_pendingInput.front();
+			g_pendingInput.pop_front();
+		} else if(!g_desyncReported) {
+			LogWarning << "Replay out of sync: more input updates than recorded";
+			g_desyncReported = true;
+		}
+		
+		return result;
+	}
+	
+	bool getAbsoluteMouseCoords(int & absX, int & absY) const {
+		absX = m_state.absX, absY = m_state.absY;
+		return m_state.mouseInWindow;
+	}
+	
+	void setAbsoluteMouseCoords(int absX, int absY) {
+		// The new position is seen after the next update when recording, and is
+		// already part of the recorded state when playing back.
+		if(g_mode == Recording) {
+			m_backend->setAbsoluteMouseCoords(absX, absY);
+		}
+	}
+	
+	void getRelativeMouseCoords(int & relX, int & relY, int & wheelDir) const {
+		relX = m_state.relX, relY = m_state.relY, wheelDir = m_state.wheel;
+	}
+	
+	bool isMouseButtonPressed(int buttonId, int & deltaTime) const {
+		const InputState::Button & button = m_state.buttons[buttonId - Mouse::ButtonBase];
+		deltaTime = button.deltaTime;
+		return button.pressed;
+	}
+	
+	void getMouseButtonClickCount(int buttonId, int & numClick, int & numUnClick) const {
+		const InputState::Button & button = m_state.buttons[buttonId - Mouse::ButtonBase];
+		numClick = button.clicks, numUnClick = button.unclicks;
+	}
+	
+	bool isKeyboardKeyPressed(int keyId) const {
+		return m_state.keys[keyId - Keyboard::KeyBase];
+	}
+	
+	bool getKeyAsText(int keyId, char & result) const {
+		result = m_state.text[keyId - Keyboard::KeyBase];
+		return result != '\0';
+	}
+	
+};
+
+bool startRecording(const fs::path & file) {
+	
+	g_output.open(file, fs::fstream::out | fs::fstream::binary | fs::fstream::trunc);
+	if(!g_output.is_open()) {
+		LogError << "Could not create replay file " << file;
+		return false;
+	}
+	
+	u32 seed = Random::get<u32>();
+	
+	std::ostringstream oss;
+	config.save(oss);
+	std::string cfg = oss.str();
+	
+	std::string header(MAGIC, sizeof(MAGIC));
+	writeVarint(header, VERSION);
+	writeVarint(header, seed);
+	writeVarint(header, cfg.size());
+	header += cfg;
+	if(!fs::write(g_output, header.data(), header.size())) {
+		LogError << "Could not write replay file " << file;
+		return false;
+	}
+	
+	Random::seed(seed);
+	
+	g_clockStart = Time::getUs();
+	
+	LogInfo << "Recording replay to " << file;
+	
+	return true;
+}
+
+bool startPlayback(const fs::path & file) {
+	
+	g_data = fs::read(file);
+	
+	Reader in(g_data, 0);
+	if(in.bytes(sizeof(MAGIC)) != std::string(MAGIC, sizeof(MAGIC))) {
+		LogError << file << " is not a replay file";
+		return false;
+	}
+	
+	u64 version = in.varint();
+	if(version != VERSION) {
+		LogError << "Unsupported replay version " << version << " in " << file;
+		return false;
+	}
+	
+	u32 seed = u32(in.varint());
+	std::string cfg = in.bytes(size_t(in.varint()));
+	if(!in.ok()) {
+		LogError << "Truncated replay file " << file;
+		return false;
+	}
+	
+	std::istringstream iss(cfg);
+	config.init(iss);
+	
+	// Play back headless at full speed and never overwrite the user's config
+	config.window.framework = "null";
+	config.input.backend = "null";
+	config.setOutputFile(fs::path());
+	
+	Random::seed(seed);
+	
+	g_offset = in.position();
+	
+	LogInfo << "Playing back replay " << file;
+	
+	return true;
+}
+
+void addFrameTime(u64 us) {
+	
+	g_histogram[std::min(size_t(us / BUCKET_US), BUCKET_COUNT)]++;
+	
+	g_frames++;
+	g_totalUs += us;
+	g_maxUs = std::max(g_maxUs, us);
+}
+
+//! Upper edge of the histogram bucket containing the given fraction of frames, in ms.
+float getPercentile(float fraction) {
+	
+	u64 target = u64(fraction * g_frames);
+	u64 count = 0;
+	for(size_t i = 0; i < g_histogram.size(); i++) {
+		count += g_histogram[i];
+		if(count > target) {
+			return float((i + 1) * BUCKET_US) / 1000.f;
+		}
+	}
+	
+	return float(g_maxUs) / 1000.f;
+}
+
+void writeHistogram(const fs::path & file) {
+	
+	if(!g_frames) {
+		return;
+	}
+	
+	float mean = float(g_totalUs) / float(g_frames) / 1000.f;
+	
+	std::ostringstream summary;
+	summary << std::fixed << std::setprecision(2)
+	        << g_frames << " frames, mean " << mean << " ms, p50 " << getPercentile(0.5f)
+	        << " ms, p90 " << getPercentile(0.9f) << " ms, p99 " << getPercentile(0.99f)
+	        << " ms, max " << (float(g_maxUs) / 1000.f) << " ms";
+	LogInfo << "Frame times: " << summary.str();
+	
+	fs::ofstream ofs(file, fs::fstream::out | fs::fstream::trunc);
+	if(!ofs.is_open()) {
+		LogWarning << "Could not write frame times to " << file;
+		return;
+	}
+	
+	ofs << "# " << summary.str() << '\n';
+	ofs << "# frame time (ms), frames\n";
+	ofs << std::fixed << std::setprecision(1);
+	for(size_t i = 0; i < g_histogram.size(); i++) {
+		if(g_histogram[i]) {
+			ofs << (i == BUCKET_COUNT ? ">=" : "") << float(i * BUCKET_US) / 1000.f
+			    << ", " << g_histogram[i] << '\n';
+		}
+	}
+}
+
+void setRecordFile(const std::string & file) {
+	g_recordFile = file;
+}
+
+void setReplayFile(const std::string & file) {
+	g_replayFile = file;
+}
+
+} // anonymous namespace
+
+Mode getMode() {
+	return g_mode;
+}
+
+bool init() {
+	
+	if(g_recordFile.empty() && g_replayFile.empty()) {
+		return true;
+	}
+	
+	if(!g_recordFile.empty() && !g_replayFile.empty()) {
+		LogError << "Cannot record and play back a replay at the same time";
+		return false;
+	}
+	
+	g_lastInput.reset();
+	
+	if(!g_recordFile.empty()) {
+		g_file = fs::path(g_recordFile);
+		if(!startRecording(g_file)) {
+			return false;
+		}
+		g_mode = Recording;
+	} else {
+		g_file = fs::path(g_replayFile);
+		if(!startPlayback(g_file)) {
+			return false;
+		}
+		g_mode = Playback;
+	}
+	
+	g_histogram.assign(BUCKET_COUNT + 1, 0);
+	
+	// Nothing may advance the game clock between frames.
+	arxtime.latch_clock(0);
+	
+	return true;
+}
+
+InputBackend * wrapInputBackend(InputBackend * backend) {
+	
+	if(g_mode == Disabled || !backend) {
+		return backend;
+	}
+	
+	return new ReplayInputBackend(backend);
+}
+
+bool beginFrame() {
+	
+	if(g_mode == Disabled) {
+		return true;
+	}
+	
+	g_frameStart = Time::getUs();
+	
+	if(g_mode == Recording) {
+		
+		g_frameClock = Time::getElapsedUs(g_clockStart, g_frameStart);
+		g_inputUpdates = 0;
+		g_frameInput.clear();
+		
+	} else {
+		
+		Reader in(g_data, g_offset);
+		if(in.atEnd()) {
+			return false;
+		}
+		
+		g_frameClock = g_lastClock + in.varint();
+		
+		g_pendingInput.clear();
+		u64 inputUpdates = in.varint();
+		for(u64 i = 0; i < inputUpdates && in.ok(); i++) {
+			decodeInput(in, g_lastInput);
+			g_pendingInput.push_back(g_lastInput);
+		}
+		
+		if(!in.ok()) {
+			LogError << "Truncated replay file " << g_file;
+			return false;
+		}
+		
+		g_offset = in.position();
+	}
+	
+	arxtime.latch_clock(g_frameClock);
+	
+	return true;
+}
+
+void endFrame() {
+	
+	if(g_mode == Disabled) {
+		return;
+	}
+	
+	addFrameTime(Time::getElapsedUs(g_frameStart));
+	
+	if(g_mode == Recording) {
+		std::string frame;
+		writeVarint(frame, g_frameClock - g_lastClock);
+		writeVarint(frame, g_inputUpdates);
+		frame += g_frameInput;
+		fs::write(g_output, frame.data(), frame.size());
+	}
+	
+	g_lastClock = g_frameClock;
+}
+
+void shutdown() {
+	
+	if(g_mode == Disabled) {
+		return;
+	}
+	
+	if(g_mode == Recording) {
+		g_output.close();
+	}
+	
+	writeHistogram(fs::path(g_file.string() + ".times"));
+	
+	arxtime.release_clock();
+	
+	g_data.clear();
+	g_mode = Disabled;
+}
+
+} // namespace replay
+
+ARX_PROGRAM_OPTION("record", "R", "Record input, timing and config to FILE for later playback",
+                   &replay::setRecordFile, "FILE");
+ARX_PROGRAM_OPTION("replay", "r", "Play back FILE headless at full speed and write frame times to FILE.times",
+                   &replay::setReplayFile, "FILE");
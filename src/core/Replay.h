@@ -0,0 +1,79 @@
+/*
+ * Copyright 2013 Arx Libertatis Team (see the AUTHORS file)
+ *
+ * This file is part of Arx Libertatis.
+ *
+ * Arx Libertatis is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Arx Libertatis is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Arx Libertatis.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ARX_CORE_REPLAY_H
+#define ARX_CORE_REPLAY_H
+
+class InputBackend;
+
+/*!
+ * Records everything that reaches the game loop from outside - input backend state,
+ * the game clock, the random seed and the config - and plays it back headlessly at
+ * full speed to get reproducible frame-time measurements.
+ * 
+ * Recording is enabled with --record FILE and playback with --replay FILE. A
+ * histogram of the frame times is written to FILE.times in both cases.
+ * 
+ * Replays start at program startup, so any savegames loaded during the recording
+ * must also be present when playing back.
+ * 
+ * The recorded seed makes the main thread's random numbers and all RandomStream
+ * sequences reproducible. Worker threads seed their generator from the same seed,
+ * but their streams are numbered in the order the threads first draw a value, so
+ * results from code using Random on more than one worker thread may still differ.
+ */
+namespace replay {
+
+enum Mode {
+	Disabled,
+	Recording,
+	Playback
+};
+
+Mode getMode();
+
+/*!
+ * Open the replay file requested on the command line.
+ * Must be called after the config has been loaded and before the window and input
+ * are initialized: playback replaces the config and seeds the random generator.
+ * @return false if the replay file could not be opened.
+ */
+bool init();
+
+/*!
+ * Wrap the input backend so that its state is recorded or replaced with the
+ * recorded state. Takes ownership of the backend.
+ */
+InputBackend * wrapInputBackend(InputBackend * backend);
+
+/*!
+ * Start a new frame: records or restores the game clock for this frame.
+ * @return false once all recorded frames have been played back.
+ */
+bool beginFrame();
+
+//! End the frame started by beginFrame() and write its input.
+void endFrame();
+
+//! Close the replay file and write the frame time histogram.
+void shutdown();
+
+} // namespace replay
+
+#endif // ARX_CORE_REPLAY_H
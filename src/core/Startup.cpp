@@ -55,12 +55,15 @@
 #include "io/fs/SystemPaths.h"
 #include "io/log/CriticalLogger.h"
 #include "io/log/FileLogger.h"
+#include "io/log/LogThread.h"
 #include "io/log/Logger.h"
 #include "math/Random.h"
 #include "platform/Compiler.h"
 #include "platform/CrashHandler.h"
 #include "platform/Environment.h"
 #include "platform/ProgramOptions.h"
+#include "platform/Profiler.h"
+#include "platform/ThreadPool.h"
 #include "platform/Time.h"
 #include "util/String.h"
 #include "util/cmdline/Parser.h"
@@ -167,12 +170,24 @@ INT WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, PSTR lpCmdLine,
 			CrashHandler::addAttachedFile(logFile);
 		}
 		
+		// Write log messages from a background thread from now on
+		logger::startWriterThread();
+		
 		Time::init();
+		profiler::registerThread("main");
+		
+		ThreadPool::init();
 		
 		// 14: Start the game already!
 		LogInfo << "Starting " << arx_version;
 		runGame();
 		
+		ThreadPool::shutdown();
+		
+		profiler::flush();
+		
+		logger::stopWriterThread();
+		
 	}
 	
 	// Shutdown the logging system
@@ -110,6 +110,7 @@ ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
 #include "physics/Collisions.h"
 
 #include "platform/Platform.h"
+#include "platform/Profiler.h"
 
 #include "scene/Light.h"
 #include "scene/Scene.h"
@@ -5352,6 +5353,7 @@ float ARX_SPELLS_ApplyColdProtection(Entity * io,float damages)
  */
 void ARX_SPELLS_Update()
 {
+	ARX_PROFILE_FUNC();
 	
 	unsigned long tim;
 	long framediff,framediff3;
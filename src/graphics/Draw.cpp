@@ -395,7 +395,7 @@ void EERIEDraw3DLine(const Vec3f & orgn, const Vec3f & dest, Color col) {
 //*************************************************************************************
 //*************************************************************************************
 
-void EERIEDrawSprite(TexturedVertex * in, float siz, TextureContainer * tex, Color color, float Zpos) {
+bool EERIEComputeSprite(TexturedVertex * in, float siz, Color color, float Zpos, TexturedVertex * v) {
 	
 	TexturedVertex out;
 	
@@ -431,23 +431,32 @@ void EERIEDrawSprite(TexturedVertex * in, float siz, TextureContainer * tex, Col
 		SPRmins.y=out.p.y-t;
 
 		ColorBGRA col = color.toBGRA();
-		TexturedVertex v[4];
 		v[0] = TexturedVertex(Vec3f(SPRmins.x, SPRmins.y, out.p.z), out.rhw, col, out.specular, Vec2f::ZERO);
 		v[1] = TexturedVertex(Vec3f(SPRmaxs.x, SPRmins.y, out.p.z), out.rhw, col, out.specular, Vec2f::X_AXIS);
 		v[2] = TexturedVertex(Vec3f(SPRmins.x, SPRmaxs.y, out.p.z), out.rhw, col, out.specular, Vec2f::Y_AXIS);
 		v[3] = TexturedVertex(Vec3f(SPRmaxs.x, SPRmaxs.y, out.p.z), out.rhw, col, out.specular, Vec2f(1.f, 1.f));
+		
+		return true;
+	}
+	
+	SPRmaxs.x=-1;
+	return false;
+}
 
+void EERIEDrawSprite(TexturedVertex * in, float siz, TextureContainer * tex, Color color, float Zpos) {
+	
+	TexturedVertex v[4];
+	if(EERIEComputeSprite(in, siz, color, Zpos, v)) {
 		GRenderer->SetTexture(0, tex);
 		EERIEDRAWPRIM(Renderer::TriangleStrip, v, 4);
 	}
-	else SPRmaxs.x=-1;
 }
 
 //*************************************************************************************
 //*************************************************************************************
 
-void EERIEDrawRotatedSprite(TexturedVertex * in, float siz, TextureContainer * tex, Color color,
-                            float Zpos, float rot) {
+bool EERIEComputeRotatedSprite(TexturedVertex * in, float siz, Color color, float Zpos, float rot,
+                               TexturedVertex * v) {
 	
 	TexturedVertex out;
 
@@ -470,7 +479,6 @@ void EERIEDrawRotatedSprite(TexturedVertex * in, float siz, TextureContainer * t
 		}
 
 		ColorBGRA col = color.toBGRA();
-		TexturedVertex v[4];
 		v[0] = TexturedVertex(Vec3f(0, 0, out.p.z), out.rhw, col, out.specular, Vec2f::ZERO);
 		v[1] = TexturedVertex(Vec3f(0, 0, out.p.z), out.rhw, col, out.specular, Vec2f::X_AXIS);
 		v[2] = TexturedVertex(Vec3f(0, 0, out.p.z), out.rhw, col, out.specular, Vec2f(1.f, 1.f));
@@ -490,11 +498,22 @@ void EERIEDrawRotatedSprite(TexturedVertex * in, float siz, TextureContainer * t
 			v[i].p.x = EEsin(tt) * t + out.p.x;
 			v[i].p.y = EEcos(tt) * t + out.p.y;
 		}
+		
+		return true;
+	}
+	
+	SPRmaxs.x=-1;
+	return false;
+}
 
+void EERIEDrawRotatedSprite(TexturedVertex * in, float siz, TextureContainer * tex, Color color,
+                            float Zpos, float rot) {
+	
+	TexturedVertex v[4];
+	if(EERIEComputeRotatedSprite(in, siz, color, Zpos, rot, v)) {
 		GRenderer->SetTexture(0, tex);
 		EERIEDRAWPRIM(Renderer::TriangleFan, v, 4);
 	}
-	else SPRmaxs.x=-1;
 }
 
 //*************************************************************************************
@@ -75,6 +75,21 @@ void EERIEDrawBitmap2DecalY(float x, float y, float sx, float sy, float z, Textu
 
 void EERIEOBJECT_Quadify(EERIE_3DOBJ * obj);
 
+/*!
+ * Project a screen-aligned sprite.
+ * @param v Receives the 4 vertices of the sprite as a triangle strip.
+ * @return false if the sprite is not visible.
+ */
+bool EERIEComputeSprite(TexturedVertex * in, float siz, Color col, float Zpos, TexturedVertex * v);
+
+/*!
+ * Project a rotated screen-aligned sprite.
+ * @param v Receives the 4 vertices of the sprite as a triangle fan.
+ * @return false if the sprite is not visible.
+ */
+bool EERIEComputeRotatedSprite(TexturedVertex * in, float siz, Color col, float Zpos, float rot,
+                               TexturedVertex * v);
+
 void EERIEDrawSprite(TexturedVertex * in, float siz, TextureContainer * tex, Color col, float Zpos);
 void EERIEDrawRotatedSprite(TexturedVertex * in, float siz, TextureContainer * tex, Color col, float Zpos, float rot);
 
@@ -62,6 +62,7 @@ ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
 #include "Configure.h"
 
 struct EERIE_3DOBJ;
+class AnimationTracks;
 class TextureContainer;
 class Entity;
 
@@ -178,6 +179,23 @@ struct EERIEPOLY {
 	unsigned short	uslInd[4];
 };
 
+/*!
+ * Compact copy of the EERIEPOLY fields needed for collision and ground height tests.
+ * Rebuilt by EERIEPOLY_Compute_PolyIn() whenever the background polygons change.
+ */
+struct CollisionPoly {
+	PolyType type;
+	float area;
+	Vec3f v[4];
+	Vec3f center;
+	Vec3f min;
+	Vec3f max;
+	Vec3f plane;    //!< Unnormalized plane normal as computed by GetTruePolyY()
+	float planed;   //!< Plane distance, such that dot(plane, p) = planed for points p on the plane
+	float normy;    //!< Y component of the polygon normal
+	EERIEPOLY * ep; //!< The full polygon
+};
+
 #define IOPOLYVERT 3
 struct EERIE_FACE {
 	
@@ -404,10 +422,6 @@ struct EERIE_C_DATA
 	long			nb_bones;
 };
 
-struct EERIE_3DPAD : public Vec3f {
-	float w;
-};
-
 struct EERIE_3DOBJ
 {
 	EERIE_3DOBJ()
@@ -558,7 +572,7 @@ struct EERIE_ANIM
 	long		nb_groups;
 	long		nb_key_frames;
 	EERIE_FRAME *	frames;
-	EERIE_GROUP  *  groups;
+	AnimationTracks * groups;
 	unsigned char *	voidgroups;
 };
 
@@ -581,6 +595,8 @@ struct EP_DATA {
 	short padd;
 };
 
+class RoomCullData;
+
 struct EERIE_ROOM_DATA {
 	long nb_portals;
 	long * portals;
@@ -590,6 +606,7 @@ struct EERIE_ROOM_DATA {
 	float radius;
 	unsigned short * pussIndice;
 	VertexBuffer<SMY_VERTEX> * pVertexBuffer;
+	RoomCullData * pCullData; //!< culling data for all polygons in epdata
 	unsigned long usNbTextures;
 	TextureContainer ** ppTextureContainer;
 };
@@ -59,10 +59,11 @@ using std::max;
 
 #include "graphics/GraphicsTypes.h"
 #include "graphics/data/Mesh.h"
+#include "math/Random.h"
 
 // RANDOM Sequences Funcs/Defs
 inline float rnd() {
-	return rand() * (1.0f / RAND_MAX);
+	return Random::getf();
 }
 
 /*!
@@ -0,0 +1,275 @@
+/*
+ * Copyright 2013 Arx Libertatis Team (see the AUTHORS file)
+ *
+ * This file is part of Arx Libertatis.
+ *
+ * Arx Libertatis is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Arx Libertatis is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Arx Libertatis.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "graphics/RenderBatcher.h"
+
+#include <algorithm>
+
+#include "graphics/Draw.h"
+#include "graphics/data/Mesh.h"
+#include "platform/Profiler.h"
+
+RenderBatcher::Stats RenderBatcher::frameStats;
+
+static const u32 InvalidMaterial = u32(-1);
+
+//! @return true if the blend factor does not depend on the destination color
+static bool isSourceFactor(Renderer::PixelBlendingFactor factor) {
+	switch(factor) {
+		case Renderer::BlendZero:
+		case Renderer::BlendOne:
+		case Renderer::BlendSrcColor:
+		case Renderer::BlendSrcAlpha:
+		case Renderer::BlendInvSrcColor:
+		case Renderer::BlendInvSrcAlpha: return true;
+		default: return false;
+	}
+}
+
+bool RenderMaterial::isOrderIndependent() const {
+	
+	if(!blending || depthWrite) {
+		return false;
+	}
+	
+	// dst + src * f(src)
+	if(dstBlend == Renderer::BlendOne && isSourceFactor(srcBlend)) {
+		return true;
+	}
+	
+	// dst * f(src)
+	if(srcBlend == Renderer::BlendZero && isSourceFactor(dstBlend)) {
+		return true;
+	}
+	
+	// dst * src
+	if(srcBlend == Renderer::BlendDstColor && dstBlend == Renderer::BlendZero) {
+		return true;
+	}
+	
+	return false;
+}
+
+bool RenderMaterial::commutesWith(const RenderMaterial & o) const {
+	return isOrderIndependent() && blending == o.blending && srcBlend == o.srcBlend
+	       && dstBlend == o.dstBlend && depthWrite == o.depthWrite;
+}
+
+void RenderBatcher::Stats::add(const Stats & o) {
+	draws += o.draws;
+	batches += o.batches;
+	stateChanges += o.stateChanges;
+	stateChangesSaved += o.stateChangesSaved;
+}
+
+RenderBatcher::RenderBatcher()
+	: segment(0), segmentMaterial(InvalidMaterial), segmentLayer(0),
+	  lastMaterial(InvalidMaterial), unsortedStateChanges(0) { }
+
+u32 RenderBatcher::getMaterialId(const RenderMaterial & material) {
+	
+	if(lastMaterial != InvalidMaterial && materials[lastMaterial] == material) {
+		return lastMaterial;
+	}
+	
+	// There are usually only a handful of different materials per batch
+	for(size_t i = 0; i < materials.size(); i++) {
+		if(materials[i] == material) {
+			return u32(i);
+		}
+	}
+	
+	materials.push_back(material);
+	return u32(materials.size() - 1);
+}
+
+void RenderBatcher::add(const RenderMaterial & material, Renderer::Primitive primitive,
+                        const TexturedVertex * in, size_t count, unsigned layer) {
+	
+	arx_assert(layer < 256);
+	
+	u32 id = getMaterialId(material);
+	
+	unsortedStateChanges += countStateChanges(
+		(lastMaterial == InvalidMaterial) ? NULL : &materials[lastMaterial], material);
+	lastMaterial = id;
+	
+	// Start a new segment unless the draw can be reordered with the current segment
+	if(segmentMaterial == InvalidMaterial || layer != segmentLayer
+	   || !material.commutesWith(materials[segmentMaterial])) {
+		if(segmentMaterial != InvalidMaterial) {
+			segment++;
+		}
+		segmentMaterial = id;
+		segmentLayer = layer;
+	}
+	
+	Command command;
+	command.key = (u64(layer) << 56) | (u64(segment) << 24) | u64(id);
+	command.material = id;
+	command.offset = u32(vertices.size());
+	
+	switch(primitive) {
+		
+		case Renderer::TriangleList: {
+			vertices.insert(vertices.end(), in, in + count);
+			break;
+		}
+		
+		case Renderer::TriangleStrip: {
+			for(size_t i = 2; i < count; i++) {
+				bool odd = (i & 1) != 0;
+				vertices.push_back(in[i - (odd ? 1 : 2)]);
+				vertices.push_back(in[i - (odd ? 2 : 1)]);
+				vertices.push_back(in[i]);
+			}
+			break;
+		}
+		
+		case Renderer::TriangleFan: {
+			for(size_t i = 2; i < count; i++) {
+				vertices.push_back(in[0]);
+				vertices.push_back(in[i - 1]);
+				vertices.push_back(in[i]);
+			}
+			break;
+		}
+		
+		default: {
+			arx_assert_msg(false, "unsupported primitive for batching: %d", int(primitive));
+			return;
+		}
+		
+	}
+	
+	command.count = u32(vertices.size() - command.offset);
+	if(command.count) {
+		commands.push_back(command);
+	}
+}
+
+size_t RenderBatcher::countStateChanges(const RenderMaterial * prev, const RenderMaterial & next) {
+	
+	if(!prev) {
+		return 5;
+	}
+	
+	size_t changes = 0;
+	changes += (prev->texture != next.texture);
+	changes += (prev->blending != next.blending);
+	changes += (next.blending && (prev->srcBlend != next.srcBlend || prev->dstBlend != next.dstBlend));
+	changes += (prev->depthWrite != next.depthWrite);
+	changes += (prev->culling != next.culling);
+	
+	return changes;
+}
+
+void RenderBatcher::applyMaterial(const RenderMaterial * prev, const RenderMaterial & next) {
+	
+	if(!prev || prev->texture != next.texture) {
+		GRenderer->SetTexture(0, next.texture);
+	}
+	
+	if(!prev || prev->blending != next.blending) {
+		GRenderer->SetRenderState(Renderer::AlphaBlending, next.blending);
+	}
+	
+	if(next.blending && (!prev || prev->srcBlend != next.srcBlend || prev->dstBlend != next.dstBlend)) {
+		GRenderer->SetBlendFunc(next.srcBlend, next.dstBlend);
+	}
+	
+	if(!prev || prev->depthWrite != next.depthWrite) {
+		GRenderer->SetRenderState(Renderer::DepthWrite, next.depthWrite);
+	}
+	
+	if(!prev || prev->culling != next.culling) {
+		GRenderer->SetCulling(next.culling);
+	}
+	
+}
+
+void RenderBatcher::render() {
+	
+	if(commands.empty()) {
+		clear();
+		return;
+	}
+	
+	ARX_PROFILE_FUNC();
+	
+	std::stable_sort(commands.begin(), commands.end());
+	
+	Stats stats;
+	stats.draws = commands.size();
+	
+	const RenderMaterial * current = NULL;
+	
+	for(size_t i = 0; i < commands.size(); ) {
+		
+		const RenderMaterial & material = materials[commands[i].material];
+		
+		// Merge all following draws with the same material
+		size_t end = i + 1;
+		while(end < commands.size() && commands[end].material == commands[i].material) {
+			end++;
+		}
+		
+		const TexturedVertex * data;
+		size_t count;
+		if(end == i + 1) {
+			data = &vertices[commands[i].offset], count = commands[i].count;
+		} else {
+			stream.clear();
+			for(size_t j = i; j < end; j++) {
+				const TexturedVertex * src = &vertices[commands[j].offset];
+				stream.insert(stream.end(), src, src + commands[j].count);
+			}
+			data = &stream[0], count = stream.size();
+		}
+		
+		stats.stateChanges += countStateChanges(current, material);
+		applyMaterial(current, material);
+		current = &material;
+		
+		EERIEDRAWPRIM(Renderer::TriangleList, data, count, true);
+		EERIEDrawnPolys += end - i;
+		stats.batches++;
+		
+		i = end;
+	}
+	
+	if(unsortedStateChanges > stats.stateChanges) {
+		stats.stateChangesSaved = unsortedStateChanges - stats.stateChanges;
+	}
+	
+	frameStats.add(stats);
+	
+	clear();
+}
+
+void RenderBatcher::clear() {
+	materials.clear();
+	commands.clear();
+	vertices.clear();
+	segment = 0;
+	segmentMaterial = InvalidMaterial;
+	segmentLayer = 0;
+	lastMaterial = InvalidMaterial;
+	unsortedStateChanges = 0;
+}
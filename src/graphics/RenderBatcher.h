@@ -0,0 +1,155 @@
+/*
+ * Copyright 2013 Arx Libertatis Team (see the AUTHORS file)
+ *
+ * This file is part of Arx Libertatis.
+ *
+ * Arx Libertatis is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Arx Libertatis is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Arx Libertatis.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ARX_GRAPHICS_RENDERBATCHER_H
+#define ARX_GRAPHICS_RENDERBATCHER_H
+
+#include <stddef.h>
+#include <vector>
+
+#include "graphics/Renderer.h"
+#include "graphics/Vertex.h"
+#include "platform/Platform.h"
+
+class TextureContainer;
+
+/*!
+ * Render state of a batched draw.
+ * 
+ * States that are not part of the material (depth test, fog, texture stage
+ * operations, ...) are left as they are when the batch is submitted.
+ */
+struct RenderMaterial {
+	
+	TextureContainer * texture;
+	
+	bool blending;
+	Renderer::PixelBlendingFactor srcBlend;
+	Renderer::PixelBlendingFactor dstBlend;
+	
+	bool depthWrite;
+	
+	Renderer::CullingMode culling;
+	
+	RenderMaterial()
+		: texture(NULL), blending(false), srcBlend(Renderer::BlendOne),
+		  dstBlend(Renderer::BlendZero), depthWrite(true), culling(Renderer::CullNone) { }
+	
+	/*!
+	 * @return true if draws using this material produce the same image
+	 *         regardless of the order in which they are drawn.
+	 */
+	bool isOrderIndependent() const;
+	
+	//! @return true if this and other can be drawn in any order relative to each other.
+	bool commutesWith(const RenderMaterial & other) const;
+	
+	bool operator==(const RenderMaterial & o) const {
+		return texture == o.texture && blending == o.blending && srcBlend == o.srcBlend
+		       && dstBlend == o.dstBlend && depthWrite == o.depthWrite && culling == o.culling;
+	}
+	
+};
+
+/*!
+ * Deferred command buffer for small draws such as sprites and particles.
+ * 
+ * Draws are recorded with add() and submitted with render(). Within a layer,
+ * runs of order-independent draws (e.g. additive blending without depth
+ * writes) are sorted by material so that draws sharing a texture and state
+ * are merged into one triangle list. Draws whose result depends on the order
+ * keep their position relative to all other draws in the layer.
+ */
+class RenderBatcher {
+	
+public:
+	
+	struct Stats {
+		
+		size_t draws; //!< Number of add() calls
+		size_t batches; //!< Number of draw calls submitted to the renderer
+		size_t stateChanges; //!< Number of render state changes submitted
+		size_t stateChangesSaved; //!< Number of state changes avoided by sorting
+		
+		Stats() : draws(0), batches(0), stateChanges(0), stateChangesSaved(0) { }
+		
+		void add(const Stats & o);
+		
+	};
+	
+	RenderBatcher();
+	
+	/*!
+	 * Record a draw.
+	 * Only triangle primitives are supported.
+	 * @param layer Layers are submitted in increasing order.
+	 */
+	void add(const RenderMaterial & material, Renderer::Primitive primitive,
+	         const TexturedVertex * vertices, size_t count, unsigned layer = 0);
+	
+	//! Submit all recorded draws and clear the batcher.
+	void render();
+	
+	//! Discard all recorded draws.
+	void clear();
+	
+	bool empty() const { return commands.empty(); }
+	
+	//! Statistics for all batchers since the last call to resetFrameStats().
+	static const Stats & getFrameStats() { return frameStats; }
+	static void resetFrameStats() { frameStats = Stats(); }
+	
+private:
+	
+	struct Command {
+		
+		u64 key;
+		u32 material;
+		u32 offset;
+		u32 count;
+		
+		bool operator<(const Command & o) const { return key < o.key; }
+		
+	};
+	
+	u32 getMaterialId(const RenderMaterial & material);
+	
+	//! Count the state changes needed to go from the previous material to the next one
+	static size_t countStateChanges(const RenderMaterial * prev, const RenderMaterial & next);
+	
+	//! Apply the state changes needed to go from the previous material to the next one
+	static void applyMaterial(const RenderMaterial * prev, const RenderMaterial & next);
+	
+	std::vector<RenderMaterial> materials;
+	std::vector<Command> commands;
+	std::vector<TexturedVertex> vertices;
+	std::vector<TexturedVertex> stream;
+	
+	u32 segment;
+	u32 segmentMaterial;
+	unsigned segmentLayer;
+	
+	u32 lastMaterial;
+	size_t unsortedStateChanges; //!< State changes needed to submit draws in the order they were added
+	
+	static Stats frameStats;
+	
+};
+
+#endif // ARX_GRAPHICS_RENDERBATCHER_H
@@ -42,6 +42,7 @@ void Renderer::SetTexture(unsigned int textureStage, Texture * pTexture) {
 void Renderer::SetTexture(unsigned int textureStage, TextureContainer * pTextureContainer) {
 	
 	if(pTextureContainer && pTextureContainer->m_pTexture) {
+		pTextureContainer->m_lastUsedFrame = TextureContainer::s_currentFrame;
 		GetTextureStage(textureStage)->SetTexture(pTextureContainer->m_pTexture);
 	} else {
 		GetTextureStage(textureStage)->ResetTexture();
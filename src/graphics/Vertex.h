@@ -82,6 +82,11 @@ struct SMY_VERTEX3 {
 	Vec2f uv[3];
 };
 
+//! Position padded to 16 bytes
+struct EERIE_3DPAD : public Vec3f {
+	float w;
+};
+
 struct EERIE_VERTEX {
 	TexturedVertex vert;
 	Vec3f v;
@@ -87,6 +87,7 @@ ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
 #include "scene/Scene.h"
 #include "scene/Light.h"
 #include "scene/Interactive.h"
+#include "scene/RoomCulling.h"
 
 #include "util/String.h"
 
@@ -247,9 +248,9 @@ EERIEPOLY * CheckInPoly(float x, float y, float z, float * needY)
 	rx = poss.x - ((float)px * ACTIVEBKG->Xdiv);
 	rz = poss.z - ((float)pz * ACTIVEBKG->Zdiv);
 
-	EERIEPOLY * ep;
+	CollisionPoly * cp;
 	FAST_BKG_DATA * feg;
-	EERIEPOLY * found = NULL;
+	CollisionPoly * found = NULL;
 
 	float foundY = 0.f;
 	short pzi, pza, pxi, pxa;
@@ -313,23 +314,23 @@ EERIEPOLY * CheckInPoly(float x, float y, float z, float * needY)
 
 			for (k = 0; k < feg->nbpolyin; k++)
 			{
-				ep = feg->polyin[k];
+				cp = feg->colin[k];
 
 				if (
-					(poss.x >= ep->min.x) && (poss.x <= ep->max.x)
-					&&	(poss.z >= ep->min.z) && (poss.z <= ep->max.z)
-					&& !(ep->type & (POLY_WATER | POLY_TRANS | POLY_NOCOL))
-					&& (ep->max.y >= poss.y)
-					&&	(ep != found)
-					&&	(PointIn2DPolyXZ(ep, poss.x, poss.z))
+					(poss.x >= cp->min.x) && (poss.x <= cp->max.x)
+					&&	(poss.z >= cp->min.z) && (poss.z <= cp->max.z)
+					&& !(cp->type & (POLY_WATER | POLY_TRANS | POLY_NOCOL))
+					&& (cp->max.y >= poss.y)
+					&&	(cp != found)
+					&&	(PointIn2DPolyXZ(cp, poss.x, poss.z))
 				)
 				{
-					if ((GetTruePolyY(ep, &poss, &rz))
+					if ((GetTruePolyY(cp, &poss, &rz))
 							&&	(rz >= poss.y)
 							&&	((found == NULL) || ((found != NULL) && (rz <= foundY)))
 					   )
 					{
-						found = ep;
+						found = cp;
 						foundY = rz;
 					}
 				}
@@ -338,7 +339,7 @@ EERIEPOLY * CheckInPoly(float x, float y, float z, float * needY)
 
 	if (needY) *needY = foundY;
 
-	return found;
+	return found ? found->ep : NULL;
 }
 
 EERIEPOLY * EECheckInPoly(const Vec3f * pos, float * needY) {
@@ -398,9 +399,9 @@ bool IsAnyPolyThere(float x, float z) {
 	
 	for(long k = 0; k < feg->nbpolyin; k++) {
 		
-		EERIEPOLY * ep = feg->polyin[k];
+		const CollisionPoly * cp = feg->colin[k];
 		
-		if(PointIn2DPolyXZ(ep, x, z)) {
+		if(PointIn2DPolyXZ(cp, x, z)) {
 			return true;
 		}
 	}
@@ -417,27 +418,27 @@ EERIEPOLY * GetMinPoly(float x, float y, float z) {
 	
 	Vec3f pos(x, y, z);
 	
-	EERIEPOLY * found = NULL;
+	CollisionPoly * found = NULL;
 	float foundy = 0.0f;
-	for (long k = 0; k < feg->nbpolyin; k++) {
+	for(long k = 0; k < feg->nbpolyin; k++) {
 		
-		EERIEPOLY * ep = feg->polyin[k];
-
-		if(ep->type & (POLY_WATER | POLY_TRANS | POLY_NOCOL))
+		CollisionPoly * cp = feg->colin[k];
+		
+		if(cp->type & (POLY_WATER | POLY_TRANS | POLY_NOCOL))
 			continue;
 		
-		if(PointIn2DPolyXZ(ep, x, z)) {
+		if(PointIn2DPolyXZ(cp, x, z)) {
 			float ret;
-			if(GetTruePolyY(ep, &pos, &ret)) {
+			if(GetTruePolyY(cp, &pos, &ret)) {
 				if(!found || ret > foundy) {
-					found = ep;
+					found = cp;
 					foundy = ret;
 				}
 			}
 		}
 	}
 	
-	return found;
+	return found ? found->ep : NULL;
 }
 
 EERIEPOLY * GetMaxPoly(float x, float y, float z) {
@@ -449,27 +450,27 @@ EERIEPOLY * GetMaxPoly(float x, float y, float z) {
 	
 	Vec3f pos(x, y, z);
 	
-	EERIEPOLY * found = NULL;
+	CollisionPoly * found = NULL;
 	float foundy = 0.0f;
 	for(long k = 0; k < feg->nbpolyin; k++) {
 		
-		EERIEPOLY * ep = feg->polyin[k];
+		CollisionPoly * cp = feg->colin[k];
 		
-		if(ep->type & (POLY_WATER | POLY_TRANS | POLY_NOCOL))
+		if(cp->type & (POLY_WATER | POLY_TRANS | POLY_NOCOL))
 			continue;
 		
-		if(PointIn2DPolyXZ(ep, x, z)) {
+		if(PointIn2DPolyXZ(cp, x, z)) {
 			float ret;
-			if(GetTruePolyY(ep, &pos, &ret)) {
+			if(GetTruePolyY(cp, &pos, &ret)) {
 				if(!found || ret < foundy) {
-					found = ep;
+					found = cp;
 					foundy = ret;
 				}
 			}
 		}
 	}
 	
-	return found;
+	return found ? found->ep : NULL;
 }
 
 EERIEPOLY * EEIsUnderWater(const Vec3f * pos) {
@@ -479,20 +480,20 @@ EERIEPOLY * EEIsUnderWater(const Vec3f * pos) {
 		return NULL;
 	}
 	
-	EERIEPOLY * found = NULL;
+	CollisionPoly * found = NULL;
 	for(short k = 0; k < feg->nbpolyin; k++) {
 		
-		EERIEPOLY * ep = feg->polyin[k];
+		CollisionPoly * cp = feg->colin[k];
 		
-		if(ep->type & POLY_WATER) {
-			if(ep->max.y < pos->y && PointIn2DPolyXZ(ep, pos->x, pos->z)) {
-				if(!found || ep->max.y < found->max.y) {
-					found = ep;
+		if(cp->type & POLY_WATER) {
+			if(cp->max.y < pos->y && PointIn2DPolyXZ(cp, pos->x, pos->z)) {
+				if(!found || cp->max.y < found->max.y) {
+					found = cp;
 				}
 			}
 		}
 	}
-	return found;
+	return found ? found->ep : NULL;
 }
 
 bool GetTruePolyY(const EERIEPOLY * ep, const Vec3f * pos, float * ret) {
@@ -520,6 +521,24 @@ bool GetTruePolyY(const EERIEPOLY * ep, const Vec3f * pos, float * ret) {
 	return true;
 }
 
+bool GetTruePolyY(const CollisionPoly * cp, const Vec3f * pos, float * ret) {
+	
+	if(cp->plane.y == 0.f) {
+		return false;
+	}
+	
+	float y = (cp->planed - (cp->plane.x * pos->x) - (cp->plane.z * pos->z)) / cp->plane.y;
+	
+	if(y < cp->min.y) {
+		y = cp->min.y;
+	} else if(y > cp->max.y) {
+		y = cp->max.y;
+	}
+	
+	*ret = y;
+	return true;
+}
+
 //*************************************************************************************
 //*************************************************************************************
 EERIE_BACKGROUND * ACTIVEBKG = NULL;
@@ -825,6 +844,31 @@ int PointIn2DPolyXZ(const EERIEPOLY * ep, float x, float z) {
 	return c + d;
 }
 
+int PointIn2DPolyXZ(const CollisionPoly * cp, float x, float z) {
+	
+	const Vec3f * v = cp->v;
+	
+	int c = 0, d = 0;
+	
+	for(int i = 0, j = 2; i < 3; j = i++) {
+		if((((v[i].z <= z) && (z < v[j].z)) || ((v[j].z <= z) && (z < v[i].z)))
+		   && (x < (v[j].x - v[i].x) * (z - v[i].z) / (v[j].z - v[i].z) + v[i].x)) {
+			c = !c;
+		}
+	}
+	
+	if(cp->type & POLY_QUAD) {
+		for(int i = 1, j = 3; i < 4; j = i++) {
+			if((((v[i].z <= z) && (z < v[j].z)) || ((v[j].z <= z) && (z < v[i].z)))
+			   && (x < (v[j].x - v[i].x) * (z - v[i].z) / (v[j].z - v[i].z) + v[i].x)) {
+				d = !d;
+			}
+		}
+	}
+	
+	return c + d;
+}
+
 int BackFaceCull2D(TexturedVertex * tv) {
 	if ((tv[0].p.x - tv[1].p.x)*(tv[2].p.y - tv[1].p.y) - (tv[0].p.y - tv[1].p.y)*(tv[2].p.x - tv[1].p.x) > 0.f)
 		return 0;
@@ -1136,6 +1180,8 @@ long BKG_CountIgnoredPolys(EERIE_BACKGROUND * eb) {
 void ReleaseBKG_INFO(EERIE_BKG_INFO * eg) {
 	free(eg->polydata), eg->polydata = NULL;
 	free(eg->polyin), eg->polyin = NULL;
+	free(eg->coldata), eg->coldata = NULL;
+	free(eg->colin), eg->colin = NULL;
 	eg->nbpolyin = 0;
 	memset(eg, 0, sizeof(EERIE_BKG_INFO));
 }
@@ -1347,18 +1393,43 @@ void DeclareEGInfo(float x, float z)
 	eg->nothing = 0;
 }
 
-void EERIEPOLY_Add_PolyIn(EERIE_BKG_INFO * eg, EERIEPOLY * ep)
+void EERIEPOLY_Add_PolyIn(EERIE_BKG_INFO * eg, EERIEPOLY * ep, CollisionPoly * cp)
 {
 	for(long i = 0; i < eg->nbpolyin; i++)
 		if(eg->polyin[i] == ep)
 			return;
 
 	eg->polyin = (EERIEPOLY **)realloc(eg->polyin, sizeof(EERIEPOLY *) * (eg->nbpolyin + 1));
+	eg->colin = (CollisionPoly **)realloc(eg->colin, sizeof(CollisionPoly *) * (eg->nbpolyin + 1));
 
 	eg->polyin[eg->nbpolyin] = ep;
+	eg->colin[eg->nbpolyin] = cp;
 	eg->nbpolyin++;
 }
 
+static void EERIEPOLY_Compute_CollisionPoly(CollisionPoly * cp, EERIEPOLY * ep) {
+	
+	cp->type = ep->type;
+	cp->area = ep->area;
+	for(long k = 0; k < 4; k++) {
+		cp->v[k] = ep->v[k].p;
+	}
+	cp->center = ep->center;
+	cp->min = ep->min;
+	cp->max = ep->max;
+	cp->normy = ep->norm.y;
+	cp->ep = ep;
+	
+	// Same calculation as in GetTruePolyY(const EERIEPOLY *, ...)
+	Vec3f s21 = ep->v[1].p - ep->v[0].p;
+	Vec3f s31 = ep->v[2].p - ep->v[0].p;
+	cp->plane.x = (s21.y * s31.z) - (s21.z * s31.y);
+	cp->plane.y = (s21.z * s31.x) - (s21.x * s31.z);
+	cp->plane.z = (s21.x * s31.y) - (s21.y * s31.x);
+	cp->planed = ep->v[0].p.x * cp->plane.x + ep->v[0].p.y * cp->plane.y
+	             + ep->v[0].p.z * cp->plane.z;
+}
+
 bool PointInBBox(Vec3f * point, EERIE_2D_BBOX * bb)
 {
 	if ((point->x > bb->max.x)
@@ -1373,12 +1444,27 @@ bool PointInBBox(Vec3f * point, EERIE_2D_BBOX * bb)
 
 void EERIEPOLY_Compute_PolyIn()
 {
+	for(long j = 0; j < ACTIVEBKG->Zsize; j++)
+		for(long i = 0; i < ACTIVEBKG->Xsize; i++) {
+			
+			EERIE_BKG_INFO *eg = &ACTIVEBKG->Backg[i+j*ACTIVEBKG->Xsize];
+			
+			free(eg->coldata), eg->coldata = NULL;
+			if(eg->nbpoly) {
+				eg->coldata = (CollisionPoly *)malloc(sizeof(CollisionPoly) * eg->nbpoly);
+				for(long l = 0; l < eg->nbpoly; l++) {
+					EERIEPOLY_Compute_CollisionPoly(&eg->coldata[l], &eg->polydata[l]);
+				}
+			}
+		}
+	
 	for(long j = 0; j < ACTIVEBKG->Zsize; j++)
 		for(long i = 0; i < ACTIVEBKG->Xsize; i++) {
 			
 			EERIE_BKG_INFO *eg = &ACTIVEBKG->Backg[i+j*ACTIVEBKG->Xsize];
 			
 			free(eg->polyin), eg->polyin = NULL;
+			free(eg->colin), eg->colin = NULL;
 			eg->nbpolyin = 0;
 			
 			long ii = max(i - 2, 0L);
@@ -1408,16 +1494,16 @@ void EERIEPOLY_Compute_PolyIn()
 						long nbvert = (ep2->type & POLY_QUAD) ? 4 : 3;
 
 						if(PointInBBox(&ep2->center, &bb)) {
-							EERIEPOLY_Add_PolyIn(eg, ep2);
+							EERIEPOLY_Add_PolyIn(eg, ep2, &eg2->coldata[l]);
 						} else {
 							for(long k = 0; k < nbvert; k++) {
 								if(PointInBBox(&ep2->v[k].p, &bb)) {
-									EERIEPOLY_Add_PolyIn(eg, ep2);
+									EERIEPOLY_Add_PolyIn(eg, ep2, &eg2->coldata[l]);
 									break;
 								} else {
 									Vec3f pt = (ep2->v[k].p + ep2->center) * .5f;
 									if(PointInBBox(&pt, &bb)) {
-										EERIEPOLY_Add_PolyIn(eg, ep2);
+										EERIEPOLY_Add_PolyIn(eg, ep2, &eg2->coldata[l]);
 										break;
 									}
 								}
@@ -1454,6 +1540,8 @@ void EERIEPOLY_Compute_PolyIn()
 			fbd->frustrum_maxy = eg->frustrum_maxy;
 			fbd->polydata = eg->polydata;
 			fbd->polyin = eg->polyin;
+			fbd->coldata = eg->coldata;
+			fbd->colin = eg->colin;
 			fbd->ianchors = eg->ianchors;
 		}
 }
@@ -1572,6 +1660,7 @@ static void EERIE_PORTAL_Release() {
 				free(portals->room[nn].epdata), portals->room[nn].epdata = NULL;
 				free(portals->room[nn].portals), portals->room[nn].portals = NULL;
 				delete portals->room[nn].pVertexBuffer, portals->room[nn].pVertexBuffer = NULL;
+				delete portals->room[nn].pCullData, portals->room[nn].pCullData = NULL;
 				free(portals->room[nn].pussIndice), portals->room[nn].pussIndice = NULL;
 				free(portals->room[nn].ppTextureContainer);
 				portals->room[nn].ppTextureContainer = NULL;
@@ -3090,6 +3179,7 @@ void EERIE_PORTAL_ReleaseOnlyVertexBuffer() {
 	for(long i = 0; i < portals->nb_rooms + 1; i++) {
 		portals->room[i].usNbTextures = 0;
 		delete portals->room[i].pVertexBuffer, portals->room[i].pVertexBuffer = NULL;
+		delete portals->room[i].pCullData, portals->room[i].pCullData = NULL;
 		free(portals->room[i].pussIndice), portals->room[i].pussIndice = NULL;
 		free(portals->room[i].ppTextureContainer), portals->room[i].ppTextureContainer = NULL;
 	}
@@ -3220,6 +3310,16 @@ void ComputePortalVertexBuffer() {
 		room->pVertexBuffer = GRenderer->createVertexBuffer(vertexCount,
 		                                                    Renderer::Dynamic);
 		
+		// Collect the data needed to cull this room's polygons
+		room->pCullData = new RoomCullData;
+		for(int j = 0; j < room->nb_polys; j++) {
+			int x = room->epdata[j].px, y = room->epdata[j].py;
+			EERIE_BKG_INFO & cell = ACTIVEBKG->Backg[x + y * ACTIVEBKG->Xsize];
+			const EERIEPOLY & poly = cell.polydata[room->epdata[j].idx];
+			bool drawable = poly.tex && !(poly.type & (POLY_IGNORE | POLY_NODRAW | POLY_HIDE));
+			room->pCullData->add(poly, drawable);
+		}
+		
 		
 		// Now fill the buffers
 		
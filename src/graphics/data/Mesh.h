@@ -76,6 +76,8 @@ struct EERIE_BKG_INFO
 	float				frustrum_maxy;
 	EERIEPOLY *			polydata;
 	EERIEPOLY **		polyin;
+	CollisionPoly *		coldata; // collision data for polydata
+	CollisionPoly **	colin; // collision data for polyin
 	long *				ianchors; // index on anchors list
 	long				flags;
 	float				tile_miny;
@@ -103,6 +105,8 @@ struct FAST_BKG_DATA
 	float				frustrum_maxy;
 	EERIEPOLY *			polydata;
 	EERIEPOLY **		polyin;
+	CollisionPoly *		coldata; // collision data for polydata
+	CollisionPoly **	colin; // collision data for polyin
 	long *				ianchors; // index on anchors list
 };
 #define MAX_BKGX	160
@@ -174,6 +178,7 @@ EERIEPOLY * EEIsUnderWater(const Vec3f * pos);
 EERIEPOLY * EEIsUnderWaterFast(const Vec3f * pos);
 
 bool GetTruePolyY(const EERIEPOLY * ep, const Vec3f * pos,float * ret);
+bool GetTruePolyY(const CollisionPoly * cp, const Vec3f * pos, float * ret);
 bool IsAnyPolyThere(float x, float z);
 bool IsVertexIdxInGroup(EERIE_3DOBJ * eobj,long idx,long grs);
 EERIEPOLY * GetMinPoly(float x, float y, float z);
@@ -181,6 +186,7 @@ EERIEPOLY * GetMaxPoly(float x, float y, float z);
  
 float GetColorz(float x, float y, float z);
 int PointIn2DPolyXZ(const EERIEPOLY * ep, float x, float z);
+int PointIn2DPolyXZ(const CollisionPoly * cp, float x, float z);
 
 int EERIELaunchRay2(Vec3f * orgn, Vec3f * dest,  Vec3f * hit, EERIEPOLY * tp, long flag);
 int EERIELaunchRay3(Vec3f * orgn, Vec3f * dest,  Vec3f * hit, EERIEPOLY * tp, long flag);
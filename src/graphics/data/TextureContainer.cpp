@@ -53,9 +53,11 @@ ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
 #include <utility>
 
 #include <boost/algorithm/string/case_conv.hpp>
+#include <boost/unordered_map.hpp>
 
 #include "graphics/Renderer.h"
 #include "graphics/texture/Texture.h"
+#include "graphics/texture/TextureStream.h"
 
 #include "io/resource/ResourcePath.h"
 #include "io/resource/PakReader.h"
@@ -79,6 +81,29 @@ const TextureContainer::TCFlags TextureContainer::UI = (TextureContainer::NoMipm
 
 static TextureContainer * g_ptcTextureList = NULL;
 
+namespace {
+
+struct RegistryEntry {
+	//! The most recently created texture with this name
+	TextureContainer * texture;
+	//! Number of textures in the list with this name
+	size_t count;
+};
+
+/*!
+ * Index of the texture list by (normalized) texture name.
+ * The linked list is only used to iterate over all textures.
+ */
+typedef boost::unordered_map<std::string, RegistryEntry> TextureRegistry;
+TextureRegistry g_textureRegistry;
+
+size_t g_textureLookups = 0;
+size_t g_textureLookupHits = 0;
+
+} // anonymous namespace
+
+u32 TextureContainer::s_currentFrame = 0;
+
 TextureContainer * GetTextureList() {
 	return g_ptcTextureList;
 }
@@ -132,13 +157,23 @@ TextureContainer::TextureContainer(const res::path & strName, TCFlags flags) : m
 	m_pTexture = NULL;
 
 	userflags = 0;
+	m_lastUsedFrame = s_currentFrame;
 	TextureRefinement = NULL;
 	TextureHalo = NULL;
 
 	// Add the texture to the head of the global texture list
+	m_pNext = NULL;
+	m_pPrev = NULL;
 	if(!(flags & NoInsert)) {
 		m_pNext = g_ptcTextureList;
+		if(g_ptcTextureList) {
+			g_ptcTextureList->m_pPrev = this;
+		}
 		g_ptcTextureList = this;
+		
+		RegistryEntry & entry = g_textureRegistry[m_texName.string()];
+		entry.texture = this;
+		entry.count++;
 	}
 
 	delayed = NULL;
@@ -175,19 +210,37 @@ TextureContainer::TextureContainer(const res::path & strName, TCFlags flags) : m
 
 TextureContainer::~TextureContainer() {
 	
+	texturestream::remove(this);
+	
 	delete m_pTexture;
 	delete TextureHalo;
 	
 	free(delayed), delayed = NULL;
 	
 	// Remove the texture container from the global list
-	if(g_ptcTextureList == this) {
-		g_ptcTextureList = m_pNext;
-	} else {
-		for(TextureContainer * ptc = g_ptcTextureList; ptc; ptc = ptc->m_pNext) {
-			if(ptc->m_pNext == this) {
-				ptc->m_pNext = m_pNext;
+	if(!(m_dwFlags & NoInsert)) {
+		
+		if(m_pPrev) {
+			m_pPrev->m_pNext = m_pNext;
+		} else {
+			g_ptcTextureList = m_pNext;
+		}
+		if(m_pNext) {
+			m_pNext->m_pPrev = m_pPrev;
+		}
+		
+		TextureRegistry::iterator it = g_textureRegistry.find(m_texName.string());
+		arx_assert(it != g_textureRegistry.end());
+		if(--it->second.count == 0) {
+			g_textureRegistry.erase(it);
+		} else if(it->second.texture == this) {
+			// Fall back to the next most recent texture with the same name
+			TextureContainer * ptc = g_ptcTextureList;
+			while(ptc && ptc->m_texName != m_texName) {
+				ptc = ptc->m_pNext;
 			}
+			arx_assert(ptc != NULL);
+			it->second.texture = ptc;
 		}
 	}
 	
@@ -208,12 +261,6 @@ bool TextureContainer::LoadFile(const res::path & strPathname) {
 		return false;
 	}
 	
-	delete m_pTexture, m_pTexture = NULL;
-	m_pTexture = GRenderer->CreateTexture2D();
-	if(!m_pTexture) {
-		return false;
-	}
-	
 	Texture::TextureFlags flags = 0;
 	
 	if(!(m_dwFlags & NoColorKey) && tempPath.ext() == ".bmp") {
@@ -224,6 +271,17 @@ bool TextureContainer::LoadFile(const res::path & strPathname) {
 		flags |= Texture::HasMipmaps;
 	}
 	
+	// Load world textures in the background, UI textures are needed right away
+	if(!(m_dwFlags & NoMipmap) && texturestream::load(this, tempPath, flags)) {
+		return true;
+	}
+	
+	delete m_pTexture, m_pTexture = NULL;
+	m_pTexture = GRenderer->CreateTexture2D();
+	if(!m_pTexture) {
+		return false;
+	}
+	
 	if(!m_pTexture->Init(tempPath, flags)) {
 		LogError << "Error creating texture " << tempPath;
 		return false;
@@ -349,18 +407,26 @@ bool TextureContainer::CreateHalo() {
 
 TextureContainer * TextureContainer::Find(const res::path & strTextureName) {
 	
-	TextureContainer * ptcTexture = g_ptcTextureList;
+	g_textureLookups++;
 	
-	while(ptcTexture) {
-		
-		if(strTextureName == ptcTexture->m_texName) {
-			return ptcTexture;
-		}
-		
-		ptcTexture = ptcTexture->m_pNext;
+	TextureRegistry::const_iterator it = g_textureRegistry.find(strTextureName.string());
+	if(it == g_textureRegistry.end()) {
+		return NULL;
 	}
 	
-	return NULL;
+	g_textureLookupHits++;
+	
+	return it->second.texture;
+}
+
+TextureContainer::LookupStats TextureContainer::getLookupStats() {
+	
+	LookupStats stats;
+	stats.textures = g_textureRegistry.size();
+	stats.lookups = g_textureLookups;
+	stats.hits = g_textureLookupHits;
+	
+	return stats;
 }
 
 void TextureContainer::DeleteAll(TCFlags flag)
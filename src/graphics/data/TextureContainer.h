@@ -124,6 +124,15 @@ public:
 	 */
 	static TextureContainer * Find(const res::path & strTextureName);
 	
+	struct LookupStats {
+		size_t textures; //!< Number of registered texture names
+		size_t lookups; //!< Number of calls to Find()
+		size_t hits; //!< Number of lookups that found a texture
+	};
+	
+	//! Get statistics about texture lookups since the program started.
+	static LookupStats getLookupStats();
+	
 	static void DeleteAll(TCFlags flag = TCFlags::all());
 	
 	/*!
@@ -167,6 +176,13 @@ public:
 	
 	TextureContainer * TextureRefinement;
 	TextureContainer * m_pNext; // Linked list ptr
+	TextureContainer * m_pPrev;
+	
+	//! Value of s_currentFrame when this texture was last bound.
+	u32 m_lastUsedFrame;
+	//! Frame counter used to find unused textures.
+	static u32 s_currentFrame;
+	
 	TCFlags systemflags;
 	
 	// BEGIN TODO: Move to a RenderBatch class... This RenderBatch class should contain a pointer to the TextureContainer used by the batch
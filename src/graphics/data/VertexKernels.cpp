@@ -0,0 +1,276 @@
+/*
+ * Copyright 2013 Arx Libertatis Team (see the AUTHORS file)
+ *
+ * This file is part of Arx Libertatis.
+ *
+ * Arx Libertatis is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Arx Libertatis is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Arx Libertatis.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "graphics/data/VertexKernels.h"
+
+#include <algorithm>
+
+#ifdef ARX_HAVE_SSE2_VERTEX
+#include <emmintrin.h>
+#endif
+
+namespace vertexkernels {
+
+namespace {
+
+inline void projectVertex(const ProjectionParams & params, EERIE_VERTEX & vertex) {
+	
+	Vec3f & out = vertex.vworld;
+	out = vertex.vert.p - params.pos;
+	
+	float temp = (out.z * params.ycos) - (out.x * params.ysin);
+	out.x = (out.x * params.ycos) + (out.z * params.ysin);
+	out.z = (out.y * params.xsin) + (temp * params.xcos);
+	out.y = (out.y * params.xcos) - (temp * params.xsin);
+	
+	temp = (out.y * params.zcos) - (out.x * params.zsin);
+	out.x = (out.x * params.zcos) + (out.y * params.zsin);
+	out.y = temp;
+	
+	float fZTemp = 1.f / std::max(out.z, 0.000001f);
+	
+	vertex.vert.p.z = fZTemp * params.depthScale + params.depthOffset;
+	vertex.vert.p.x = out.x * params.scaleX * fZTemp + params.offset.x;
+	vertex.vert.p.y = out.y * params.scaleY * fZTemp + params.offset.y;
+	vertex.vert.rhw = fZTemp;
+}
+
+#ifdef ARX_HAVE_SSE2_VERTEX
+
+//! Store the first three components of a register to unaligned memory.
+inline void storeVec3(Vec3f & dst, __m128 v) {
+	_mm_storel_pi(reinterpret_cast<__m64 *>(&dst.x), v);
+	_mm_store_ss(&dst.z, _mm_movehl_ps(v, v));
+}
+
+#endif // ARX_HAVE_SSE2_VERTEX
+
+} // anonymous namespace
+
+void skinVerticesReference(const EERIEMATRIX & matrix, const Vec3f & translation,
+                           const EERIE_3DPAD * in, const long * indices, size_t count,
+                           EERIE_VERTEX * out) {
+	
+	for(size_t i = 0; i < count; i++) {
+		const EERIE_3DPAD & src = in[indices[i]];
+		EERIE_VERTEX & dst = out[indices[i]];
+		dst.v.x = src.x * matrix._11 + src.y * matrix._21 + src.z * matrix._31;
+		dst.v.y = src.x * matrix._12 + src.y * matrix._22 + src.z * matrix._32;
+		dst.v.z = src.x * matrix._13 + src.y * matrix._23 + src.z * matrix._33;
+		dst.v += translation;
+		dst.vert.p = dst.v;
+	}
+}
+
+void skinVertices(const EERIEMATRIX & matrix, const Vec3f & translation,
+                  const EERIE_3DPAD * in, const long * indices, size_t count,
+                  EERIE_VERTEX * out) {
+	
+	size_t i = 0;
+	
+#ifdef ARX_HAVE_SSE2_VERTEX
+	
+	const __m128 m11 = _mm_set1_ps(matrix._11);
+	const __m128 m12 = _mm_set1_ps(matrix._12);
+	const __m128 m13 = _mm_set1_ps(matrix._13);
+	const __m128 m21 = _mm_set1_ps(matrix._21);
+	const __m128 m22 = _mm_set1_ps(matrix._22);
+	const __m128 m23 = _mm_set1_ps(matrix._23);
+	const __m128 m31 = _mm_set1_ps(matrix._31);
+	const __m128 m32 = _mm_set1_ps(matrix._32);
+	const __m128 m33 = _mm_set1_ps(matrix._33);
+	const __m128 tx = _mm_set1_ps(translation.x);
+	const __m128 ty = _mm_set1_ps(translation.y);
+	const __m128 tz = _mm_set1_ps(translation.z);
+	
+	for(; i + 4 <= count; i += 4) {
+		
+		// EERIE_3DPAD is padded to 16 bytes, so each vertex is one load
+		__m128 x = _mm_loadu_ps(&in[indices[i + 0]].x);
+		__m128 y = _mm_loadu_ps(&in[indices[i + 1]].x);
+		__m128 z = _mm_loadu_ps(&in[indices[i + 2]].x);
+		__m128 w = _mm_loadu_ps(&in[indices[i + 3]].x);
+		_MM_TRANSPOSE4_PS(x, y, z, w);
+		
+		__m128 rx = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m11), _mm_mul_ps(y, m21)),
+		                                  _mm_mul_ps(z, m31)), tx);
+		__m128 ry = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m12), _mm_mul_ps(y, m22)),
+		                                  _mm_mul_ps(z, m32)), ty);
+		__m128 rz = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m13), _mm_mul_ps(y, m23)),
+		                                  _mm_mul_ps(z, m33)), tz);
+		__m128 rw = _mm_setzero_ps();
+		_MM_TRANSPOSE4_PS(rx, ry, rz, rw);
+		
+		EERIE_VERTEX & v0 = out[indices[i + 0]];
+		storeVec3(v0.v, rx), storeVec3(v0.vert.p, rx);
+		EERIE_VERTEX & v1 = out[indices[i + 1]];
+		storeVec3(v1.v, ry), storeVec3(v1.vert.p, ry);
+		EERIE_VERTEX & v2 = out[indices[i + 2]];
+		storeVec3(v2.v, rz), storeVec3(v2.vert.p, rz);
+		EERIE_VERTEX & v3 = out[indices[i + 3]];
+		storeVec3(v3.v, rw), storeVec3(v3.vert.p, rw);
+	}
+	
+#endif // ARX_HAVE_SSE2_VERTEX
+	
+	skinVerticesReference(matrix, translation, in, indices + i, count - i, out);
+}
+
+void projectVerticesReference(const ProjectionParams & params, EERIE_VERTEX * vertices,
+                              size_t count, Vec3f & min3D, Vec3f & max3D,
+                              Vec2f & min2D, Vec2f & max2D) {
+	
+	for(size_t i = 0; i < count; i++) {
+		
+		EERIE_VERTEX & vertex = vertices[i];
+		
+		min3D = componentwise_min(min3D, vertex.v);
+		max3D = componentwise_max(max3D, vertex.v);
+		
+		projectVertex(params, vertex);
+		
+		if(vertex.vert.rhw > 0.f) {
+			min2D.x = std::min(min2D.x, vertex.vert.p.x);
+			max2D.x = std::max(max2D.x, vertex.vert.p.x);
+			min2D.y = std::min(min2D.y, vertex.vert.p.y);
+			max2D.y = std::max(max2D.y, vertex.vert.p.y);
+		}
+	}
+}
+
+void projectVertices(const ProjectionParams & params, EERIE_VERTEX * vertices,
+                     size_t count, Vec3f & min3D, Vec3f & max3D,
+                     Vec2f & min2D, Vec2f & max2D) {
+	
+	size_t i = 0;
+	
+#ifdef ARX_HAVE_SSE2_VERTEX
+	
+	if(count >= 4) {
+		
+		const __m128 posX = _mm_set1_ps(params.pos.x);
+		const __m128 posY = _mm_set1_ps(params.pos.y);
+		const __m128 posZ = _mm_set1_ps(params.pos.z);
+		const __m128 xsin = _mm_set1_ps(params.xsin);
+		const __m128 xcos = _mm_set1_ps(params.xcos);
+		const __m128 ysin = _mm_set1_ps(params.ysin);
+		const __m128 ycos = _mm_set1_ps(params.ycos);
+		const __m128 zsin = _mm_set1_ps(params.zsin);
+		const __m128 zcos = _mm_set1_ps(params.zcos);
+		const __m128 scaleX = _mm_set1_ps(params.scaleX);
+		const __m128 scaleY = _mm_set1_ps(params.scaleY);
+		const __m128 depthScale = _mm_set1_ps(params.depthScale);
+		const __m128 depthOffset = _mm_set1_ps(params.depthOffset);
+		const __m128 offsetX = _mm_set1_ps(params.offset.x);
+		const __m128 offsetY = _mm_set1_ps(params.offset.y);
+		const __m128 nearClamp = _mm_set1_ps(0.000001f);
+		const __m128 one = _mm_set1_ps(1.f);
+		const __m128 zero = _mm_setzero_ps();
+		
+		// Each lane accumulates the bounds of every fourth vertex
+		__m128 min3X = _mm_set1_ps(min3D.x), max3X = _mm_set1_ps(max3D.x);
+		__m128 min3Y = _mm_set1_ps(min3D.y), max3Y = _mm_set1_ps(max3D.y);
+		__m128 min3Z = _mm_set1_ps(min3D.z), max3Z = _mm_set1_ps(max3D.z);
+		__m128 min2X = _mm_set1_ps(min2D.x), max2X = _mm_set1_ps(max2D.x);
+		__m128 min2Y = _mm_set1_ps(min2D.y), max2Y = _mm_set1_ps(max2D.y);
+		
+		for(; i + 4 <= count; i += 4) {
+			
+			EERIE_VERTEX * v = vertices + i;
+			
+			// The bounding box uses the skinned position, the projection uses vert.p
+			__m128 vx = _mm_loadu_ps(&v[0].v.x);
+			__m128 vy = _mm_loadu_ps(&v[1].v.x);
+			__m128 vz = _mm_loadu_ps(&v[2].v.x);
+			__m128 vw = _mm_loadu_ps(&v[3].v.x);
+			_MM_TRANSPOSE4_PS(vx, vy, vz, vw);
+			
+			// Operand order matches std::min / std::max so that NaNs behave the same
+			min3X = _mm_min_ps(vx, min3X), max3X = _mm_max_ps(vx, max3X);
+			min3Y = _mm_min_ps(vy, min3Y), max3Y = _mm_max_ps(vy, max3Y);
+			min3Z = _mm_min_ps(vz, min3Z), max3Z = _mm_max_ps(vz, max3Z);
+			
+			__m128 x = _mm_loadu_ps(&v[0].vert.p.x);
+			__m128 y = _mm_loadu_ps(&v[1].vert.p.x);
+			__m128 z = _mm_loadu_ps(&v[2].vert.p.x);
+			__m128 w = _mm_loadu_ps(&v[3].vert.p.x);
+			_MM_TRANSPOSE4_PS(x, y, z, w);
+			
+			x = _mm_sub_ps(x, posX);
+			y = _mm_sub_ps(y, posY);
+			z = _mm_sub_ps(z, posZ);
+			
+			__m128 temp = _mm_sub_ps(_mm_mul_ps(z, ycos), _mm_mul_ps(x, ysin));
+			x = _mm_add_ps(_mm_mul_ps(x, ycos), _mm_mul_ps(z, ysin));
+			z = _mm_add_ps(_mm_mul_ps(y, xsin), _mm_mul_ps(temp, xcos));
+			y = _mm_sub_ps(_mm_mul_ps(y, xcos), _mm_mul_ps(temp, xsin));
+			
+			temp = _mm_sub_ps(_mm_mul_ps(y, zcos), _mm_mul_ps(x, zsin));
+			x = _mm_add_ps(_mm_mul_ps(x, zcos), _mm_mul_ps(y, zsin));
+			y = temp;
+			
+			__m128 rhw = _mm_div_ps(one, _mm_max_ps(nearClamp, z));
+			__m128 px = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(x, scaleX), rhw), offsetX);
+			__m128 py = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(y, scaleY), rhw), offsetY);
+			__m128 pz = _mm_add_ps(_mm_mul_ps(rhw, depthScale), depthOffset);
+			
+			__m128 visible = _mm_cmpgt_ps(rhw, zero);
+			__m128 selMinX = _mm_or_ps(_mm_and_ps(visible, px), _mm_andnot_ps(visible, min2X));
+			__m128 selMaxX = _mm_or_ps(_mm_and_ps(visible, px), _mm_andnot_ps(visible, max2X));
+			__m128 selMinY = _mm_or_ps(_mm_and_ps(visible, py), _mm_andnot_ps(visible, min2Y));
+			__m128 selMaxY = _mm_or_ps(_mm_and_ps(visible, py), _mm_andnot_ps(visible, max2Y));
+			min2X = _mm_min_ps(selMinX, min2X), max2X = _mm_max_ps(selMaxX, max2X);
+			min2Y = _mm_min_ps(selMinY, min2Y), max2Y = _mm_max_ps(selMaxY, max2Y);
+			
+			__m128 ww = _mm_setzero_ps();
+			_MM_TRANSPOSE4_PS(x, y, z, ww);
+			storeVec3(v[0].vworld, x);
+			storeVec3(v[1].vworld, y);
+			storeVec3(v[2].vworld, z);
+			storeVec3(v[3].vworld, ww);
+			
+			// vert.p and vert.rhw are adjacent
+			_MM_TRANSPOSE4_PS(px, py, pz, rhw);
+			_mm_storeu_ps(&v[0].vert.p.x, px);
+			_mm_storeu_ps(&v[1].vert.p.x, py);
+			_mm_storeu_ps(&v[2].vert.p.x, pz);
+			_mm_storeu_ps(&v[3].vert.p.x, rhw);
+		}
+		
+		float lanes[10][4];
+		_mm_storeu_ps(lanes[0], min3X), _mm_storeu_ps(lanes[1], max3X);
+		_mm_storeu_ps(lanes[2], min3Y), _mm_storeu_ps(lanes[3], max3Y);
+		_mm_storeu_ps(lanes[4], min3Z), _mm_storeu_ps(lanes[5], max3Z);
+		_mm_storeu_ps(lanes[6], min2X), _mm_storeu_ps(lanes[7], max2X);
+		_mm_storeu_ps(lanes[8], min2Y), _mm_storeu_ps(lanes[9], max2Y);
+		for(size_t j = 0; j < 4; j++) {
+			min3D.x = std::min(min3D.x, lanes[0][j]), max3D.x = std::max(max3D.x, lanes[1][j]);
+			min3D.y = std::min(min3D.y, lanes[2][j]), max3D.y = std::max(max3D.y, lanes[3][j]);
+			min3D.z = std::min(min3D.z, lanes[4][j]), max3D.z = std::max(max3D.z, lanes[5][j]);
+			min2D.x = std::min(min2D.x, lanes[6][j]), max2D.x = std::max(max2D.x, lanes[7][j]);
+			min2D.y = std::min(min2D.y, lanes[8][j]), max2D.y = std::max(max2D.y, lanes[9][j]);
+		}
+	}
+	
+#endif // ARX_HAVE_SSE2_VERTEX
+	
+	projectVerticesReference(params, vertices + i, count - i, min3D, max3D, min2D, max2D);
+}
+
+} // namespace vertexkernels
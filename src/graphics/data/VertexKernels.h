@@ -0,0 +1,88 @@
+/*
+ * Copyright 2013 Arx Libertatis Team (see the AUTHORS file)
+ *
+ * This file is part of Arx Libertatis.
+ *
+ * Arx Libertatis is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Arx Libertatis is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Arx Libertatis.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ARX_GRAPHICS_DATA_VERTEXKERNELS_H
+#define ARX_GRAPHICS_DATA_VERTEXKERNELS_H
+
+#include <stddef.h>
+
+#include "graphics/BaseGraphicsTypes.h"
+#include "graphics/Vertex.h"
+#include "math/Vector2.h"
+#include "math/Vector3.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ARX_HAVE_SSE2_VERTEX 1
+#endif
+
+/*!
+ * Vertex processing loops used to skin and project animated meshes.
+ * 
+ * Where SSE2 is available, four vertices are processed at once. The results
+ * are always bit-identical to the *Reference() versions, which match the
+ * per-vertex TransformVertexMatrix(), EE_RT() and EE_P() helpers and are kept
+ * for testing.
+ */
+namespace vertexkernels {
+
+//! Camera state needed to project vertices, see EE_RT() and EE_P().
+struct ProjectionParams {
+	
+	Vec3f pos;
+	float xsin, xcos;
+	float ysin, ycos;
+	float zsin, zcos;
+	
+	float scaleX; //!< ProjectionMatrix._11
+	float scaleY; //!< ProjectionMatrix._22
+	float depthScale; //!< ProjectionMatrix._33
+	float depthOffset; //!< ProjectionMatrix._43
+	
+	Vec2f offset;
+	
+};
+
+/*!
+ * Transform the vertices in[indices[i]] by a bone matrix and translation.
+ * The result is stored in both out[indices[i]].v and out[indices[i]].vert.p.
+ */
+void skinVertices(const EERIEMATRIX & matrix, const Vec3f & translation,
+                  const EERIE_3DPAD * in, const long * indices, size_t count,
+                  EERIE_VERTEX * out);
+void skinVerticesReference(const EERIEMATRIX & matrix, const Vec3f & translation,
+                           const EERIE_3DPAD * in, const long * indices, size_t count,
+                           EERIE_VERTEX * out);
+
+/*!
+ * Rotate vert.p into camera space (stored in vworld) and project it to the
+ * screen (stored in vert.p and vert.rhw).
+ * 
+ * The bounding boxes are extended to include the v member of every vertex and
+ * the screen position of every vertex in front of the camera respectively.
+ */
+void projectVertices(const ProjectionParams & params, EERIE_VERTEX * vertices,
+                     size_t count, Vec3f & min3D, Vec3f & max3D,
+                     Vec2f & min2D, Vec2f & max2D);
+void projectVerticesReference(const ProjectionParams & params, EERIE_VERTEX * vertices,
+                              size_t count, Vec3f & min3D, Vec3f & max3D,
+                              Vec2f & min2D, Vec2f & max2D);
+
+} // namespace vertexkernels
+
+#endif // ARX_GRAPHICS_DATA_VERTEXKERNELS_H
@@ -22,6 +22,7 @@
 #include <sstream>
 #include <cstring>
 
+#include "graphics/image/ImageKernels.h"
 #include "graphics/image/stb_image.h"
 #include "graphics/image/stb_image_write.h"
 
@@ -241,6 +242,24 @@ bool Image::LoadFromMemory(void * pData, unsigned int size, const char * file) {
 	return (mData != NULL);
 }
 
+bool Image::GetInfo(const void * pData, unsigned int size,
+                    unsigned int & width, unsigned int & height) {
+	
+	if(!pData) {
+		return false;
+	}
+	
+	int w, h, bpp, fmt;
+	if(!stbi::stbi_info_from_memory((const stbi::stbi_uc*)pData, size, &w, &h, &bpp, &fmt)) {
+		return false;
+	}
+	
+	width = w;
+	height = h;
+	
+	return true;
+}
+
 void Image::Create(unsigned int pWidth, unsigned int pHeight, Image::Format pFormat, unsigned int pNumMipmaps, unsigned int pDepth) {
 	
 	arx_assert_msg(pWidth > 0, "[Image::Create] Width is 0!");
@@ -299,60 +318,16 @@ bool Image::ConvertTo(Image::Format format) {
 }
 
 // creates an image of the desired size and rescales the source into it
-// performs only nearest-neighbour interpolation of the image
+// averages all source pixels covered by a destination pixel
 // supports only RGB format
-void Image::ResizeFrom(const Image &source, unsigned int desired_width, unsigned int desired_height, bool flip_vertical)
-{
+void Image::ResizeFrom(const Image &source, unsigned int desired_width, unsigned int desired_height, bool flip_vertical) {
+	
+	arx_assert(source.GetFormat() == Format_R8G8B8 || source.GetFormat() == Format_B8G8R8);
+	
 	Create(desired_width, desired_height, Format_R8G8B8);
-
-	// span, size of one line in pixels (doesn't allow for byte padding)
-	const unsigned int src_span = source.GetWidth();
-	const unsigned int dest_span = GetWidth();
-
-	// number of bytes per pixel
-	// since we assume RGB format, this is 3 for both source and destination
-	const unsigned int src_pixel = 3;
-	const unsigned int dest_pixel = 3;
-
-	// find fractional source y_delta
-	float y_source = 0.0f;
-	const float y_delta = source.GetHeight() / (float)GetHeight();
-
-	for (unsigned int y = 0; y < GetHeight(); y++)
-	{
-		// find pointer to the beginning of this destination line
-		unsigned char *dest_p = GetData() + (flip_vertical ? GetHeight() - 1 - y : y) * dest_span * dest_pixel;
-
-		// truncate y_source coordinate and premultiply by line width / span
-		const unsigned int src_y = (unsigned int)(y_source) * src_span;
-
-		// find fractional source x_delta
-		float x_source = 0.0f;
-		const float x_delta = source.GetWidth() / (float)GetWidth();
-
-		for (unsigned int x = 0; x < GetWidth(); x++)
-		{
-			// truncate x_source coordinate
-			const unsigned int src_x = (unsigned int)(x_source);
-
-			// find offset in bytes for the current source coordinate
-			const unsigned int src_offset = (src_x + src_y) * src_pixel;
-
-			// copy pixel from source to dest, assuming 24-bit format (RGB or BGR, etc)
-			dest_p[0] = source.GetData()[src_offset + 0];
-			dest_p[1] = source.GetData()[src_offset + 1];
-			dest_p[2] = source.GetData()[src_offset + 2];
-
-			// move destination pointer ahead by one pixel
-			dest_p += dest_pixel;
-
-			// increment fractional source coordinate by one destination pixel, horizontal
-			x_source += x_delta;
-		}
-
-		// increment fractional source coordinate by one destination pixel, vertical
-		y_source += y_delta;
-	}
+	
+	imagekernels::resize(source.GetData(), source.GetWidth(), source.GetHeight(),
+	                     GetData(), GetWidth(), GetHeight(), 3, flip_vertical);
 }
 
 void Image::Clear() {
@@ -420,101 +395,26 @@ void Image::QuakeGamma(float pGamma) {
 	//
 	// if the image has alpha == 1.0, those pixels will get no effect
 	// using a pGamma < 1.0 will have no effect
-
-	unsigned int numComponents = SIZE_TABLE[mFormat];
-	unsigned int size = mWidth * mHeight;
-	unsigned char * data = mData;
-	
-	const unsigned int MAX_COMPONENTS = 4;
-	const float COMPONENT_RANGE = 255.0f;
-	
-	float components[MAX_COMPONENTS];
 	
 	// Nothing to do in this case!
 	if(pGamma == 1.0f) {
 		return;
 	}
 	
-	// Go through every pixel in the image
-	for(unsigned int i = 0; i < size; i++, data += numComponents) {
-		
-		float max_component = 0.0f;
-		
-		for(unsigned int j = 0; j < numComponents; j++) {
-			
-			// scale the component's value
-			components[j] = float(data[j]) * pGamma;
-
-			// find the max component
-			max_component = std::max(max_component, components[j]);
-		}
-
-		if (max_component > COMPONENT_RANGE) {
-
-			float reciprocal = COMPONENT_RANGE / max_component;
-
-			for (unsigned int j = 0; j < numComponents; j++) {
-				
-				// normalize the components by max component value
-				components[j] *= reciprocal;
-				data[j] = (unsigned char)components[j];
-			}
-		} else {
-		
-			for (unsigned int j = 0; j < numComponents; j++) {
-				data[j] = (unsigned char)components[j];
-			}
-		}
-	}
+	imagekernels::quakeGamma(mData, SIZE_TABLE[mFormat], mWidth * mHeight, pGamma);
 }
 
 void Image::AdjustGamma(const float &v) {
 	
 	arx_assert_msg(!IsCompressed(), "[Image::ChangeGamma] Gamma change of compressed images not supported yet!");
 	arx_assert_msg(!IsVolume(), "[Image::ChangeGamma] Gamma change of volume images not supported yet!");
-	arx_assert_msg(v <= 1.0f, "BUG WARNING: If gamma values greater than 1.0 needed, should fix the way the calculations are optimized!");
-
-	unsigned int numComponents = SIZE_TABLE[mFormat];
-	unsigned int size = mWidth * mHeight;
-	unsigned char * data = mData;
-	
-	const float COMPONENT_RANGE = 255.0f;
 	
 	// Nothing to do in this case!
 	if (v == 1.0f) {
 		return;
 	}
-
-	// TODO: this table is stored statically meaning this isn't thread-safe :(
-	// only safe option would be thread local storage?
-	static const float fraction = 1.0f / COMPONENT_RANGE;
-	static float gamma_value = -1.0f;
-	static unsigned char gamma_table[256];
-	if (gamma_value != v) {
-		memset(gamma_table, 0, sizeof(gamma_table));
-		gamma_value = v;
-	}
 	
-	// Go through every pixel in the image
-	for(unsigned int i = 0; i < size; i++, data += numComponents) {
-		
-		for(unsigned int j = 0; j < numComponents; j++) {
-			
-			if (data[j])
-			{
-				const unsigned char i = data[j];
-
-				// check if we've put a non-zero value here
-				// will start to fail with low index and gamma values > 1.0
-				// gamma_table[0] should always == 0, so ignore it
-				if (!gamma_table[i]) {
-					gamma_table[i] = (unsigned char)(COMPONENT_RANGE * powf(i * fraction, v));
-				}
-
-				data[j] = gamma_table[i];
-			}
-		}
-	}
+	imagekernels::adjustGamma(mData, SIZE_TABLE[mFormat] * mWidth * mHeight, v);
 }
 
 void Image::ApplyThreshold(unsigned char threshold, int component_mask) {
@@ -539,17 +439,6 @@ void Image::ApplyThreshold(unsigned char threshold, int component_mask) {
 	}
 }
 
-inline static bool sample(const u8 * src, int w, int h, int x, int y, u8 * dst, Color key) {
-	if(x >= 0 && x < w && y >= 0 && y < h) {
-		const u8 * s = src + (y * w + x) * 3;
-		if(s[0] != key.r || s[1] != key.g || s[2] != key.b) {
-			dst[0] = s[0], dst[1] = s[1], dst[2] = s[2];
-			return true;
-		}
-	}
-	return false;
-}
-
 void Image::ApplyColorKeyToAlpha(Color key) {
 	
 	arx_assert_msg(!IsCompressed(), "ApplyColorKeyToAlpha Not supported for compressed textures!");
@@ -566,59 +455,14 @@ void Image::ApplyColorKeyToAlpha(Color key) {
 	
 	// For RGB or BGR textures, first check if an alpha channel is really needed,
 	// then create it if it's the case
-	
-	// Check if we've got pixels matching the color key
-	const u8 * img = mData;
-	bool needsAlphaChannel = false;
-	for(size_t i = 0; i < (mHeight * mHeight); i++, img += 3) {
-		if(img[0] == key.r && img[1] == key.g && img[2] == key.b) {
-			needsAlphaChannel = true;
-			break;
-		}
-	}
-	if(!needsAlphaChannel) {
+	if(!imagekernels::containsColor(mData, mWidth * mHeight, key)) {
 		return;
 	}
 	
-	// If we need to add an alpha channel
-	
-	// Create a temp buffer
+	// Fill temp image and apply color key to alpha channel
 	size_t dataSize = GetSizeWithMipmaps(Format_R8G8B8A8, mWidth, mHeight, mDepth, mNumMipmaps);
 	u8 * dataTemp = new unsigned char[dataSize];
-	
-	// Fill temp image and apply color key to alpha channel
-	u8 * dst = dataTemp;
-	img = mData;
-	for(size_t y = 0; y < mHeight; y++) {
-		for(size_t x = 0; x < mWidth; x++) {
-			
-			dst[3] = (img[0] == key.r && img[1] == key.g && img[2] == key.b) ? 0 : 0xff;
-			
-			if(dst[3]) {
-				
-				dst[0] = img[0];
-				dst[1] = img[1];
-				dst[2] = img[2];
-				
-			} else {
-				// For transparent pixels, use the color of an opaque bordering pixel,
-				// so that linear filtering won't produce black borders.
-				if(   !sample(mData, mWidth, mHeight, int(x)    , int(y) - 1, dst, key)
-				   && !sample(mData, mWidth, mHeight, int(x) + 1, int(y)    , dst, key)
-				   && !sample(mData, mWidth, mHeight, int(x)    , int(y) + 1, dst, key)
-				   && !sample(mData, mWidth, mHeight, int(x) - 1, int(y)    , dst, key)
-				   && !sample(mData, mWidth, mHeight, int(x) - 1, int(y) - 1, dst, key)
-				   && !sample(mData, mWidth, mHeight, int(x) + 1, int(y) - 1, dst, key)
-				   && !sample(mData, mWidth, mHeight, int(x) + 1, int(y) + 1, dst, key)
-				   && !sample(mData, mWidth, mHeight, int(x) - 1, int(y) + 1, dst, key)) {
-					dst[0] = dst[1] = dst[2] = 0;
-				}
-			}
-			
-			img += 3;
-			dst += 4;
-		}
-	}
+	imagekernels::applyColorKey(mData, dataTemp, mWidth, mHeight, key);
 	
 	// Swap data with temp data and ajust internal state
 	delete[] mData;
@@ -639,16 +483,8 @@ bool Image::ToGrayscale(Image::Format newFormat) {
 	unsigned int newSize = GetSizeWithMipmaps(newFormat, mWidth, mHeight, mDepth, mNumMipmaps);
 	unsigned char* newData = new unsigned char[newSize];
 	
-	unsigned char* src = mData;
-	unsigned char* dst = newData;
-	
-	for(unsigned int i = 0; i < newSize; i += dstNumChannels) {
-		unsigned char grayVal = (77 * src[0] + 151 * src[1] + 28 * src[2] + 128) >> 8;
-		for(int i = 0; i < dstNumChannels; i++)
-			dst[i] = grayVal;
-		src += srcNumChannels;
-		dst += dstNumChannels;
-	}
+	imagekernels::toGrayscale(mData, srcNumChannels, newData, dstNumChannels,
+	                          newSize / dstNumChannels);
 		
 	delete[] mData;
 	mData = newData;
@@ -743,104 +579,13 @@ bool Image::ToNormalMap() {
 	return true;
 }
 
-void Image::Blur(int radius)
-{
+void Image::Blur(int radius) {
+	
 	arx_assert_msg(!IsCompressed(), "Blur not yet supported for compressed textures!");
 	arx_assert_msg(!IsVolume(), "Blur not yet supported for 3d textures!");
 	arx_assert_msg(mNumMipmaps == 1, "Blur not yet supported for textures with mipmaps!");
-
-	// Create kernel and precompute multiplication table
-	int kernelSize = 1 + radius * 2;
-	int* kernel = new int[kernelSize];
-	int* mult = new int[kernelSize << 8];
-
-	memset(kernel, 0, kernelSize*sizeof(*kernel));
-	memset(mult, 0, (kernelSize << 8)*sizeof(*mult));
-
-	kernel[kernelSize - 1] = 0;
-	for(int i = 1; i< radius; i++) {
-		int szi = radius - i;
-		kernel[radius + i] = kernel[szi] = szi * szi;
-		for (int j = 0; j < 256; j++) {
-			mult[((radius+i) << 8) + j] = mult[(szi << 8) + j] = kernel[szi] * j;
-		}
-	}
-
-	kernel[radius]=radius*radius;
-	for (int j = 0; j < 256; j++) {
-		mult[(radius << 8) + j] = kernel[radius] * j;
-	}
-
-	// Split color channels into separated array to simplify handling of multiple image format...
-	// Could easilly be refactored
-	int numChannels = GetNumChannels();
-	unsigned char* channel[4] = {};
-	unsigned char* blurredChannel[4] = {};
-	for(int c = 0; c < numChannels; c++) {
-		channel[c] = new unsigned char[mWidth*mHeight];
-		blurredChannel[c] = new unsigned char[mWidth*mHeight];
-		for (unsigned int i=0; i < mWidth*mHeight; i++) {
-			channel[c][i] = mData[i*numChannels + c];
-		}
-	}
 	
-	// Blur horizontally using our separable kernel
-	int yi = 0;
-	for (int yl = 0; yl < (int)mHeight; yl++) {
-		for (int xl = 0; xl < (int)mWidth; xl++) {
-			int channelVals[4] = {0,0,0,0};
-			int sum=0;
-			int ri=xl-radius;
-			for (int i = 0; i < kernelSize; i++) {
-				int read = ri + i;
-				if (read >= 0 && read < (int)mWidth) {
-					read += yi;
-					for(int c = 0; c < numChannels; c++)
-						channelVals[c] += mult[(i << 8) + channel[c][read]];
-					sum += kernel[i];
-				}
-			}
-			ri = yi + xl;
-
-			for(int c = 0; c < numChannels; c++)
-				blurredChannel[c][ri] = channelVals[c] / sum;
-		}
-		yi += mWidth;
-	}
-
-	// Blur vertically using our separable kernel
-	yi = 0;
-	for (int yl = 0; yl < (int)mHeight; yl++) {
-		int ym = yl - radius;
-		int riw = ym * mWidth;
-		for (int xl = 0; xl < (int)mWidth; xl++) {
-			int channelVals[4] = {0,0,0,0};
-			int sum=0;
-			int ri = ym;
-			int read= xl + riw;
-			for (int i = 0; i < kernelSize; i++) {
-				if (ri >= 0 && ri < (int)mHeight){
-					for(int c = 0; c < numChannels; c++)
-						channelVals[c] += mult[(i << 8) + blurredChannel[c][read]];
-					sum += kernel[i];
-				}
-				ri++;
-				read += mWidth;
-			}
-
-			for(int c = 0; c < numChannels; c++)
-				mData[(xl + yi)*numChannels + c] = channelVals[c] / sum;
-		}
-		yi += mWidth;
-	}
-
-	// Clean up mess
-	for(int c = 0; c < numChannels; c++) {
-		delete[] channel[c];
-		delete[] blurredChannel[c];
-	}
-	delete[] kernel;
-	delete[] mult;
+	imagekernels::blur(mData, mWidth, mHeight, GetNumChannels(), radius);
 }
 
 void Image::SetAlpha(const Image& img, bool bInvertAlpha)
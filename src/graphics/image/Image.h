@@ -126,6 +126,10 @@ public:
 	static unsigned int	GetNumChannels(Format pFormat);
 	static bool IsCompressed(Format pFormat);
 	
+	//! Read the dimensions of an encoded image without decoding it.
+	static bool GetInfo(const void * pData, unsigned int size,
+	                    unsigned int & width, unsigned int & height);
+	
 private:
 	
 	void FlipY(unsigned char* pData, unsigned int pWidth, unsigned int pHeight, unsigned int pDepth);
@@ -0,0 +1,668 @@
+/*
+ * Copyright 2013 Arx Libertatis Team (see the AUTHORS file)
+ *
+ * This file is part of Arx Libertatis.
+ *
+ * Arx Libertatis is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Arx Libertatis is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Arx Libertatis.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "graphics/image/ImageKernels.h"
+
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+#include <vector>
+
+#ifdef ARX_HAVE_SSE2_IMAGE
+#include <emmintrin.h>
+#endif
+
+namespace imagekernels {
+
+namespace {
+
+inline u8 grayValue(const u8 * p) {
+	return u8((77 * p[0] + 151 * p[1] + 28 * p[2] + 128) >> 8);
+}
+
+inline bool isKey(const u8 * p, Color key) {
+	return p[0] == key.r && p[1] == key.g && p[2] == key.b;
+}
+
+inline bool sample(const u8 * src, int w, int h, int x, int y, u8 * dst, Color key) {
+	if(x >= 0 && x < w && y >= 0 && y < h) {
+		const u8 * s = src + (y * w + x) * 3;
+		if(!isKey(s, key)) {
+			dst[0] = s[0], dst[1] = s[1], dst[2] = s[2];
+			return true;
+		}
+	}
+	return false;
+}
+
+inline void applyColorKey(const u8 * src, u8 * dst, int w, int h, int x, int y,
+                          Color key) {
+	
+	const u8 * img = src + (y * w + x) * 3;
+	
+	if(!isKey(img, key)) {
+		dst[0] = img[0];
+		dst[1] = img[1];
+		dst[2] = img[2];
+		dst[3] = 0xff;
+		return;
+	}
+	
+	dst[3] = 0;
+	
+	// For transparent pixels, use the color of an opaque bordering pixel,
+	// so that linear filtering won't produce black borders.
+	if(   !sample(src, w, h, x    , y - 1, dst, key)
+	   && !sample(src, w, h, x + 1, y    , dst, key)
+	   && !sample(src, w, h, x    , y + 1, dst, key)
+	   && !sample(src, w, h, x - 1, y    , dst, key)
+	   && !sample(src, w, h, x - 1, y - 1, dst, key)
+	   && !sample(src, w, h, x + 1, y - 1, dst, key)
+	   && !sample(src, w, h, x + 1, y + 1, dst, key)
+	   && !sample(src, w, h, x - 1, y + 1, dst, key)) {
+		dst[0] = dst[1] = dst[2] = 0;
+	}
+}
+
+inline void quakeGammaPixel(u8 * data, size_t channels, float gamma) {
+	
+	const float COMPONENT_RANGE = 255.0f;
+	
+	float components[4];
+	float max_component = 0.0f;
+	for(size_t j = 0; j < channels; j++) {
+		components[j] = float(data[j]) * gamma;
+		max_component = std::max(max_component, components[j]);
+	}
+	
+	if(max_component > COMPONENT_RANGE) {
+		float reciprocal = COMPONENT_RANGE / max_component;
+		for(size_t j = 0; j < channels; j++) {
+			data[j] = u8(components[j] * reciprocal);
+		}
+	} else {
+		for(size_t j = 0; j < channels; j++) {
+			data[j] = u8(components[j]);
+		}
+	}
+}
+
+//! Source pixels contributing to one destination column
+struct ResizeSpan {
+	size_t first;
+	std::vector<u32> weights;
+};
+
+std::vector<int> getBlurKernel(int radius) {
+	
+	std::vector<int> kernel(1 + radius * 2, 0);
+	
+	for(int i = 1; i < radius; i++) {
+		int szi = radius - i;
+		kernel[radius + i] = kernel[szi] = szi * szi;
+	}
+	kernel[radius] = radius * radius;
+	
+	return kernel;
+}
+
+#ifdef ARX_HAVE_SSE2_IMAGE
+
+/*!
+ * Load four pixels with three or four channels into the 32-bit lanes of a register.
+ * Reads 16 bytes in both cases.
+ */
+inline __m128i loadPixels(const u8 * src, size_t channels) {
+	
+	__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+	if(channels == 4) {
+		return v;
+	}
+	
+	// Pixels start at byte offsets 0, 3, 6 and 9
+	__m128i p01 = _mm_unpacklo_epi32(v, _mm_srli_si128(v, 3));
+	__m128i p23 = _mm_unpacklo_epi32(_mm_srli_si128(v, 6), _mm_srli_si128(v, 9));
+	return _mm_unpacklo_epi64(p01, p23);
+}
+
+//! Convert four bytes to floats.
+inline __m128 loadFloats(const u8 * src) {
+	
+	int bytes;
+	std::memcpy(&bytes, src, sizeof(bytes));
+	
+	__m128i zero = _mm_setzero_si128();
+	__m128i v = _mm_unpacklo_epi8(_mm_cvtsi32_si128(bytes), zero);
+	return _mm_cvtepi32_ps(_mm_unpacklo_epi16(v, zero));
+}
+
+//! Convert sixteen bytes to floats.
+inline void loadFloats(const u8 * src, __m128 out[4]) {
+	
+	__m128i zero = _mm_setzero_si128();
+	__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+	
+	__m128i lo = _mm_unpacklo_epi8(v, zero);
+	__m128i hi = _mm_unpackhi_epi8(v, zero);
+	out[0] = _mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, zero));
+	out[1] = _mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, zero));
+	out[2] = _mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, zero));
+	out[3] = _mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, zero));
+}
+
+//! Truncate sixteen floats in the range [0, 255] to bytes.
+inline void storeFloats(u8 * dst, const __m128 in[4]) {
+	
+	__m128i lo = _mm_packs_epi32(_mm_cvttps_epi32(in[0]), _mm_cvttps_epi32(in[1]));
+	__m128i hi = _mm_packs_epi32(_mm_cvttps_epi32(in[2]), _mm_cvttps_epi32(in[3]));
+	_mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm_packus_epi16(lo, hi));
+}
+
+/*!
+ * Weighted sum of sixteen bytes from several rows or columns, divided by the sum of the weights.
+ * 
+ * All values are exactly representable as floats and the quotient is truncated,
+ * so this produces the same result as the integer version as long as
+ * sum * 255 < 2^24.
+ */
+inline void blurBytes(const u8 * src, ptrdiff_t step, const int * kernel, size_t count,
+                      __m128 sum, u8 * dst) {
+	
+	__m128 acc[4] = { _mm_setzero_ps(), _mm_setzero_ps(), _mm_setzero_ps(), _mm_setzero_ps() };
+	
+	for(size_t i = 0; i < count; i++, src += step) {
+		if(!kernel[i]) {
+			continue;
+		}
+		__m128 weight = _mm_set1_ps(float(kernel[i]));
+		__m128 values[4];
+		loadFloats(src, values);
+		for(size_t j = 0; j < 4; j++) {
+			acc[j] = _mm_add_ps(acc[j], _mm_mul_ps(values[j], weight));
+		}
+	}
+	
+	for(size_t j = 0; j < 4; j++) {
+		acc[j] = _mm_div_ps(acc[j], sum);
+	}
+	
+	storeFloats(dst, acc);
+}
+
+#endif // ARX_HAVE_SSE2_IMAGE
+
+} // anonymous namespace
+
+void toGrayscaleReference(const u8 * src, size_t srcChannels, u8 * dst, size_t dstChannels,
+                          size_t count) {
+	
+	for(size_t i = 0; i < count; i++, src += srcChannels, dst += dstChannels) {
+		u8 gray = grayValue(src);
+		for(size_t c = 0; c < dstChannels; c++) {
+			dst[c] = gray;
+		}
+	}
+}
+
+void toGrayscale(const u8 * src, size_t srcChannels, u8 * dst, size_t dstChannels,
+                 size_t count) {
+	
+	size_t i = 0;
+	
+#ifdef ARX_HAVE_SSE2_IMAGE
+	
+	if((srcChannels == 3 || srcChannels == 4) && (dstChannels == 1 || dstChannels == 2)) {
+		
+		const __m128i mask = _mm_set1_epi32(0xff);
+		const __m128i wr = _mm_set1_epi32(77);
+		const __m128i wg = _mm_set1_epi32(151);
+		const __m128i wb = _mm_set1_epi32(28);
+		const __m128i round = _mm_set1_epi32(128);
+		const __m128i bias32 = _mm_set1_epi32(0x8000);
+		const __m128i bias16 = _mm_set1_epi16(short(0x8000));
+		
+		// loadPixels() reads 16 bytes
+		for(; i + 4 <= count && (count - i) * srcChannels >= 16; i += 4) {
+			
+			__m128i p = loadPixels(src, srcChannels);
+			__m128i r = _mm_and_si128(p, mask);
+			__m128i g = _mm_and_si128(_mm_srli_epi32(p, 8), mask);
+			__m128i b = _mm_and_si128(_mm_srli_epi32(p, 16), mask);
+			
+			// The products fit into the low 16 bits of each lane
+			__m128i gray = _mm_add_epi32(_mm_mullo_epi16(r, wr), _mm_mullo_epi16(g, wg));
+			gray = _mm_add_epi32(gray, _mm_add_epi32(_mm_mullo_epi16(b, wb), round));
+			gray = _mm_srli_epi32(gray, 8);
+			
+			if(dstChannels == 1) {
+				__m128i packed = _mm_packs_epi32(gray, gray);
+				int bytes = _mm_cvtsi128_si32(_mm_packus_epi16(packed, packed));
+				std::memcpy(dst, &bytes, 4);
+			} else {
+				// Pack the 16-bit gray pairs without signed saturation
+				gray = _mm_sub_epi32(_mm_or_si128(gray, _mm_slli_epi32(gray, 8)), bias32);
+				__m128i packed = _mm_add_epi16(_mm_packs_epi32(gray, gray), bias16);
+				_mm_storel_epi64(reinterpret_cast<__m128i *>(dst), packed);
+			}
+			
+			src += 4 * srcChannels;
+			dst += 4 * dstChannels;
+		}
+	}
+	
+#endif // ARX_HAVE_SSE2_IMAGE
+	
+	toGrayscaleReference(src, srcChannels, dst, dstChannels, count - i);
+}
+
+bool containsColorReference(const u8 * src, size_t count, Color key) {
+	
+	for(size_t i = 0; i < count; i++, src += 3) {
+		if(isKey(src, key)) {
+			return true;
+		}
+	}
+	
+	return false;
+}
+
+bool containsColor(const u8 * src, size_t count, Color key) {
+	
+	size_t i = 0;
+	
+#ifdef ARX_HAVE_SSE2_IMAGE
+	
+	const __m128i mask = _mm_set1_epi32(0xffffff);
+	const __m128i color = _mm_set1_epi32(key.r | (key.g << 8) | (key.b << 16));
+	
+	for(; i + 6 <= count; i += 4, src += 12) {
+		__m128i p = _mm_and_si128(loadPixels(src, 3), mask);
+		if(_mm_movemask_epi8(_mm_cmpeq_epi32(p, color))) {
+			return true;
+		}
+	}
+	
+#endif // ARX_HAVE_SSE2_IMAGE
+	
+	return containsColorReference(src, count - i, key);
+}
+
+void applyColorKeyReference(const u8 * src, u8 * dst, size_t width, size_t height,
+                            Color key) {
+	
+	for(size_t y = 0; y < height; y++) {
+		for(size_t x = 0; x < width; x++, dst += 4) {
+			applyColorKey(src, dst, int(width), int(height), int(x), int(y), key);
+		}
+	}
+}
+
+void applyColorKey(const u8 * src, u8 * dst, size_t width, size_t height, Color key) {
+	
+#ifdef ARX_HAVE_SSE2_IMAGE
+	
+	const __m128i mask = _mm_set1_epi32(0xffffff);
+	const __m128i alpha = _mm_set1_epi32(0xff000000);
+	const __m128i color = _mm_set1_epi32(key.r | (key.g << 8) | (key.b << 16));
+	
+	const size_t count = width * height;
+	
+	for(size_t y = 0; y < height; y++) {
+		
+		size_t x = 0;
+		
+		// Opaque pixels only need an alpha channel - loadPixels() reads 16 bytes
+		const u8 * row = src + y * width * 3;
+		for(; x + 4 <= width && count - (y * width + x) >= 6; x += 4, row += 12, dst += 16) {
+			
+			__m128i p = _mm_and_si128(loadPixels(row, 3), mask);
+			
+			if(_mm_movemask_epi8(_mm_cmpeq_epi32(p, color))) {
+				for(size_t i = 0; i < 4; i++) {
+					applyColorKey(src, dst + i * 4, int(width), int(height), int(x + i), int(y), key);
+				}
+			} else {
+				_mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm_or_si128(p, alpha));
+			}
+		}
+		
+		for(; x < width; x++, dst += 4) {
+			applyColorKey(src, dst, int(width), int(height), int(x), int(y), key);
+		}
+	}
+	
+#else
+	
+	applyColorKeyReference(src, dst, width, height, key);
+	
+#endif // ARX_HAVE_SSE2_IMAGE
+}
+
+void quakeGammaReference(u8 * data, size_t channels, size_t count, float gamma) {
+	
+	for(size_t i = 0; i < count; i++, data += channels) {
+		quakeGammaPixel(data, channels, gamma);
+	}
+}
+
+void quakeGamma(u8 * data, size_t channels, size_t count, float gamma) {
+	
+#ifdef ARX_HAVE_SSE2_IMAGE
+	
+	if(channels > 4) {
+		quakeGammaReference(data, channels, count, gamma);
+		return;
+	}
+	
+	const __m128 range = _mm_set1_ps(255.0f);
+	const __m128 scale = _mm_set1_ps(gamma);
+	const __m128i zero = _mm_setzero_si128();
+	
+	size_t i = 0;
+	
+	if(channels == 4) {
+		
+		// Four pixels at once, transposed so that each register holds one channel
+		for(; i + 4 <= count; i += 4, data += 16) {
+			
+			__m128 c[4];
+			loadFloats(data, c);
+			_MM_TRANSPOSE4_PS(c[0], c[1], c[2], c[3]);
+			
+			for(size_t j = 0; j < 4; j++) {
+				c[j] = _mm_mul_ps(c[j], scale);
+			}
+			
+			__m128 m = _mm_max_ps(_mm_max_ps(c[0], c[1]), _mm_max_ps(c[2], c[3]));
+			__m128 saturated = _mm_cmpgt_ps(m, range);
+			if(_mm_movemask_ps(saturated)) {
+				// The reciprocal is exactly one for the other pixels, leaving them unchanged
+				__m128 divisor = _mm_or_ps(_mm_and_ps(saturated, m), _mm_andnot_ps(saturated, range));
+				__m128 reciprocal = _mm_div_ps(range, divisor);
+				for(size_t j = 0; j < 4; j++) {
+					c[j] = _mm_mul_ps(c[j], reciprocal);
+				}
+			}
+			
+			_MM_TRANSPOSE4_PS(c[0], c[1], c[2], c[3]);
+			storeFloats(data, c);
+		}
+	}
+	
+	// One pixel per register: unused lanes are zero and don't affect the maximum
+	for(; i < count; i++, data += channels) {
+		
+		int bytes = 0;
+		std::memcpy(&bytes, data, channels);
+		
+		__m128i p = _mm_unpacklo_epi8(_mm_cvtsi32_si128(bytes), zero);
+		__m128 c = _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(p, zero)), scale);
+		
+		__m128 m = _mm_max_ps(c, _mm_shuffle_ps(c, c, _MM_SHUFFLE(2, 3, 0, 1)));
+		m = _mm_max_ps(m, _mm_shuffle_ps(m, m, _MM_SHUFFLE(1, 0, 3, 2)));
+		
+		if(_mm_comigt_ss(m, range)) {
+			c = _mm_mul_ps(c, _mm_div_ps(range, m));
+		}
+		
+		__m128i r = _mm_cvttps_epi32(c);
+		r = _mm_packs_epi32(r, r);
+		bytes = _mm_cvtsi128_si32(_mm_packus_epi16(r, r));
+		std::memcpy(data, &bytes, channels);
+	}
+	
+#else
+	
+	quakeGammaReference(data, channels, count, gamma);
+	
+#endif // ARX_HAVE_SSE2_IMAGE
+}
+
+void adjustGamma(u8 * data, size_t size, float gamma) {
+	
+	u8 table[256];
+	table[0] = 0;
+	for(size_t i = 1; i < 256; i++) {
+		table[i] = u8(255.0f * std::pow(float(i) * (1.0f / 255.0f), gamma));
+	}
+	
+	for(size_t i = 0; i < size; i++) {
+		data[i] = table[data[i]];
+	}
+}
+
+void blurReference(u8 * data, size_t width, size_t height, size_t channels, int radius) {
+	
+	if(radius < 1) {
+		return;
+	}
+	
+	std::vector<int> kernel = getBlurKernel(radius);
+	int kernelSize = int(kernel.size());
+	int w = int(width), h = int(height), c = int(channels);
+	
+	std::vector<u8> blurred(width * height * channels);
+	
+	// Blur horizontally
+	for(int y = 0; y < h; y++) {
+		for(int x = 0; x < w; x++) {
+			for(int ch = 0; ch < c; ch++) {
+				int acc = 0, sum = 0;
+				for(int i = 0; i < kernelSize; i++) {
+					int read = x - radius + i;
+					if(read >= 0 && read < w) {
+						acc += kernel[i] * data[(y * w + read) * c + ch];
+						sum += kernel[i];
+					}
+				}
+				blurred[(y * w + x) * c + ch] = u8(acc / sum);
+			}
+		}
+	}
+	
+	// Blur vertically
+	for(int y = 0; y < h; y++) {
+		for(int x = 0; x < w; x++) {
+			for(int ch = 0; ch < c; ch++) {
+				int acc = 0, sum = 0;
+				for(int i = 0; i < kernelSize; i++) {
+					int read = y - radius + i;
+					if(read >= 0 && read < h) {
+						acc += kernel[i] * blurred[(read * w + x) * c + ch];
+						sum += kernel[i];
+					}
+				}
+				data[(y * w + x) * c + ch] = u8(acc / sum);
+			}
+		}
+	}
+}
+
+void blur(u8 * data, size_t width, size_t height, size_t channels, int radius) {
+	
+	if(radius < 1 || !width || !height) {
+		return;
+	}
+	
+	const std::vector<int> kernel = getBlurKernel(radius);
+	const size_t kernelSize = kernel.size();
+	const size_t r = size_t(radius);
+	const size_t stride = width * channels;
+	
+	int total = 0;
+	for(size_t i = 0; i < kernelSize; i++) {
+		total += kernel[i];
+	}
+	
+#ifdef ARX_HAVE_SSE2_IMAGE
+	// See blurBytes()
+	const bool simd = (total * 255 < (1 << 24));
+#endif
+	
+	std::vector<u8> blurred(stride * height);
+	
+	// Blur horizontally - pixels that are at least radius away from the left and
+	// right edges use the whole kernel, process the channels of those together
+	for(size_t y = 0; y < height; y++) {
+		
+		const u8 * src = data + y * stride;
+		u8 * dst = &blurred[y * stride];
+		
+		size_t begin = std::min(r, width) * channels;
+		size_t end = (width > r) ? (width - r) * channels : 0;
+		size_t b = 0;
+		
+		for(; b < stride; b++) {
+			
+			if(b == begin && begin < end) {
+				
+#ifdef ARX_HAVE_SSE2_IMAGE
+				if(simd) {
+					__m128 sum = _mm_set1_ps(float(total));
+					for(; b + 16 <= end; b += 16) {
+						blurBytes(src + b - r * channels, ptrdiff_t(channels), &kernel[0],
+						          kernelSize, sum, dst + b);
+					}
+				}
+#endif
+				
+				for(; b < end; b++) {
+					int acc = 0;
+					const u8 * read = src + b - r * channels;
+					for(size_t i = 0; i < kernelSize; i++, read += channels) {
+						acc += kernel[i] * *read;
+					}
+					dst[b] = u8(acc / total);
+				}
+				
+				if(b == stride) {
+					break;
+				}
+			}
+			
+			size_t x = b / channels;
+			int acc = 0, sum = 0;
+			for(size_t i = 0; i < kernelSize; i++) {
+				if(x + i >= r && x + i - r < width) {
+					acc += kernel[i] * src[b + i * channels - r * channels];
+					sum += kernel[i];
+				}
+			}
+			dst[b] = u8(acc / sum);
+		}
+	}
+	
+	// Blur vertically - all bytes in a row use the same part of the kernel
+	for(size_t y = 0; y < height; y++) {
+		
+		size_t first = (y < r) ? r - y : 0;
+		size_t last = std::min(kernelSize, height + r - y);
+		
+		int sum = 0;
+		for(size_t i = first; i < last; i++) {
+			sum += kernel[i];
+		}
+		
+		const u8 * src = &blurred[(y + first - r) * stride];
+		u8 * dst = data + y * stride;
+		size_t b = 0;
+		
+#ifdef ARX_HAVE_SSE2_IMAGE
+		if(simd) {
+			__m128 vsum = _mm_set1_ps(float(sum));
+			for(; b + 16 <= stride; b += 16) {
+				blurBytes(src + b, ptrdiff_t(stride), &kernel[first], last - first, vsum, dst + b);
+			}
+		}
+#endif
+		
+		for(; b < stride; b++) {
+			int acc = 0;
+			const u8 * read = src + b;
+			for(size_t i = first; i < last; i++, read += stride) {
+				acc += kernel[i] * *read;
+			}
+			dst[b] = u8(acc / sum);
+		}
+	}
+}
+
+void resize(const u8 * src, size_t srcWidth, size_t srcHeight,
+            u8 * dst, size_t dstWidth, size_t dstHeight, size_t channels, bool flip) {
+	
+	if(!srcWidth || !srcHeight || !dstWidth || !dstHeight) {
+		return;
+	}
+	
+	// Destination pixel x covers [x * srcWidth, (x + 1) * srcWidth) and source pixel s
+	// covers [s * dstWidth, (s + 1) * dstWidth) - the overlap is the weight of the source pixel.
+	std::vector<ResizeSpan> columns(dstWidth);
+	for(size_t x = 0; x < dstWidth; x++) {
+		u64 begin = u64(x) * srcWidth, end = begin + srcWidth;
+		columns[x].first = size_t(begin / dstWidth);
+		for(u64 s = columns[x].first; s * dstWidth < end; s++) {
+			u64 overlap = std::min((s + 1) * dstWidth, end) - std::max(s * dstWidth, begin);
+			columns[x].weights.push_back(u32(overlap));
+		}
+	}
+	
+	// Horizontal pass - each value is at most srcWidth * 255
+	const size_t stride = dstWidth * channels;
+	std::vector<u32> rows(srcHeight * stride);
+	for(size_t y = 0; y < srcHeight; y++) {
+		const u8 * in = src + y * srcWidth * channels;
+		u32 * out = &rows[y * stride];
+		for(size_t x = 0; x < dstWidth; x++, out += channels) {
+			const ResizeSpan & span = columns[x];
+			const u8 * pixel = in + span.first * channels;
+			for(size_t c = 0; c < channels; c++) {
+				out[c] = 0;
+			}
+			for(size_t i = 0; i < span.weights.size(); i++, pixel += channels) {
+				for(size_t c = 0; c < channels; c++) {
+					out[c] += span.weights[i] * pixel[c];
+				}
+			}
+		}
+	}
+	
+	// Vertical pass
+	const u64 total = u64(srcWidth) * srcHeight;
+	std::vector<u64> acc(stride);
+	for(size_t y = 0; y < dstHeight; y++) {
+		
+		u64 begin = u64(y) * srcHeight, end = begin + srcHeight;
+		
+		std::fill(acc.begin(), acc.end(), 0);
+		for(u64 s = begin / dstHeight; s * dstHeight < end; s++) {
+			u64 weight = std::min((s + 1) * dstHeight, end) - std::max(s * dstHeight, begin);
+			const u32 * row = &rows[size_t(s) * stride];
+			for(size_t b = 0; b < stride; b++) {
+				acc[b] += weight * row[b];
+			}
+		}
+		
+		u8 * out = dst + (flip ? dstHeight - 1 - y : y) * stride;
+		for(size_t b = 0; b < stride; b++) {
+			out[b] = u8((acc[b] + total / 2) / total);
+		}
+	}
+}
+
+} // namespace imagekernels
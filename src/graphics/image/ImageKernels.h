@@ -0,0 +1,91 @@
+/*
+ * Copyright 2013 Arx Libertatis Team (see the AUTHORS file)
+ *
+ * This file is part of Arx Libertatis.
+ *
+ * Arx Libertatis is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Arx Libertatis is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Arx Libertatis.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ARX_GRAPHICS_IMAGE_IMAGEKERNELS_H
+#define ARX_GRAPHICS_IMAGE_IMAGEKERNELS_H
+
+#include <stddef.h>
+
+#include "graphics/Color.h"
+#include "platform/Platform.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ARX_HAVE_SSE2_IMAGE 1
+#endif
+
+/*!
+ * Pixel processing loops used by the Image class.
+ * 
+ * The kernels operate on tightly packed, uncompressed pixel data.
+ * Where SSE2 is available, they process several pixels at once. The results
+ * are always bit-identical to the straightforward *Reference() versions,
+ * which are kept for testing.
+ */
+namespace imagekernels {
+
+/*!
+ * Convert pixels with at least three channels to gray.
+ * All channels of the destination pixels are set to the gray value.
+ */
+void toGrayscale(const u8 * src, size_t srcChannels, u8 * dst, size_t dstChannels,
+                 size_t count);
+void toGrayscaleReference(const u8 * src, size_t srcChannels, u8 * dst, size_t dstChannels,
+                          size_t count);
+
+//! Check if any pixel of three-channel data matches the key.
+bool containsColor(const u8 * src, size_t count, Color key);
+bool containsColorReference(const u8 * src, size_t count, Color key);
+
+/*!
+ * Expand three-channel data to four channels, making pixels that match the
+ * key transparent. Transparent pixels take the color of an opaque neighbor so
+ * that linear filtering won't produce dark borders.
+ */
+void applyColorKey(const u8 * src, u8 * dst, size_t width, size_t height, Color key);
+void applyColorKeyReference(const u8 * src, u8 * dst, size_t width, size_t height,
+                            Color key);
+
+/*!
+ * Scale the color components by gamma, normalizing pixels that would saturate
+ * by their largest component to preserve chroma.
+ */
+void quakeGamma(u8 * data, size_t channels, size_t count, float gamma);
+void quakeGammaReference(u8 * data, size_t channels, size_t count, float gamma);
+
+//! Apply a power curve to every byte.
+void adjustGamma(u8 * data, size_t size, float gamma);
+
+/*!
+ * Blur an image with a separable kernel with quadratic falloff.
+ * Pixels outside of the image are ignored.
+ */
+void blur(u8 * data, size_t width, size_t height, size_t channels, int radius);
+void blurReference(u8 * data, size_t width, size_t height, size_t channels, int radius);
+
+/*!
+ * Resize an image, averaging all source pixels covered by each destination
+ * pixel weighted by the covered area.
+ * @param flip store the rows of the destination image in reverse order.
+ */
+void resize(const u8 * src, size_t srcWidth, size_t srcHeight,
+            u8 * dst, size_t dstWidth, size_t dstHeight, size_t channels, bool flip);
+
+} // namespace imagekernels
+
+#endif // ARX_GRAPHICS_IMAGE_IMAGEKERNELS_H
@@ -0,0 +1,295 @@
+/*
+ * Copyright 2013 Arx Libertatis Team (see the AUTHORS file)
+ *
+ * This file is part of Arx Libertatis.
+ *
+ * Arx Libertatis is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Arx Libertatis is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Arx Libertatis.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "graphics/null/NullRenderer.h"
+
+#include <cstring>
+
+#include "core/Application.h"
+#include "graphics/Vertex.h"
+#include "graphics/image/Image.h"
+#include "graphics/null/NullTexture2D.h"
+#include "graphics/null/NullVertexBuffer.h"
+#include "io/log/Logger.h"
+#include "platform/CrashHandler.h"
+#include "window/RenderWindow.h"
+
+static const size_t NullTextureStageCount = 4;
+
+static const char * const primitiveNames[] = {
+	"TriangleList",
+	"TriangleStrip",
+	"TriangleFan",
+	"LineList",
+	"LineStrip"
+};
+
+static size_t getPrimitiveCount(Renderer::Primitive primitive, size_t count) {
+	switch(primitive) {
+		case Renderer::TriangleList: return count / 3;
+		case Renderer::TriangleStrip: return (count < 3) ? 0 : count - 2;
+		case Renderer::TriangleFan: return (count < 3) ? 0 : count - 2;
+		case Renderer::LineList: return count / 2;
+		case Renderer::LineStrip: return (count < 2) ? 0 : count - 1;
+	}
+	return 0;
+}
+
+void NullRenderer::Stats::reset() {
+	frames = 0;
+	drawCalls = 0;
+	primitives = 0;
+	vertices = 0;
+	stateChanges = 0;
+	textureChanges = 0;
+	textureUploads = 0;
+	bytesUploaded = 0;
+}
+
+NullRenderer::NullRenderer() : commandLog(NULL), viewport(Rect::ZERO) {
+	view.setToIdentity();
+	projection.setToIdentity();
+}
+
+NullRenderer::~NullRenderer() {
+	
+	if(stats.frames) {
+		LogInfo << "Null renderer: " << stats.frames << " frames, "
+		        << (stats.drawCalls / stats.frames) << " draw calls, "
+		        << (stats.primitives / stats.frames) << " primitives, "
+		        << (stats.stateChanges / stats.frames) << " state changes, "
+		        << (stats.textureChanges / stats.frames) << " texture changes and "
+		        << (stats.bytesUploaded / stats.frames) << " bytes uploaded per frame";
+	}
+	
+}
+
+void NullRenderer::Initialize() {
+	
+	LogInfo << "Using null renderer";
+	CrashHandler::setVariable("Renderer", "null");
+	
+	m_TextureStages.resize(NullTextureStageCount, NULL);
+	for(size_t i = 0; i < m_TextureStages.size(); ++i) {
+		m_TextureStages[i] = new NullTextureStage(this, i);
+	}
+	
+}
+
+void NullRenderer::BeginScene() {
+	recordStateChange("BeginScene", 0);
+}
+
+void NullRenderer::EndScene() {
+	recordStateChange("EndScene", 0);
+}
+
+void NullRenderer::SetViewMatrix(const EERIEMATRIX & matView) {
+	if(memcmp(&view, &matView, sizeof(EERIEMATRIX))) {
+		view = matView;
+		recordStateChange("SetViewMatrix", 0);
+	}
+}
+
+void NullRenderer::GetViewMatrix(EERIEMATRIX & matView) const {
+	matView = view;
+}
+
+void NullRenderer::SetProjectionMatrix(const EERIEMATRIX & matProj) {
+	if(memcmp(&projection, &matProj, sizeof(EERIEMATRIX))) {
+		projection = matProj;
+		recordStateChange("SetProjectionMatrix", 0);
+	}
+}
+
+void NullRenderer::GetProjectionMatrix(EERIEMATRIX & matProj) const {
+	matProj = projection;
+}
+
+Texture2D * NullRenderer::CreateTexture2D() {
+	return new NullTexture2D(this);
+}
+
+void NullRenderer::SetRenderState(RenderState renderState, bool enable) {
+	recordStateChange("SetRenderState", (int(renderState) << 1) | (enable ? 1 : 0));
+}
+
+void NullRenderer::SetAlphaFunc(PixelCompareFunc func, float fef) {
+	ARX_UNUSED(fef);
+	recordStateChange("SetAlphaFunc", func);
+}
+
+void NullRenderer::SetBlendFunc(PixelBlendingFactor srcFactor, PixelBlendingFactor dstFactor) {
+	recordStateChange("SetBlendFunc", (int(srcFactor) << 8) | int(dstFactor));
+}
+
+void NullRenderer::SetViewport(const Rect & _viewport) {
+	viewport = _viewport;
+	recordStateChange("SetViewport", 0);
+}
+
+Rect NullRenderer::GetViewport() {
+	return viewport;
+}
+
+void NullRenderer::Begin2DProjection(float left, float right, float bottom, float top, float zNear, float zFar) {
+	ARX_UNUSED(left), ARX_UNUSED(right), ARX_UNUSED(bottom), ARX_UNUSED(top);
+	ARX_UNUSED(zNear), ARX_UNUSED(zFar);
+	recordStateChange("Begin2DProjection", 0);
+}
+
+void NullRenderer::End2DProjection() {
+	recordStateChange("End2DProjection", 0);
+}
+
+void NullRenderer::Clear(BufferFlags bufferFlags, Color clearColor, float clearDepth, size_t nrects, Rect * rect) {
+	ARX_UNUSED(clearColor), ARX_UNUSED(clearDepth), ARX_UNUSED(rect);
+	recordStateChange("Clear", int(bufferFlags) | int(nrects << 8));
+}
+
+void NullRenderer::SetFogColor(Color color) {
+	ARX_UNUSED(color);
+	recordStateChange("SetFogColor", 0);
+}
+
+void NullRenderer::SetFogParams(FogMode fogMode, float fogStart, float fogEnd, float fogDensity) {
+	ARX_UNUSED(fogStart), ARX_UNUSED(fogEnd), ARX_UNUSED(fogDensity);
+	recordStateChange("SetFogParams", fogMode);
+}
+
+void NullRenderer::SetAntialiasing(bool enable) {
+	recordStateChange("SetAntialiasing", enable);
+}
+
+void NullRenderer::SetCulling(CullingMode mode) {
+	recordStateChange("SetCulling", mode);
+}
+
+void NullRenderer::SetDepthBias(int depthBias) {
+	recordStateChange("SetDepthBias", depthBias);
+}
+
+void NullRenderer::SetFillMode(FillMode mode) {
+	recordStateChange("SetFillMode", mode);
+}
+
+void NullRenderer::DrawTexturedRect(float x, float y, float w, float h, float uStart, float vStart, float uEnd, float vEnd, Color color) {
+	ARX_UNUSED(x), ARX_UNUSED(y), ARX_UNUSED(w), ARX_UNUSED(h);
+	ARX_UNUSED(uStart), ARX_UNUSED(vStart), ARX_UNUSED(uEnd), ARX_UNUSED(vEnd);
+	ARX_UNUSED(color);
+	recordDraw("DrawTexturedRect", TriangleFan, 4, 0);
+}
+
+VertexBuffer<TexturedVertex> * NullRenderer::createVertexBufferTL(size_t capacity, BufferUsage usage) {
+	ARX_UNUSED(usage);
+	return new NullVertexBuffer<TexturedVertex>(this, capacity);
+}
+
+VertexBuffer<SMY_VERTEX> * NullRenderer::createVertexBuffer(size_t capacity, BufferUsage usage) {
+	ARX_UNUSED(usage);
+	return new NullVertexBuffer<SMY_VERTEX>(this, capacity);
+}
+
+VertexBuffer<SMY_VERTEX3> * NullRenderer::createVertexBuffer3(size_t capacity, BufferUsage usage) {
+	ARX_UNUSED(usage);
+	return new NullVertexBuffer<SMY_VERTEX3>(this, capacity);
+}
+
+void NullRenderer::drawIndexed(Primitive primitive, const TexturedVertex * vertices, size_t nvertices, unsigned short * indices, size_t nindices) {
+	ARX_UNUSED(vertices), ARX_UNUSED(indices);
+	recordUpload("drawIndexed", nvertices * sizeof(TexturedVertex) + nindices * sizeof(*indices));
+	recordDraw("drawIndexed", primitive, nvertices, nindices);
+}
+
+bool NullRenderer::getSnapshot(Image & image) {
+	
+	Vec2i size = mainApp->getWindow()->getSize();
+	
+	image.Create(size.x, size.y, Image::Format_R8G8B8);
+	memset(image.GetData(), 0, image.GetDataSize());
+	
+	return true;
+}
+
+bool NullRenderer::getSnapshot(Image & image, size_t width, size_t height) {
+	
+	image.Create(width, height, Image::Format_R8G8B8);
+	memset(image.GetData(), 0, image.GetDataSize());
+	
+	return true;
+}
+
+void NullRenderer::endFrame() {
+	
+	stats.frames++;
+	
+	if(commandLog) {
+		*commandLog << "-- frame " << stats.frames << '\n';
+	}
+}
+
+void NullRenderer::recordDraw(const char * command, Primitive primitive, size_t nvertices, size_t nindices) {
+	
+	size_t count = nindices ? nindices : nvertices;
+	
+	stats.drawCalls++;
+	stats.vertices += nvertices;
+	stats.primitives += getPrimitiveCount(primitive, count);
+	
+	if(commandLog) {
+		*commandLog << command << ' ' << primitiveNames[primitive] << ' ' << nvertices
+		            << ' ' << nindices << '\n';
+	}
+}
+
+void NullRenderer::recordStateChange(const char * command, int value) {
+	
+	stats.stateChanges++;
+	
+	if(commandLog) {
+		*commandLog << command << ' ' << value << '\n';
+	}
+}
+
+void NullRenderer::recordTextureChange(unsigned stage, const Texture * texture) {
+	
+	stats.textureChanges++;
+	
+	if(commandLog) {
+		*commandLog << "SetTexture " << stage << ' ' << texture << '\n';
+	}
+}
+
+void NullRenderer::recordUpload(const char * command, size_t bytes) {
+	
+	if(!bytes) {
+		return;
+	}
+	
+	stats.bytesUploaded += bytes;
+	
+	if(commandLog) {
+		*commandLog << command << ' ' << bytes << '\n';
+	}
+}
+
+void NullRenderer::recordTextureUpload(size_t bytes) {
+	stats.textureUploads++;
+	recordUpload("Texture2D::Upload", bytes);
+}
@@ -0,0 +1,146 @@
+/*
+ * Copyright 2013 Arx Libertatis Team (see the AUTHORS file)
+ *
+ * This file is part of Arx Libertatis.
+ *
+ * Arx Libertatis is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Arx Libertatis is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Arx Libertatis.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ARX_GRAPHICS_NULL_NULLRENDERER_H
+#define ARX_GRAPHICS_NULL_NULLRENDERER_H
+
+#include <ostream>
+
+#include "graphics/BaseGraphicsTypes.h"
+#include "graphics/Renderer.h"
+#include "math/Rectangle.h"
+#include "platform/Platform.h"
+
+/*!
+ * Renderer that draws nothing and only records what would have been drawn.
+ * 
+ * Used to measure the CPU side of rendering on machines without a GPU.
+ * All draw calls, primitives, state changes and uploaded bytes are counted,
+ * and every command can optionally be written to a log stream.
+ */
+class NullRenderer : public Renderer {
+	
+public:
+	
+	struct Stats {
+		
+		u64 frames;
+		u64 drawCalls;
+		u64 primitives;
+		u64 vertices;
+		u64 stateChanges;
+		u64 textureChanges;
+		u64 textureUploads;
+		u64 bytesUploaded;
+		
+		Stats() { reset(); }
+		void reset();
+		
+	};
+	
+	NullRenderer();
+	~NullRenderer();
+	
+	void Initialize();
+	
+	// Scene begin/end...
+	void BeginScene();
+	void EndScene();
+	
+	// Matrices
+	void SetViewMatrix(const EERIEMATRIX & matView);
+	void GetViewMatrix(EERIEMATRIX & matView) const;
+	void SetProjectionMatrix(const EERIEMATRIX & matProj);
+	void GetProjectionMatrix(EERIEMATRIX & matProj) const;
+	
+	// Factory
+	Texture2D * CreateTexture2D();
+	
+	// Render states
+	void SetRenderState(RenderState renderState, bool enable);
+	
+	// Alphablending & Transparency
+	void SetAlphaFunc(PixelCompareFunc func, float fef); // Ref = [0.0f, 1.0f]
+	void SetBlendFunc(PixelBlendingFactor srcFactor, PixelBlendingFactor dstFactor);
+	
+	// Viewport
+	void SetViewport(const Rect & viewport);
+	Rect GetViewport();
+	
+	// Projection
+	void Begin2DProjection(float left, float right, float bottom, float top, float zNear, float zFar);
+	void End2DProjection();
+	
+	// Render Target
+	void Clear(BufferFlags bufferFlags, Color clearColor = Color::none, float clearDepth = 1.f, size_t nrects = 0, Rect * rect = 0);
+	
+	// Fog
+	void SetFogColor(Color color);
+	void SetFogParams(FogMode fogMode, float fogStart, float fogEnd, float fogDensity = 1.0f);
+	bool isFogInEyeCoordinates() { return false; }
+	
+	// Rasterizer
+	void SetAntialiasing(bool enable);
+	void SetCulling(CullingMode mode);
+	void SetDepthBias(int depthBias);
+	void SetFillMode(FillMode mode);
+	
+	float GetMaxAnisotropy() const { return 1.f; }
+	
+	// Utilities...
+	void DrawTexturedRect(float x, float y, float w, float h, float uStart, float vStart, float uEnd, float vEnd, Color color);
+	
+	VertexBuffer<TexturedVertex> * createVertexBufferTL(size_t capacity, BufferUsage usage);
+	VertexBuffer<SMY_VERTEX> * createVertexBuffer(size_t capacity, BufferUsage usage);
+	VertexBuffer<SMY_VERTEX3> * createVertexBuffer3(size_t capacity, BufferUsage usage);
+	
+	void drawIndexed(Primitive primitive, const TexturedVertex * vertices, size_t nvertices, unsigned short * indices, size_t nindices);
+	
+	//! Produce a black image with the size of the window.
+	bool getSnapshot(Image & image);
+	bool getSnapshot(Image & image, size_t width, size_t height);
+	
+	const Stats & getStats() const { return stats; }
+	void resetStats() { stats.reset(); }
+	
+	//! Write a line for every recorded command to the given stream, or to nothing if log is NULL.
+	void setCommandLog(std::ostream * log) { commandLog = log; }
+	
+	//! Called by the window after each frame has been "presented".
+	void endFrame();
+	
+	// Recording functions for the null textures, texture stages and vertex buffers
+	void recordDraw(const char * command, Primitive primitive, size_t nvertices, size_t nindices);
+	void recordStateChange(const char * command, int value);
+	void recordTextureChange(unsigned stage, const Texture * texture);
+	void recordUpload(const char * command, size_t bytes);
+	void recordTextureUpload(size_t bytes);
+	
+private:
+	
+	Stats stats;
+	std::ostream * commandLog;
+	
+	EERIEMATRIX view;
+	EERIEMATRIX projection;
+	Rect viewport;
+	
+};
+
+#endif // ARX_GRAPHICS_NULL_NULLRENDERER_H
@@ -0,0 +1,81 @@
+/*
+ * Copyright 2013 Arx Libertatis Team (see the AUTHORS file)
+ *
+ * This file is part of Arx Libertatis.
+ *
+ * Arx Libertatis is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Arx Libertatis is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Arx Libertatis.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "graphics/null/NullTexture2D.h"
+
+#include "graphics/null/NullRenderer.h"
+
+bool NullTexture2D::Create() {
+	storedSize = size;
+	return true;
+}
+
+void NullTexture2D::Upload() {
+	renderer->recordTextureUpload(mImage.GetDataSize());
+}
+
+void NullTextureStage::SetTexture(Texture * pTexture) {
+	if(pTexture != texture) {
+		texture = pTexture;
+		renderer->recordTextureChange(mStage, texture);
+	}
+}
+
+void NullTextureStage::ResetTexture() {
+	SetTexture(NULL);
+}
+
+void NullTextureStage::SetColorOp(TextureOp textureOp, TextureArg arg0, TextureArg arg1) {
+	ARX_UNUSED(arg0), ARX_UNUSED(arg1);
+	renderer->recordStateChange("SetColorOp", textureOp);
+}
+
+void NullTextureStage::SetColorOp(TextureOp textureOp) {
+	renderer->recordStateChange("SetColorOp", textureOp);
+}
+
+void NullTextureStage::SetAlphaOp(TextureOp textureOp, TextureArg arg0, TextureArg arg1) {
+	ARX_UNUSED(arg0), ARX_UNUSED(arg1);
+	renderer->recordStateChange("SetAlphaOp", textureOp);
+}
+
+void NullTextureStage::SetAlphaOp(TextureOp textureOp) {
+	renderer->recordStateChange("SetAlphaOp", textureOp);
+}
+
+void NullTextureStage::SetWrapMode(WrapMode wrapMode) {
+	renderer->recordStateChange("SetWrapMode", wrapMode);
+}
+
+void NullTextureStage::SetMinFilter(FilterMode filterMode) {
+	renderer->recordStateChange("SetMinFilter", filterMode);
+}
+
+void NullTextureStage::SetMagFilter(FilterMode filterMode) {
+	renderer->recordStateChange("SetMagFilter", filterMode);
+}
+
+void NullTextureStage::SetMipFilter(FilterMode filterMode) {
+	renderer->recordStateChange("SetMipFilter", filterMode);
+}
+
+void NullTextureStage::SetMipMapLODBias(float bias) {
+	ARX_UNUSED(bias);
+	renderer->recordStateChange("SetMipMapLODBias", 0);
+}
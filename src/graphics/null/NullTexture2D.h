@@ -0,0 +1,76 @@
+/*
+ * Copyright 2013 Arx Libertatis Team (see the AUTHORS file)
+ *
+ * This file is part of Arx Libertatis.
+ *
+ * Arx Libertatis is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Arx Libertatis is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Arx Libertatis.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ARX_GRAPHICS_NULL_NULLTEXTURE2D_H
+#define ARX_GRAPHICS_NULL_NULLTEXTURE2D_H
+
+#include "graphics/texture/Texture.h"
+#include "graphics/texture/TextureStage.h"
+
+class NullRenderer;
+
+//! Texture that keeps its image in memory and only records uploads.
+class NullTexture2D : public Texture2D {
+	
+public:
+	
+	explicit NullTexture2D(NullRenderer * _renderer) : renderer(_renderer) { }
+	~NullTexture2D() { }
+	
+	bool Create();
+	void Upload();
+	void Destroy() { }
+	
+private:
+	
+	NullRenderer * renderer;
+	
+};
+
+class NullTextureStage : public TextureStage {
+	
+public:
+	
+	NullTextureStage(NullRenderer * _renderer, unsigned textureStage)
+		: TextureStage(textureStage), renderer(_renderer), texture(NULL) { }
+	
+	void SetTexture(Texture * pTexture);
+	void ResetTexture();
+	
+	void SetColorOp(TextureOp textureOp, TextureArg arg0, TextureArg arg1);
+	void SetColorOp(TextureOp textureOp);
+	void SetAlphaOp(TextureOp textureOp, TextureArg arg0, TextureArg arg1);
+	void SetAlphaOp(TextureOp textureOp);
+	
+	void SetWrapMode(WrapMode wrapMode);
+	
+	void SetMinFilter(FilterMode filterMode);
+	void SetMagFilter(FilterMode filterMode);
+	void SetMipFilter(FilterMode filterMode);
+	
+	void SetMipMapLODBias(float bias);
+	
+private:
+	
+	NullRenderer * renderer;
+	Texture * texture;
+	
+};
+
+#endif // ARX_GRAPHICS_NULL_NULLTEXTURE2D_H
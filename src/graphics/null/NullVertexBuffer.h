@@ -0,0 +1,94 @@
+/*
+ * Copyright 2013 Arx Libertatis Team (see the AUTHORS file)
+ *
+ * This file is part of Arx Libertatis.
+ *
+ * Arx Libertatis is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Arx Libertatis is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Arx Libertatis.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ARX_GRAPHICS_NULL_NULLVERTEXBUFFER_H
+#define ARX_GRAPHICS_NULL_NULLVERTEXBUFFER_H
+
+#include <algorithm>
+
+#include "graphics/VertexBuffer.h"
+#include "graphics/null/NullRenderer.h"
+
+//! Vertex buffer in system memory that records uploads and draw calls.
+template <class Vertex>
+class NullVertexBuffer : public VertexBuffer<Vertex> {
+	
+public:
+	
+	using VertexBuffer<Vertex>::capacity;
+	
+	NullVertexBuffer(NullRenderer * _renderer, size_t capacity)
+		: VertexBuffer<Vertex>(capacity), renderer(_renderer), buffer(new Vertex[capacity]), lockCount(0) { }
+	
+	void setData(const Vertex * vertices, size_t count, size_t offset, BufferFlags flags) {
+		ARX_UNUSED(flags);
+		
+		arx_assert(offset + count <= capacity());
+		
+		std::copy(vertices, vertices + count, buffer + offset);
+		
+		renderer->recordUpload("VertexBuffer::setData", count * sizeof(Vertex));
+	}
+	
+	Vertex * lock(BufferFlags flags, size_t offset, size_t count) {
+		ARX_UNUSED(flags);
+		
+		arx_assert(offset < capacity());
+		
+		lockCount = std::min(count, capacity() - offset);
+		
+		return buffer + offset;
+	}
+	
+	void unlock() {
+		renderer->recordUpload("VertexBuffer::unlock", lockCount * sizeof(Vertex));
+		lockCount = 0;
+	}
+	
+	void draw(Renderer::Primitive primitive, size_t count, size_t offset) const {
+		ARX_UNUSED(offset);
+		
+		arx_assert(offset + count <= capacity());
+		
+		renderer->recordDraw("VertexBuffer::draw", primitive, count, 0);
+	}
+	
+	void drawIndexed(Renderer::Primitive primitive, size_t count, size_t offset, unsigned short * indices, size_t nbindices) const {
+		ARX_UNUSED(offset);
+		
+		arx_assert(offset + count <= capacity());
+		arx_assert(indices != NULL);
+		
+		renderer->recordDraw("VertexBuffer::drawIndexed", primitive, count, nbindices);
+	}
+	
+	~NullVertexBuffer() {
+		delete[] buffer;
+	};
+	
+private:
+	
+	NullRenderer * renderer;
+	Vertex * buffer;
+	
+	size_t lockCount;
+	
+};
+
+#endif // ARX_GRAPHICS_NULL_NULLVERTEXBUFFER_H
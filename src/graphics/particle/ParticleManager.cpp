@@ -45,6 +45,7 @@ ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
 
 #include <boost/foreach.hpp>
 
+#include "graphics/RenderBatcher.h"
 #include "graphics/particle/ParticleSystem.h"
 
 using std::list;
@@ -99,14 +100,22 @@ void ParticleManager::Update(long _lTime)
 
 void ParticleManager::Render()
 {
-	int ilekel = 0;
+	// Batch all systems together so that particles sharing a texture are merged
+	static RenderBatcher batcher;
+	
 	list<ParticleSystem *>::iterator i;
 
 	for (i = listParticleSystem.begin(); i != listParticleSystem.end(); ++i)
 	{
 		ParticleSystem * p = *i;
-		p->Render();
-		ilekel++;
+		p->Render(batcher);
+	}
+	
+	batcher.render();
+	
+	// Leave the same state as drawing each system on its own
+	if(!listParticleSystem.empty()) {
+		listParticleSystem.back()->SetRenderState();
 	}
 }
 
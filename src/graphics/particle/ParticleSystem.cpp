@@ -53,6 +53,7 @@ ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
 #include "graphics/Draw.h"
 #include "graphics/Math.h"
 #include "graphics/GraphicsTypes.h"
+#include "graphics/RenderBatcher.h"
 #include "graphics/data/TextureContainer.h"
 #include "graphics/effects/SpellEffects.h"
 #include "graphics/particle/ParticleParams.h"
@@ -323,12 +324,16 @@ void VectorRotateZ(Vec3f & _eIn, Vec3f & _eOut, float _fAngle) {
 void ParticleSystem::SetParticleParams(Particle * pP)
 {
 	SpawnParticle(pP);
+	
+	// Draw all random values for this particle in one batch
+	float r[14];
+	Random::fill(r, r + ARRAY_SIZE(r));
 
-	float fTTL = fParticleLife + rnd() * fParticleLifeRandom;
+	float fTTL = fParticleLife + r[0] * fParticleLifeRandom;
 	pP->ulTTL = checked_range_cast<long>(fTTL);
 	pP->fOneOnTTL = 1.0f / (float)pP->ulTTL;
 
-	float fAngleX = rnd() * fParticleAngle; //*0.5f;
+	float fAngleX = r[1] * fParticleAngle; //*0.5f;
  
 	Vec3f vv1, vvz;
 	vv1 = p3ParticleDirection;
@@ -338,47 +343,47 @@ void ParticleSystem::SetParticleParams(Particle * pP)
 	vv1 = -Vec3f::Y_AXIS;
 	
 	VectorRotateZ(vv1, vvz, fAngleX); 
-	VectorRotateY(vvz, vv1, radians(rnd() * 360.0f));
+	VectorRotateY(vvz, vv1, radians(r[2] * 360.0f));
 	VectorMatrixMultiply(&vvz, &vv1, &eMat);
 
-	float fSpeed = fParticleSpeed + rnd() * fParticleSpeedRandom;
+	float fSpeed = fParticleSpeed + r[3] * fParticleSpeedRandom;
 
 	pP->p3Velocity = vvz * fSpeed;
-	pP->fSizeStart = fParticleStartSize + rnd() * fParticleStartSizeRandom;
+	pP->fSizeStart = fParticleStartSize + r[4] * fParticleStartSizeRandom;
 
 	if (bParticleStartColorRandomLock)
 	{
-		float t = rnd() * fParticleStartColorRandom[0];
+		float t = r[5] * fParticleStartColorRandom[0];
 		pP->fColorStart[0] = fParticleStartColor[0] + t;
 		pP->fColorStart[1] = fParticleStartColor[1] + t;
 		pP->fColorStart[2] = fParticleStartColor[2] + t;
 	}
 	else
 	{
-		pP->fColorStart[0] = fParticleStartColor[0] + rnd() * fParticleStartColorRandom[0];
-		pP->fColorStart[1] = fParticleStartColor[1] + rnd() * fParticleStartColorRandom[1];
-		pP->fColorStart[2] = fParticleStartColor[2] + rnd() * fParticleStartColorRandom[2];
+		pP->fColorStart[0] = fParticleStartColor[0] + r[5] * fParticleStartColorRandom[0];
+		pP->fColorStart[1] = fParticleStartColor[1] + r[6] * fParticleStartColorRandom[1];
+		pP->fColorStart[2] = fParticleStartColor[2] + r[7] * fParticleStartColorRandom[2];
 	}
 
-	pP->fColorStart[3] = fParticleStartColor[3] + rnd() * fParticleStartColorRandom[3];
+	pP->fColorStart[3] = fParticleStartColor[3] + r[8] * fParticleStartColorRandom[3];
 
-	pP->fSizeEnd = fParticleEndSize + rnd() * fParticleEndSizeRandom;
+	pP->fSizeEnd = fParticleEndSize + r[9] * fParticleEndSizeRandom;
 
 	if (bParticleEndColorRandomLock)
 	{
-		float t = rnd() * fParticleEndColorRandom[0];
+		float t = r[10] * fParticleEndColorRandom[0];
 		pP->fColorEnd[0] = fParticleEndColor[0] + t;
 		pP->fColorEnd[1] = fParticleEndColor[1] + t;
 		pP->fColorEnd[2] = fParticleEndColor[2] + t;
 	}
 	else
 	{
-		pP->fColorEnd[0] = fParticleEndColor[0] + rnd() * fParticleEndColorRandom[0];
-		pP->fColorEnd[1] = fParticleEndColor[1] + rnd() * fParticleEndColorRandom[1];
-		pP->fColorEnd[2] = fParticleEndColor[2] + rnd() * fParticleEndColorRandom[2];
+		pP->fColorEnd[0] = fParticleEndColor[0] + r[10] * fParticleEndColorRandom[0];
+		pP->fColorEnd[1] = fParticleEndColor[1] + r[11] * fParticleEndColorRandom[1];
+		pP->fColorEnd[2] = fParticleEndColor[2] + r[12] * fParticleEndColorRandom[2];
 	}
 
-	pP->fColorEnd[3] = fParticleEndColor[3] + rnd() * fParticleEndColorRandom[3];
+	pP->fColorEnd[3] = fParticleEndColor[3] + r[13] * fParticleEndColorRandom[3];
 
 	if (bParticleRotationRandomDirection)
 	{
@@ -488,12 +493,34 @@ void ParticleSystem::Update(long _lTime)
 }
 
 //-----------------------------------------------------------------------------
-void ParticleSystem::Render() {
+void ParticleSystem::SetRenderState() {
 	
 	GRenderer->SetCulling(Renderer::CullNone);
 	GRenderer->SetRenderState(Renderer::DepthWrite, false);
 	GRenderer->SetRenderState(Renderer::AlphaBlending, true);
 	GRenderer->SetBlendFunc(iSrcBlend, iDstBlend);
+}
+
+void ParticleSystem::Render() {
+	
+	// Callers draw more effects relying on this state, even if there are no particles
+	SetRenderState();
+	
+	static RenderBatcher batcher;
+	
+	Render(batcher);
+	
+	batcher.render();
+}
+
+void ParticleSystem::Render(RenderBatcher & batcher) {
+	
+	RenderMaterial material;
+	material.blending = true;
+	material.srcBlend = iSrcBlend;
+	material.dstBlend = iDstBlend;
+	material.depthWrite = false;
+	material.culling = Renderer::CullNone;
 
 	int inumtex = 0;
 
@@ -563,13 +590,19 @@ void ParticleSystem::Render() {
 				else
 					fRot = (-fParticleRotation) * p->ulTime + p->fRotStart;
 
-				if (tex_tab[inumtex])
-					EERIEDrawRotatedSprite(&p3pos, p->fSize, tex_tab[inumtex], p->ulColor, 2, fRot);
+				TexturedVertex v[4];
+				if(tex_tab[inumtex] && EERIEComputeRotatedSprite(&p3pos, p->fSize, p->ulColor, 2, fRot, v)) {
+					material.texture = tex_tab[inumtex];
+					batcher.add(material, Renderer::TriangleFan, v, 4);
+				}
 			}
 			else
 			{
-				if (tex_tab[inumtex])
-					EERIEDrawSprite(&p3pos, p->fSize, tex_tab[inumtex], p->ulColor, 2);
+				TexturedVertex v[4];
+				if(tex_tab[inumtex] && EERIEComputeSprite(&p3pos, p->fSize, p->ulColor, 2, v)) {
+					material.texture = tex_tab[inumtex];
+					batcher.add(material, Renderer::TriangleStrip, v, 4);
+				}
 			}
 		}
 	}
@@ -54,6 +54,7 @@ ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
  
 class Particle;
 class ParticleParams;
+class RenderBatcher;
 class TextureContainer;
 
 enum ParticleSpawnFlag {
@@ -140,7 +141,15 @@ public:
 	void SetPos(const Vec3f & ap3);
 	void SetColor(float, float, float);
 	
+	//! Set the renderer state used for the particles and draw them.
 	void Render();
+	
+	//! Record the particles in batcher without drawing them.
+	void Render(RenderBatcher & batcher);
+	
+	//! Set the culling, depth write and blending state used for the particles.
+	void SetRenderState();
+	
 	bool IsAlive();
 	void Update(long);
 	void RecomputeDirection();
@@ -19,6 +19,8 @@
 
 #include "graphics/texture/Texture.h"
 
+#include "graphics/texture/TextureCache.h"
+
 bool Texture2D::Init(const res::path & strFileName, TextureFlags newFlags) {
 	
 	mFileName = strFileName;
@@ -34,6 +36,20 @@ bool Texture2D::Init(const Image & pImage, TextureFlags newFlags) {
 	return Restore();
 }
 
+bool Texture2D::Init(const res::path & strFileName, const Image & pImage,
+                     TextureFlags newFlags) {
+	
+	mFileName = strFileName;
+	mImage = pImage;
+	flags = newFlags;
+	
+	if((flags & HasColorKey) && !mImage.HasAlpha()) {
+		flags &= ~HasColorKey;
+	}
+	
+	return RestoreFromImage();
+}
+
 bool Texture2D::Init(unsigned int pWidth, unsigned int pHeight, Image::Format pFormat) {
 	
 	mFileName.clear();
@@ -48,18 +64,20 @@ bool Texture2D::Init(unsigned int pWidth, unsigned int pHeight, Image::Format pF
 
 bool Texture2D::Restore() {
 	
-	bool bRestored = false;
-
 	if(!mFileName.empty()) {
-		mImage.LoadFromFile(mFileName);
+		texturecache::load(mFileName, (flags & HasColorKey), mImage);
 
 		if((flags & HasColorKey) && !mImage.HasAlpha()) {
-			mImage.ApplyColorKeyToAlpha();
-			if(!mImage.HasAlpha()) {
-				flags &= ~HasColorKey;
-			}
+			flags &= ~HasColorKey;
 		}
 	}
+	
+	return RestoreFromImage();
+}
+
+bool Texture2D::RestoreFromImage() {
+	
+	bool bRestored = false;
 
 	if(mImage.IsValid()) {
 		mFormat = mImage.GetFormat();
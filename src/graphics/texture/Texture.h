@@ -78,6 +78,12 @@ public:
 	bool Init(const Image & image, TextureFlags flags = HasMipmaps);
 	bool Init(unsigned int width, unsigned int height, Image::Format format);
 	
+	/*!
+	 * Initialize the texture from an image that was already loaded from a file.
+	 * The file is only used to restore the texture later on.
+	 */
+	bool Init(const res::path & strFileName, const Image & image, TextureFlags flags);
+	
 	bool Restore();
 	
 	inline Image & GetImage() { return mImage; }
@@ -87,6 +93,9 @@ protected:
 	
 	Texture2D() { } 
 	
+	//! Re-create the texture from mImage
+	bool RestoreFromImage();
+	
 	Image mImage;
 	res::path mFileName;
 	
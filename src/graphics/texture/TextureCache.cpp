@@ -0,0 +1,413 @@
+/*
+ * Copyright 2013 Arx Libertatis Team (see the AUTHORS file)
+ *
+ * This file is part of Arx Libertatis.
+ *
+ * Arx Libertatis is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Arx Libertatis is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Arx Libertatis.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "graphics/texture/TextureCache.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+#include "graphics/image/Image.h"
+#include "io/fs/FilePath.h"
+#include "io/fs/FileStream.h"
+#include "io/fs/Filesystem.h"
+#include "io/fs/SystemPaths.h"
+#include "io/log/Logger.h"
+#include "io/resource/PakEntry.h"
+#include "io/resource/PakReader.h"
+#include "io/resource/ResourcePath.h"
+#include "platform/Lock.h"
+#include "platform/Platform.h"
+
+namespace texturecache {
+
+namespace {
+
+const char CACHE_MAGIC[4] = { 'A', 'X', 'T', 'C' };
+const u32 CACHE_VERSION = 5;
+
+//! Maximum total size of all cache files, in bytes
+const u64 MAX_CACHE_SIZE = 512 * 1024 * 1024;
+
+//! Size to trim the cache to once it grows past MAX_CACHE_SIZE, in bytes
+const u64 TRIMMED_CACHE_SIZE = MAX_CACHE_SIZE / 4 * 3;
+
+//! Average color reported for images that have not been decoded yet
+const Color UNKNOWN_AVERAGE(128, 128, 128);
+
+#pragma pack(push, 1)
+
+struct CacheHeader {
+	char magic[4];
+	u32 version;
+	u64 sourceTime;
+	u32 sourceSize;
+	u32 format;
+	u32 width;
+	u32 height;
+	u32 dataSize;
+	ColorRGBA average;
+};
+
+#pragma pack(pop)
+
+struct CacheFile {
+	u64 size;
+	std::time_t lastUsed;
+};
+
+typedef std::map<std::string, CacheFile> CacheIndex;
+
+// Shared by the main thread and the texture decoder thread
+Lock indexLock;
+bool indexLoaded = false;
+CacheIndex cacheIndex;
+u64 cacheSize = 0;
+
+//! FNV-1a
+u64 checksum(const char * data, size_t size, u64 hash = 0xcbf29ce484222325ull) {
+	for(size_t i = 0; i < size; i++) {
+		hash ^= u8(data[i]);
+		hash *= 0x100000001b3ull;
+	}
+	return hash;
+}
+
+fs::path getCacheDir() {
+	if(fs::paths.user.empty()) {
+		return fs::path();
+	}
+	return fs::paths.user / "cache" / "textures";
+}
+
+fs::path getCacheFile(const res::path & file, bool colorKey) {
+	
+	fs::path dir = getCacheDir();
+	if(dir.empty()) {
+		return dir;
+	}
+	
+	const std::string & name = file.string();
+	u64 hash = checksum(name.data(), name.length());
+	hash = checksum(colorKey ? "k" : "n", 1, hash);
+	
+	std::ostringstream oss;
+	oss << std::hex << std::setfill('0') << std::setw(16) << hash << ".tex";
+	
+	return dir / oss.str();
+}
+
+//! Scan the existing cache files - must be called with indexLock held.
+void loadIndex(const fs::path & dir) {
+	
+	if(indexLoaded) {
+		return;
+	}
+	indexLoaded = true;
+	
+	for(fs::directory_iterator it(dir); !it.end(); ++it) {
+		
+		if(!it.is_regular_file()) {
+			continue;
+		}
+		
+		std::string name = it.name();
+		fs::path path = dir / name;
+		u64 size = fs::file_size(path);
+		if(size == u64(-1)) {
+			continue;
+		}
+		
+		CacheFile & file = cacheIndex[name];
+		file.size = size;
+		file.lastUsed = fs::last_write_time(path);
+		cacheSize += size;
+	}
+	
+	LogDebug("texture cache: " << cacheIndex.size() << " files, " << cacheSize << " bytes");
+}
+
+//! Remove the least recently used files until the cache fits into TRIMMED_CACHE_SIZE.
+void trimCache(const fs::path & dir, const std::string & keep) {
+	
+	std::vector< std::pair<std::time_t, std::string> > files;
+	files.reserve(cacheIndex.size());
+	for(CacheIndex::const_iterator i = cacheIndex.begin(); i != cacheIndex.end(); ++i) {
+		if(i->first != keep) {
+			files.push_back(std::make_pair(i->second.lastUsed, i->first));
+		}
+	}
+	std::sort(files.begin(), files.end());
+	
+	for(size_t i = 0; i < files.size() && cacheSize > TRIMMED_CACHE_SIZE; i++) {
+		CacheIndex::iterator file = cacheIndex.find(files[i].second);
+		if(fs::remove(dir / file->first)) {
+			cacheSize -= file->second.size;
+			cacheIndex.erase(file);
+		}
+	}
+	
+	LogDebug("trimmed texture cache to " << cacheSize << " bytes");
+}
+
+//! Record that a cache file was used so that it is not removed soon.
+void markUsed(const fs::path & cacheFile) {
+	
+	{
+		Autolock lock(indexLock);
+		loadIndex(cacheFile.parent());
+		CacheIndex::iterator file = cacheIndex.find(cacheFile.filename());
+		if(file != cacheIndex.end()) {
+			file->second.lastUsed = std::time(NULL);
+		}
+	}
+	
+	// Keep the order for later runs
+	fs::touch(cacheFile);
+}
+
+//! Add a newly written cache file and trim the cache if it has grown too large.
+void addToIndex(const fs::path & cacheFile, u64 size) {
+	
+	Autolock lock(indexLock);
+	
+	fs::path dir = cacheFile.parent();
+	loadIndex(dir);
+	
+	std::string name = cacheFile.filename();
+	CacheFile & file = cacheIndex[name];
+	if(file.size) {
+		cacheSize -= file.size;
+	}
+	file.size = size;
+	file.lastUsed = std::time(NULL);
+	cacheSize += size;
+	
+	if(cacheSize > MAX_CACHE_SIZE) {
+		trimCache(dir, name);
+	}
+}
+
+bool readHeader(fs::ifstream & ifs, std::time_t sourceTime, size_t sourceSize,
+                CacheHeader & header) {
+	
+	if(!fs::read(ifs, header) || memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC))
+	   || header.version != CACHE_VERSION || header.sourceTime != u64(sourceTime)
+	   || header.sourceSize != sourceSize || header.format >= Image::Format_Unknown
+	   || !header.width || !header.height) {
+		return false;
+	}
+	
+	Image::Format format = Image::Format(header.format);
+	return (header.dataSize == Image::GetSize(format, header.width, header.height));
+}
+
+bool readCache(const fs::path & cacheFile, std::time_t sourceTime, size_t sourceSize,
+               Image & image, Color * average) {
+	
+	fs::ifstream ifs(cacheFile, fs::fstream::in | fs::fstream::binary);
+	if(!ifs.is_open()) {
+		return false;
+	}
+	
+	CacheHeader header;
+	if(!readHeader(ifs, sourceTime, sourceSize, header)) {
+		return false;
+	}
+	
+	Image::Format format = Image::Format(header.format);
+	image.Create(header.width, header.height, format);
+	
+	// Read the image data straight into the image buffer
+	if(!fs::read(ifs, image.GetData(), header.dataSize)) {
+		image.Reset();
+		return false;
+	}
+	
+	if(average) {
+		*average = Color::fromRGBA(header.average);
+	}
+	
+	markUsed(cacheFile);
+	
+	return true;
+}
+
+void writeCache(const fs::path & cacheFile, std::time_t sourceTime, size_t sourceSize,
+                const Image & image, Color average) {
+	
+	if(!fs::create_directories(cacheFile.parent())) {
+		return;
+	}
+	
+	CacheHeader header;
+	memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+	header.version = CACHE_VERSION;
+	header.sourceTime = u64(sourceTime);
+	header.sourceSize = u32(sourceSize);
+	header.format = u32(image.GetFormat());
+	header.width = image.GetWidth();
+	header.height = image.GetHeight();
+	header.dataSize = image.GetDataSize();
+	header.average = average.toRGBA();
+	
+	// Write to a temporary file first so that we never leave a truncated cache file
+	fs::path tempFile = cacheFile;
+	tempFile.append(".tmp");
+	
+	{
+		fs::ofstream ofs(tempFile, fs::fstream::out | fs::fstream::binary | fs::fstream::trunc);
+		if(!ofs.is_open()) {
+			return;
+		}
+		if(!fs::write(ofs, header) || !fs::write(ofs, image.GetData(), header.dataSize)) {
+			ofs.close();
+			fs::remove(tempFile);
+			return;
+		}
+	}
+	
+	if(!fs::rename(tempFile, cacheFile, true)) {
+		fs::remove(tempFile);
+		return;
+	}
+	
+	addToIndex(cacheFile, sizeof(header) + header.dataSize);
+}
+
+//! Average color of all pixels in an uncompressed image
+Color getAverageColor(const Image & image) {
+	
+	if(!image.IsValid() || image.IsCompressed()) {
+		return UNKNOWN_AVERAGE;
+	}
+	
+	size_t channels = image.GetNumChannels();
+	size_t count = size_t(image.GetWidth()) * image.GetHeight() * image.GetDepth();
+	const unsigned char * data = image.GetData();
+	
+	u64 sum[4] = { 0, 0, 0, 0 };
+	for(size_t i = 0; i < count; i++, data += channels) {
+		for(size_t c = 0; c < channels; c++) {
+			sum[c] += data[c];
+		}
+	}
+	
+	u8 avg[4];
+	for(size_t c = 0; c < 4; c++) {
+		avg[c] = u8(sum[c] / count);
+	}
+	
+	switch(image.GetFormat()) {
+		case Image::Format_L8:       return Color(avg[0], avg[0], avg[0]);
+		case Image::Format_A8:       return Color(255, 255, 255, avg[0]);
+		case Image::Format_L8A8:     return Color(avg[0], avg[0], avg[0], avg[1]);
+		case Image::Format_R8G8B8:   return Color(avg[0], avg[1], avg[2]);
+		case Image::Format_B8G8R8:   return Color(avg[2], avg[1], avg[0]);
+		case Image::Format_R8G8B8A8: return Color(avg[0], avg[1], avg[2], avg[3]);
+		case Image::Format_B8G8R8A8: return Color(avg[2], avg[1], avg[0], avg[3]);
+		default:                     return UNKNOWN_AVERAGE;
+	}
+}
+
+} // anonymous namespace
+
+bool load(const res::path & file, bool colorKey, Image & image) {
+	
+	PakFile * source = resources->getFile(file);
+	if(!source) {
+		return false;
+	}
+	
+	// Only read the resource file if it is not in the cache
+	fs::path cacheFile = getCacheFile(file, colorKey);
+	if(!cacheFile.empty()
+	   && readCache(cacheFile, source->modified(), source->size(), image, NULL)) {
+		return true;
+	}
+	
+	char * data = source->readAlloc();
+	if(!data) {
+		return false;
+	}
+	
+	bool loaded = load(file, data, source->size(), source->modified(), colorKey, image);
+	
+	free(data);
+	
+	return loaded;
+}
+
+bool load(const res::path & file, char * data, size_t size, std::time_t modified,
+          bool colorKey, Image & image, Color * average) {
+	
+	fs::path cacheFile = getCacheFile(file, colorKey);
+	
+	if(!cacheFile.empty() && readCache(cacheFile, modified, size, image, average)) {
+		return true;
+	}
+	
+	if(!image.LoadFromMemory(data, size, file.string().c_str())) {
+		return false;
+	}
+	
+	if(colorKey && !image.HasAlpha()) {
+		image.ApplyColorKeyToAlpha();
+	}
+	
+	Color color = getAverageColor(image);
+	if(average) {
+		*average = color;
+	}
+	
+	if(!cacheFile.empty() && !image.IsCompressed() && !image.IsVolume()
+	   && image.GetNumMipmaps() == 1) {
+		writeCache(cacheFile, modified, size, image, color);
+	}
+	
+	return true;
+}
+
+bool getInfo(const res::path & file, const char * data, size_t size, std::time_t modified,
+             bool colorKey, Info & info) {
+	
+	if(!Image::GetInfo(data, size, info.width, info.height)) {
+		return false;
+	}
+	
+	info.placeholder = UNKNOWN_AVERAGE;
+	
+	fs::path cacheFile = getCacheFile(file, colorKey);
+	if(!cacheFile.empty()) {
+		fs::ifstream ifs(cacheFile, fs::fstream::in | fs::fstream::binary);
+		CacheHeader header;
+		if(ifs.is_open() && readHeader(ifs, modified, size, header)) {
+			info.placeholder = Color::fromRGBA(header.average);
+		}
+	}
+	
+	return true;
+}
+
+} // namespace texturecache
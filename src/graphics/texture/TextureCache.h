@@ -0,0 +1,76 @@
+/*
+ * Copyright 2013 Arx Libertatis Team (see the AUTHORS file)
+ *
+ * This file is part of Arx Libertatis.
+ *
+ * Arx Libertatis is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Arx Libertatis is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Arx Libertatis.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ARX_GRAPHICS_TEXTURE_TEXTURECACHE_H
+#define ARX_GRAPHICS_TEXTURE_TEXTURECACHE_H
+
+#include <stddef.h>
+#include <ctime>
+
+#include "graphics/Color.h"
+
+class Image;
+namespace res { class path; }
+
+/*!
+ * On-disk cache of decoded and pre-processed texture images.
+ * 
+ * Cache files are stored in the user directory and contain the raw image data
+ * after color keying and its average color. They are validated against the size and last write time
+ * of the source file, so that modified resources are decoded again.
+ * 
+ * The total size of the cache is limited - when it grows too large, the least
+ * recently used files are removed.
+ */
+namespace texturecache {
+
+/*!
+ * Load an image from the resource files, using the cache if possible.
+ * @param colorKey Convert black pixels to transparent if the image has no alpha channel.
+ */
+bool load(const res::path & file, bool colorKey, Image & image);
+
+/*!
+ * Load an image from the already read contents of a resource file.
+ * This does not access the resource files and can be used from any thread.
+ * @param modified the last write time of the resource file, see PakFile::modified()
+ * @param average  if not NULL, receives the average color of the image
+ */
+bool load(const res::path & file, char * data, size_t size, std::time_t modified,
+          bool colorKey, Image & image, Color * average = NULL);
+
+struct Info {
+	unsigned int width;
+	unsigned int height;
+	//! Color to show until the image has been decoded.
+	Color placeholder;
+};
+
+/*!
+ * Get the dimensions of an image without decoding it.
+ * The placeholder is the average color stored in the cache, or gray if the image
+ * is not cached yet. Only the header of the cache file is read.
+ * @param data the contents of the resource file.
+ */
+bool getInfo(const res::path & file, const char * data, size_t size, std::time_t modified,
+             bool colorKey, Info & info);
+
+} // namespace texturecache
+
+#endif // ARX_GRAPHICS_TEXTURE_TEXTURECACHE_H
@@ -0,0 +1,490 @@
+/*
+ * Copyright 2013 Arx Libertatis Team (see the AUTHORS file)
+ *
+ * This file is part of Arx Libertatis.
+ *
+ * Arx Libertatis is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Arx Libertatis is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Arx Libertatis.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "graphics/texture/TextureStream.h"
+
+#include <stddef.h>
+#include <cstdlib>
+#include <ctime>
+#include <algorithm>
+#include <deque>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "graphics/Color.h"
+#include "graphics/Renderer.h"
+#include "graphics/data/TextureContainer.h"
+#include "graphics/image/Image.h"
+#include "graphics/texture/TextureCache.h"
+#include "io/log/Logger.h"
+#include "io/resource/PakEntry.h"
+#include "io/resource/PakReader.h"
+#include "io/resource/ResourcePath.h"
+#include "platform/Lock.h"
+#include "platform/Platform.h"
+#include "platform/Profiler.h"
+#include "platform/Thread.h"
+#include "platform/Time.h"
+
+namespace texturestream {
+
+namespace {
+
+//! Time to wait for new requests when the queue is empty, in milliseconds
+const unsigned DECODER_IDLE_INTERVAL = 5;
+
+//! Maximum time to spend uploading textures per frame, in microseconds
+const u64 UPLOAD_BUDGET = 2000;
+
+//! Maximum estimated size of all resident streamed textures, in bytes
+const size_t MEMORY_BUDGET = 256 * 1024 * 1024;
+
+//! Number of frames a texture must be unused before it can be evicted
+const u32 EVICTION_DELAY = 300;
+
+struct Request {
+	TextureContainer * tc;
+	u32 id;
+	res::path file;
+	char * data;
+	size_t size;
+	std::time_t modified;
+	bool colorKey;
+};
+
+struct Result {
+	TextureContainer * tc;
+	u32 id;
+	Image * image; //!< NULL if the image could not be loaded
+	Color average;
+};
+
+enum State {
+	Pending,
+	Resident,
+	Evicted
+};
+
+struct Entry {
+	u32 id;
+	res::path file;
+	Texture::TextureFlags flags;
+	State state;
+	Color average;
+	size_t memory;
+	u32 lastUsed;
+};
+
+typedef std::map<TextureContainer *, Entry> Entries;
+
+// Shared with the decoder thread
+Lock lock;
+std::deque<Request> requests;
+std::deque<Result> results;
+
+// Only used by the main thread
+Entries entries;
+u32 nextId = 0;
+size_t pendingCount = 0;
+size_t evictedCount = 0;
+size_t residentMemory = 0;
+
+class DecoderThread : public StoppableThread {
+	
+	bool decodeNext() {
+		
+		Request request;
+		{
+			Autolock l(lock);
+			if(requests.empty()) {
+				return false;
+			}
+			request = requests.front();
+			requests.pop_front();
+		}
+		
+		Result result;
+		result.tc = request.tc;
+		result.id = request.id;
+		result.image = new Image;
+		
+		{
+			ARX_PROFILE("Decode texture");
+			if(!texturecache::load(request.file, request.data, request.size, request.modified,
+			                       request.colorKey, *result.image, &result.average)) {
+				delete result.image, result.image = NULL;
+			}
+		}
+		
+		free(request.data);
+		
+		Autolock l(lock);
+		results.push_back(result);
+		
+		return true;
+	}
+	
+	void run() {
+		
+		profiler::registerThread("Texture Decoder");
+		
+		while(!isStopRequested()) {
+			if(!decodeNext()) {
+				sleep(DECODER_IDLE_INTERVAL);
+			}
+		}
+	}
+	
+};
+
+DecoderThread * decoder = NULL;
+
+bool setPlaceholder(Texture2D * texture, Color color) {
+	
+	Image image;
+	image.Create(1, 1, Image::Format_R8G8B8A8);
+	
+	unsigned char * data = image.GetData();
+	data[0] = color.r, data[1] = color.g, data[2] = color.b, data[3] = color.a;
+	
+	return texture->Init(image, 0);
+}
+
+void updateSize(TextureContainer * tc) {
+	
+	tc->m_dwWidth = tc->m_pTexture->getSize().x;
+	tc->m_dwHeight = tc->m_pTexture->getSize().y;
+	
+	Vec2i storedSize = tc->m_pTexture->getStoredSize();
+	tc->uv = Vec2f(float(tc->m_dwWidth) / storedSize.x, float(tc->m_dwHeight) / storedSize.y);
+	tc->hd = Vec2f(.5f / storedSize.x, .5f / storedSize.y);
+}
+
+//! Read the contents of a resource file for the decoder thread.
+char * readSource(const res::path & file, size_t & size, std::time_t & modified) {
+	
+	PakFile * source = resources->getFile(file);
+	if(!source) {
+		return NULL;
+	}
+	
+	size = source->size();
+	modified = source->modified();
+	
+	return source->readAlloc();
+}
+
+void request(TextureContainer * tc, Entry & entry, char * data, size_t size,
+             std::time_t modified) {
+	
+	entry.id = ++nextId;
+	entry.state = Pending;
+	pendingCount++;
+	
+	Request request;
+	request.tc = tc;
+	request.id = entry.id;
+	request.file = entry.file;
+	request.data = data;
+	request.size = size;
+	request.modified = modified;
+	request.colorKey = (entry.flags & Texture::HasColorKey);
+	
+	Autolock l(lock);
+	requests.push_back(request);
+}
+
+void upload(const Result & result) {
+	
+	Entries::iterator it = entries.find(result.tc);
+	if(it == entries.end() || it->second.id != result.id || it->second.state != Pending) {
+		// The texture was removed or reloaded while it was being decoded
+		delete result.image;
+		return;
+	}
+	
+	TextureContainer * tc = it->first;
+	Entry & entry = it->second;
+	
+	pendingCount--;
+	
+	if(!result.image) {
+		LogError << "Error loading texture " << entry.file;
+		entries.erase(it);
+		return;
+	}
+	
+	bool created = tc->m_pTexture->Init(entry.file, *result.image, entry.flags);
+	
+	Image::Format format = result.image->GetFormat();
+	delete result.image;
+	
+	if(!created) {
+		LogError << "Error creating texture " << entry.file;
+		entries.erase(it);
+		return;
+	}
+	
+	updateSize(tc);
+	
+	const Vec2i & size = tc->m_pTexture->getSize();
+	if(entry.flags & Texture::HasMipmaps) {
+		entry.memory = Image::GetSizeWithMipmaps(format, size.x, size.y);
+	} else {
+		entry.memory = Image::GetSize(format, size.x, size.y);
+	}
+	entry.average = result.average;
+	entry.state = Resident;
+	residentMemory += entry.memory;
+}
+
+//! Upload decoded textures until the budget (in microseconds) is used up, or all if it is zero
+void uploadResults(u64 budget) {
+	
+	u64 start = Time::getUs();
+	
+	while(true) {
+		
+		Result result;
+		{
+			Autolock l(lock);
+			if(results.empty()) {
+				break;
+			}
+			result = results.front();
+			results.pop_front();
+		}
+		
+		upload(result);
+		
+		if(budget && Time::getElapsedUs(start) >= budget) {
+			break;
+		}
+	}
+}
+
+bool compareLastUsed(TextureContainer * a, TextureContainer * b) {
+	return (TextureContainer::s_currentFrame - a->m_lastUsedFrame)
+	       > (TextureContainer::s_currentFrame - b->m_lastUsedFrame);
+}
+
+void evictUnused() {
+	
+	if(residentMemory <= MEMORY_BUDGET) {
+		return;
+	}
+	
+	std::vector<TextureContainer *> candidates;
+	for(Entries::const_iterator i = entries.begin(); i != entries.end(); ++i) {
+		u32 unused = TextureContainer::s_currentFrame - i->first->m_lastUsedFrame;
+		if(i->second.state == Resident && unused > EVICTION_DELAY) {
+			candidates.push_back(i->first);
+		}
+	}
+	
+	// Least recently used first
+	std::sort(candidates.begin(), candidates.end(), compareLastUsed);
+	
+	for(size_t i = 0; i < candidates.size() && residentMemory > MEMORY_BUDGET; i++) {
+		
+		TextureContainer * tc = candidates[i];
+		Entry & entry = entries[tc];
+		
+		if(!setPlaceholder(tc->m_pTexture, entry.average)) {
+			continue;
+		}
+		tc->uv = Vec2f::ONE;
+		
+		residentMemory -= entry.memory;
+		entry.memory = 0;
+		entry.state = Evicted;
+		entry.lastUsed = tc->m_lastUsedFrame;
+		evictedCount++;
+		
+		LogDebug("evicted texture " << entry.file);
+	}
+}
+
+void reloadUsed() {
+	
+	if(!evictedCount) {
+		return;
+	}
+	
+	for(Entries::iterator i = entries.begin(); i != entries.end(); ++i) {
+		
+		Entry & entry = i->second;
+		if(entry.state != Evicted || i->first->m_lastUsedFrame == entry.lastUsed) {
+			continue;
+		}
+		
+		size_t size = 0;
+		std::time_t modified;
+		char * data = readSource(entry.file, size, modified);
+		if(!data) {
+			continue;
+		}
+		
+		evictedCount--;
+		request(i->first, entry, data, size, modified);
+	}
+}
+
+} // anonymous namespace
+
+void init() {
+	
+	if(decoder) {
+		return;
+	}
+	
+	decoder = new DecoderThread();
+	decoder->setThreadName("Texture Decoder");
+	decoder->start();
+}
+
+void shutdown() {
+	
+	if(!decoder) {
+		return;
+	}
+	
+	decoder->stop();
+	delete decoder, decoder = NULL;
+	
+	for(std::deque<Request>::iterator i = requests.begin(); i != requests.end(); ++i) {
+		free(i->data);
+	}
+	requests.clear();
+	
+	for(std::deque<Result>::iterator i = results.begin(); i != results.end(); ++i) {
+		delete i->image;
+	}
+	results.clear();
+	
+	entries.clear();
+	pendingCount = 0;
+	evictedCount = 0;
+	residentMemory = 0;
+}
+
+bool load(TextureContainer * tc, const res::path & file, Texture::TextureFlags flags) {
+	
+	remove(tc);
+	
+	if(!decoder) {
+		return false;
+	}
+	
+	size_t size = 0;
+	std::time_t modified;
+	char * data = readSource(file, size, modified);
+	if(!data) {
+		return false;
+	}
+	
+	texturecache::Info info;
+	bool colorKey = (flags & Texture::HasColorKey);
+	if(!texturecache::getInfo(file, data, size, modified, colorKey, info)) {
+		free(data);
+		return false;
+	}
+	
+	Texture2D * texture = GRenderer->CreateTexture2D();
+	if(!texture || !setPlaceholder(texture, info.placeholder)) {
+		delete texture;
+		free(data);
+		return false;
+	}
+	
+	delete tc->m_pTexture;
+	tc->m_pTexture = texture;
+	
+	// Report the real size right away as it is used to compute texture coordinates
+	tc->m_dwWidth = info.width;
+	tc->m_dwHeight = info.height;
+	tc->uv = Vec2f::ONE;
+	tc->hd = Vec2f(.5f / info.width, .5f / info.height);
+	
+	Entry & entry = entries[tc];
+	entry.file = file;
+	entry.flags = flags;
+	entry.average = info.placeholder;
+	entry.memory = 0;
+	entry.lastUsed = tc->m_lastUsedFrame;
+	
+	request(tc, entry, data, size, modified);
+	
+	return true;
+}
+
+void update() {
+	
+	ARX_PROFILE_FUNC();
+	
+	TextureContainer::s_currentFrame++;
+	
+	uploadResults(UPLOAD_BUDGET);
+	evictUnused();
+	reloadUsed();
+}
+
+void finish() {
+	
+	ARX_PROFILE_FUNC();
+	
+	while(pendingCount) {
+		uploadResults(0);
+		if(pendingCount) {
+			Thread::sleep(1);
+		}
+	}
+}
+
+void remove(TextureContainer * tc) {
+	
+	Entries::iterator it = entries.find(tc);
+	if(it == entries.end()) {
+		return;
+	}
+	
+	Entry & entry = it->second;
+	switch(entry.state) {
+		case Pending: {
+			pendingCount--;
+			// Don't bother decoding the texture if we haven't started yet
+			Autolock l(lock);
+			for(std::deque<Request>::iterator i = requests.begin(); i != requests.end(); ++i) {
+				if(i->tc == tc && i->id == entry.id) {
+					free(i->data);
+					requests.erase(i);
+					break;
+				}
+			}
+			break;
+		}
+		case Resident: residentMemory -= entry.memory; break;
+		case Evicted: evictedCount--; break;
+	}
+	
+	entries.erase(it);
+}
+
+} // namespace texturestream
@@ -0,0 +1,67 @@
+/*
+ * Copyright 2013 Arx Libertatis Team (see the AUTHORS file)
+ *
+ * This file is part of Arx Libertatis.
+ *
+ * Arx Libertatis is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Arx Libertatis is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Arx Libertatis.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ARX_GRAPHICS_TEXTURE_TEXTURESTREAM_H
+#define ARX_GRAPHICS_TEXTURE_TEXTURESTREAM_H
+
+#include "graphics/texture/Texture.h"
+
+class TextureContainer;
+namespace res { class path; }
+
+/*!
+ * Background loading of textures.
+ * 
+ * Streamed textures are decoded by a worker thread while a single-pixel
+ * placeholder with the average color of the image is shown. Decoded images are
+ * uploaded from the main thread within a per-frame time budget. When the
+ * streamed textures use more memory than allowed, those that have not been
+ * used for a while are replaced with their placeholder again and reloaded
+ * once they are needed.
+ */
+namespace texturestream {
+
+//! Start the decoder thread. Textures are loaded synchronously until this is called.
+void init();
+
+//! Stop the decoder thread and drop all pending requests.
+void shutdown();
+
+/*!
+ * Start loading a texture in the background.
+ * The size of the texture container is set immediately.
+ * @return false if the texture cannot be streamed and should be loaded synchronously.
+ */
+bool load(TextureContainer * tc, const res::path & file, Texture::TextureFlags flags);
+
+/*!
+ * Upload decoded textures and evict unused ones.
+ * Must be called from the main thread once per frame.
+ */
+void update();
+
+//! Wait until all pending textures have been decoded and uploaded.
+void finish();
+
+//! Forget a texture container - must be called before it is deleted.
+void remove(TextureContainer * tc);
+
+} // namespace texturestream
+
+#endif // ARX_GRAPHICS_TEXTURE_TEXTURESTREAM_H
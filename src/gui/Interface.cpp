@@ -346,7 +346,7 @@ void manageQuestBook() {
 	if(questBook.text().empty() && !PlayerQuest.empty()) {
 		std::string text;
 		for(size_t i = 0; i < PlayerQuest.size(); ++i) {
-			std::string quest = getLocalised(PlayerQuest[i].ident);
+			const std::string & quest = getLocalised(PlayerQuest[i].ident);
 			if(!quest.empty()) {
 				text += quest;
 				text += "\n\n";
@@ -1390,16 +1390,14 @@ void ArxGame::manageEditorControls() {
 								}
 
 								if(temp->poisonous > 0 && temp->poisonous_count != 0) {
-									std::string Text = getLocalised("description_poisoned", "error");
 									std::stringstream ss;
-									ss << WILLADDSPEECH << " (" << Text << " " << (int)temp->poisonous << ")";
+									ss << WILLADDSPEECH << " (" << getLocalised("description_poisoned", "error") << " " << (int)temp->poisonous << ")";
 									WILLADDSPEECH = ss.str();
 								}
 
 								if ((temp->ioflags & IO_ITEM) && temp->durability < 100.f) {
-									std::string Text = getLocalised("description_durability", "error");
 									std::stringstream ss;
-									ss << WILLADDSPEECH << " " << Text << " " << std::fixed << std::setw(3) << std::setprecision(0) << temp->durability << std::setw(0) << "/" << std::setw(3) << temp->max_durability;
+									ss << WILLADDSPEECH << " " << getLocalised("description_durability", "error") << " " << std::fixed << std::setw(3) << std::setprecision(0) << temp->durability << std::setw(0) << "/" << std::setw(3) << temp->max_durability;
 									WILLADDSPEECH = ss.str();
 								}
 
@@ -3426,16 +3424,14 @@ void ArxGame::manageKeyMouse() {
 					}
 
 					if(temp->poisonous > 0 && temp->poisonous_count != 0) {
-						std::string Text = getLocalised("description_poisoned", "error");
 						std::stringstream ss;
-						ss << " (" << Text << " " << (int)temp->poisonous << ")";
+						ss << " (" << getLocalised("description_poisoned", "error") << " " << (int)temp->poisonous << ")";
 						WILLADDSPEECH += ss.str();
 					}
 
 					if((temp->ioflags & IO_ITEM) && temp->durability < 100.f) {
-						std::string Text = getLocalised("description_durability", "error");
 						std::stringstream ss;
-						ss << " " << Text << " " << std::fixed << std::setw(3) << std::setprecision(0) << temp->durability << "/" << temp->max_durability;
+						ss << " " << getLocalised("description_durability", "error") << " " << std::fixed << std::setw(3) << std::setprecision(0) << temp->durability << "/" << temp->max_durability;
 						WILLADDSPEECH += ss.str();
 					}
 
@@ -52,8 +52,10 @@ ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
 #include "core/Application.h"
 #include "core/Config.h"
 #include "core/GameTime.h"
+#include "core/Replay.h"
 #include "graphics/Math.h"
 #include "input/InputBackend.h"
+#include "input/NullInputBackend.h"
 #ifdef ARX_HAVE_DINPUT8
 #include "input/DInput8Backend.h"
 #endif
@@ -249,11 +251,24 @@ bool Input::init() {
 		}
 		#endif
 		
+		// The null backend is never used automatically unless there is no real window
+		bool nullBackend = (config.input.backend == "null")
+		                   || (autoBackend && config.window.framework == "null");
+		if(!backend && first && nullBackend) {
+			matched = true;
+			backend = new NullInputBackend;
+			if(!backend->init()) {
+				delete backend, backend = NULL;
+			}
+		}
+		
 		if(first && !matched) {
 			LogError << "Unknown backend: " << config.input.backend;
 		}
 	}
 	
+	backend = replay::wrapInputBackend(backend);
+	
 	return (backend != NULL);
 }
 
@@ -0,0 +1,56 @@
+/*
+ * Copyright 2013 Arx Libertatis Team (see the AUTHORS file)
+ *
+ * This file is part of Arx Libertatis.
+ *
+ * Arx Libertatis is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Arx Libertatis is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Arx Libertatis.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "input/NullInputBackend.h"
+
+#include "platform/Platform.h"
+
+bool NullInputBackend::getAbsoluteMouseCoords(int & absX, int & absY) const {
+	absX = 0, absY = 0;
+	return false;
+}
+
+void NullInputBackend::setAbsoluteMouseCoords(int absX, int absY) {
+	ARX_UNUSED(absX), ARX_UNUSED(absY);
+}
+
+void NullInputBackend::getRelativeMouseCoords(int & relX, int & relY, int & wheelDir) const {
+	relX = 0, relY = 0, wheelDir = 0;
+}
+
+bool NullInputBackend::isMouseButtonPressed(int buttonId, int & deltaTime) const {
+	ARX_UNUSED(buttonId);
+	deltaTime = 0;
+	return false;
+}
+
+void NullInputBackend::getMouseButtonClickCount(int buttonId, int & numClick, int & numUnClick) const {
+	ARX_UNUSED(buttonId);
+	numClick = 0, numUnClick = 0;
+}
+
+bool NullInputBackend::isKeyboardKeyPressed(int keyId) const {
+	ARX_UNUSED(keyId);
+	return false;
+}
+
+bool NullInputBackend::getKeyAsText(int keyId, char & result) const {
+	ARX_UNUSED(keyId), ARX_UNUSED(result);
+	return false;
+}
@@ -0,0 +1,160 @@
+/*
+ * Copyright 2013 Arx Libertatis Team (see the AUTHORS file)
+ *
+ * This file is part of Arx Libertatis.
+ *
+ * Arx Libertatis is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Arx Libertatis is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Arx Libertatis.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "io/IniTable.h"
+
+#include <cstring>
+
+#include "io/IniReader.h"
+#include "io/log/Logger.h"
+
+u32 IniTable::hash(const std::string & section, const std::string & key) {
+	
+	// FNV-1a over section + '\0' + key
+	u32 h = 2166136261u;
+	for(std::string::const_iterator i = section.begin(); i != section.end(); ++i) {
+		h = (h ^ u32((unsigned char)*i)) * 16777619u;
+	}
+	h = h * 16777619u;
+	for(std::string::const_iterator i = key.begin(); i != key.end(); ++i) {
+		h = (h ^ u32((unsigned char)*i)) * 16777619u;
+	}
+	
+	return h;
+}
+
+bool IniTable::equals(u32 offset, const std::string & str) const {
+	return str.empty() || !std::memcmp(&m_names[offset], str.data(), str.size());
+}
+
+const IniTable::Entry * IniTable::find(const std::string & section,
+                                       const std::string & key) const {
+	
+	if(m_entries.empty()) {
+		return NULL;
+	}
+	
+	u32 h = hash(section, key);
+	size_t mask = m_entries.size() - 1;
+	
+	for(size_t i = h & mask; ; i = (i + 1) & mask) {
+		
+		const Entry & entry = m_entries[i];
+		
+		if(entry.section == Empty) {
+			return NULL;
+		}
+		
+		if(entry.hash == h && entry.sectionSize == section.size() && entry.keySize == key.size()
+		   && equals(entry.section, section) && equals(entry.key, key)) {
+			return &entry;
+		}
+	}
+}
+
+void IniTable::insert(const std::string & section, const std::string & key, u32 value,
+                      u32 count) {
+	
+	u32 h = hash(section, key);
+	size_t mask = m_entries.size() - 1;
+	
+	size_t i = h & mask;
+	while(m_entries[i].section != Empty) {
+		i = (i + 1) & mask;
+	}
+	
+	Entry & entry = m_entries[i];
+	entry.hash = h;
+	entry.section = u32(m_names.size());
+	entry.sectionSize = u32(section.size());
+	m_names.insert(m_names.end(), section.begin(), section.end());
+	entry.key = u32(m_names.size());
+	entry.keySize = u32(key.size());
+	m_names.insert(m_names.end(), key.begin(), key.end());
+	entry.value = value;
+	entry.count = count;
+}
+
+void IniTable::build(const IniReader & reader) {
+	
+	clear();
+	
+	size_t keyCount = 0, nameSize = 0;
+	for(IniReader::iterator si = reader.begin(); si != reader.end(); ++si) {
+		keyCount += si->second.size() + 1;
+		nameSize += si->first.size();
+		for(IniSection::iterator ki = si->second.begin(); ki != si->second.end(); ++ki) {
+			nameSize += si->first.size() + ki->getName().size();
+		}
+	}
+	
+	// Keep the load factor at or below 50%
+	size_t size = 16;
+	while(size < keyCount * 2) {
+		size *= 2;
+	}
+	
+	Entry empty = { 0, Empty, 0, 0, 0, Empty, 0 };
+	m_entries.resize(size, empty);
+	m_names.reserve(nameSize);
+	m_values.reserve(keyCount);
+	
+	for(IniReader::iterator si = reader.begin(); si != reader.end(); ++si) {
+		
+		const IniSection & section = si->second;
+		
+		// The section entry maps an empty key to the first value, as IniReader does
+		u32 first = section.empty() ? Empty : u32(m_values.size());
+		insert(si->first, std::string(), first, u32(section.size()));
+		
+		for(IniSection::iterator ki = section.begin(); ki != section.end(); ++ki) {
+			if(find(si->first, ki->getName())) {
+				// IniSection returns the first matching key
+				continue;
+			}
+			insert(si->first, ki->getName(), u32(m_values.size()), 0);
+			m_values.push_back(ki->getValue());
+		}
+	}
+	
+	LogDebug("compiled " << m_values.size() << " ini values into a table of size " << size);
+}
+
+void IniTable::clear() {
+	m_entries.clear();
+	m_names.clear();
+	m_values.clear();
+}
+
+const std::string * IniTable::get(const std::string & section, const std::string & key) const {
+	
+	const Entry * entry = find(section, key);
+	if(!entry || entry->value == Empty) {
+		return NULL;
+	}
+	
+	return &m_values[entry->value];
+}
+
+size_t IniTable::getKeyCount(const std::string & section) const {
+	
+	const Entry * entry = find(section, std::string());
+	
+	return entry ? entry->count : 0;
+}
@@ -0,0 +1,95 @@
+/*
+ * Copyright 2013 Arx Libertatis Team (see the AUTHORS file)
+ *
+ * This file is part of Arx Libertatis.
+ *
+ * Arx Libertatis is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Arx Libertatis is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Arx Libertatis.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ARX_IO_INITABLE_H
+#define ARX_IO_INITABLE_H
+
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+#include "platform/Platform.h"
+
+class IniReader;
+
+/*!
+ * Read-only lookup table compiled from the contents of an IniReader.
+ * 
+ * All section and key names are stored in a single string arena and indexed
+ * by one open-addressing hash table, so lookups are O(1) and never allocate.
+ * Values are stored once and the returned references remain valid until
+ * the table is cleared or rebuilt.
+ */
+class IniTable {
+	
+	struct Entry {
+		u32 hash;
+		u32 section;      //!< Offset of the section name in the name arena or Empty.
+		u32 sectionSize;
+		u32 key;          //!< Offset of the key name in the name arena.
+		u32 keySize;
+		u32 value;        //!< Index into the values array or Empty.
+		u32 count;        //!< Number of keys in the section (only for the section entry).
+	};
+	
+	static const u32 Empty = u32(-1);
+	
+	std::vector<Entry> m_entries;
+	std::vector<char> m_names;
+	std::vector<std::string> m_values;
+	
+	static u32 hash(const std::string & section, const std::string & key);
+	
+	bool equals(u32 offset, const std::string & str) const;
+	
+	const Entry * find(const std::string & section, const std::string & key) const;
+	
+	void insert(const std::string & section, const std::string & key, u32 value, u32 count);
+	
+public:
+	
+	/*!
+	 * Compile all sections and keys of an ini file.
+	 * Any previous contents are discarded.
+	 */
+	void build(const IniReader & reader);
+	
+	void clear();
+	
+	/*!
+	 * Get the value of a key.
+	 * @param key The key to look up. If this is empty, the first key in the section is used.
+	 * @return the value or NULL if there is no such key.
+	 */
+	const std::string * get(const std::string & section, const std::string & key) const;
+	
+	inline const std::string & get(const std::string & section, const std::string & key,
+	                               const std::string & defaultValue) const {
+		const std::string * value = get(section, key);
+		return value ? *value : defaultValue;
+	}
+	
+	//! @return the number of keys in the given section
+	size_t getKeyCount(const std::string & section) const;
+	
+	inline bool empty() const { return m_values.empty(); }
+	
+};
+
+#endif // ARX_IO_INITABLE_H
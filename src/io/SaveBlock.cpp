@@ -70,6 +70,15 @@ static const u32 SAV_COMP_DEFLATE = 2;
 
 static const u32 SAV_SIZE_UNKNOWN = 0xffffffff;
 
+//! Size of the buffer used to stream stored file data
+static const size_t SAV_IO_BUFFER_SIZE = 16 * 1024;
+
+/*!
+ * Only defragment when more than half of the save block is unused and the unused space
+ * is at least this large, or when files are split into more than two chunks on average.
+ */
+static const size_t SAV_DEFRAG_MIN_WASTED = 1024 * 1024;
+
 #ifdef ARX_DEBUG
 static const char BADSAVCHAR[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ\\/.";
 #endif
@@ -177,72 +186,213 @@ void SaveBlock::File::writeEntry(std::ostream & handle, const std::string & name
 	
 }
 
+/*!
+ * Reads the stored data of a file chunk by chunk.
+ * Data is either read into a caller-provided buffer or into a small bounded
+ * internal buffer so that large files never need to be loaded at once.
+ */
+class SaveBlock::File::ChunkReader {
+	
+	std::istream & m_handle;
+	const File & m_file;
+	
+	size_t m_chunk; //!< Index of the current chunk
+	size_t m_chunkPos; //!< Read position in the current chunk
+	size_t m_offset; //!< Number of stored bytes read so far
+	bool m_seek;
+	
+	char m_buffer[SAV_IO_BUFFER_SIZE];
+	
+public:
+	
+	ChunkReader(std::istream & handle, const File & file)
+		: m_handle(handle), m_file(file), m_chunk(0), m_chunkPos(0), m_offset(0), m_seek(true) { }
+	
+	/*!
+	 * Read up to size bytes of stored data.
+	 * @return the number of bytes read - only less than size at the end of the data or on error
+	 */
+	size_t read(char * buf, size_t size) {
+		
+		size_t total = 0;
+		
+		while(size != 0 && m_chunk < m_file.chunks.size()) {
+			
+			const Chunk & chunk = m_file.chunks[m_chunk];
+			if(m_chunkPos == chunk.size) {
+				m_chunk++, m_chunkPos = 0, m_seek = true;
+				continue;
+			}
+			
+			if(m_seek) {
+				m_handle.seekg(chunk.offset + 4 + m_chunkPos);
+				m_seek = false;
+			}
+			
+			size_t count = min(size, chunk.size - m_chunkPos);
+			if(m_handle.read(buf, count).fail()) {
+				m_chunk = m_file.chunks.size();
+				break;
+			}
+			
+			buf += count, size -= count, total += count;
+			m_chunkPos += count, m_offset += count;
+		}
+		
+		return total;
+	}
+	
+	/*!
+	 * Read the next block of stored data into the internal buffer.
+	 * @return the internal buffer, only valid until the next call
+	 */
+	char * next(size_t & count) {
+		count = read(m_buffer, sizeof(m_buffer));
+		return m_buffer;
+	}
+	
+	//! @return the number of stored bytes read so far
+	size_t offset() const { return m_offset; }
+	
+	//! Input callback for blast() that reads and decrypts the chunks on the fly.
+	static size_t blastIn(void * param, const unsigned char ** buf) {
+		
+		ChunkReader & reader = *reinterpret_cast<ChunkReader *>(param);
+		
+		// Every even byte (relative to the start of the stored data) is inverted
+		size_t offset = reader.offset();
+		size_t count;
+		unsigned char * crypt = reinterpret_cast<unsigned char *>(reader.next(count));
+		for(size_t i = (offset & 1); i < count; i += 2) {
+			crypt[i] = ~crypt[i];
+		}
+		
+		*buf = crypt;
+		return count;
+	}
+	
+};
+
 char * SaveBlock::File::loadData(std::istream & handle, size_t & size, const std::string & name) const {
 	
-	LogDebug("Loading " << name << ' ' << storedSize << "b in " << chunks.size() << " chunks, "
-	         << compressionName() << " -> " << (int)uncompressedSize << "b");
+	if(comp == File::ImplodeCrypt && uncompressedSize == size_t(-1)) {
+		
+		LogDebug("Loading " << name << ' ' << storedSize << "b in " << chunks.size() << " chunks, "
+		         << compressionName() << " -> unknown size");
+		
+		// Old savegames don't store the uncompressed size - grow the buffer as needed
+		ChunkReader reader(handle, *this);
+		BlastMemOutBufferRealloc out;
+		BlastResult ret = blast(ChunkReader::blastIn, &reader, blastOutMemRealloc, &out);
+		if(ret != BLAST_SUCCESS) {
+			LogError << "Error decompressing imploded " << name << ": " << int(ret);
+			free(out.buf);
+			size = 0;
+			return NULL;
+		}
+		
+		size = out.fillSize;
+		return out.buf;
+	}
 	
-	char * buf = (char*)malloc(storedSize);
-	char * p = buf;
+	size = (comp == File::None) ? storedSize : uncompressedSize;
 	
-	for(File::ChunkList::const_iterator chunk = chunks.begin();
-	    chunk != chunks.end(); ++chunk) {
-		handle.seekg(chunk->offset + 4);
-		handle.read(p, chunk->size);
-		p += chunk->size;
+	char * buf = (char*)malloc(size);
+	
+	if(!loadData(handle, buf, size, name)) {
+		free(buf);
+		size = 0;
+		return NULL;
 	}
 	
-	arx_assert(p == buf + storedSize);
+	return buf;
+}
+
+bool SaveBlock::File::loadData(std::istream & handle, char * buf, size_t & size,
+                               const std::string & name) const {
+	
+	LogDebug("Loading " << name << ' ' << storedSize << "b in " << chunks.size() << " chunks, "
+	         << compressionName() << " -> " << (int)uncompressedSize << "b");
+	
+	ChunkReader reader(handle, *this);
 	
 	switch(comp) {
 		
 		case File::None: {
 			arx_assert(uncompressedSize == storedSize);
-			size = uncompressedSize;
-			return buf;
+			if(size < storedSize) {
+				LogError << "Buffer too small to load " << name;
+				size = 0;
+				return false;
+			}
+			size = reader.read(buf, storedSize);
+			if(size != storedSize) {
+				LogError << "Error reading " << name;
+				return false;
+			}
+			return true;
 		}
 		
 		case File::ImplodeCrypt: {
-			unsigned char * crypt = (unsigned char *)buf;
-			for(size_t i = 0; i < storedSize; i += 2) {
-				crypt[i] = ~crypt[i];
-			}
-			char * uncompressed = blastMemAlloc(buf, storedSize, size);
-			free(buf);
-			if(!uncompressed) {
-				LogError << "Error decompressing imploded " << name;
-				return NULL;
+			BlastMemOutBuffer out(buf, size);
+			BlastResult ret = blast(ChunkReader::blastIn, &reader, blastOutMem, &out);
+			if(ret != BLAST_SUCCESS) {
+				LogError << "Error decompressing imploded " << name << ": " << int(ret);
+				size = 0;
+				return false;
 			}
+			size -= out.size;
 			arx_assert(uncompressedSize == (size_t)-1 || size == uncompressedSize);
-			return uncompressed;
+			return true;
 		}
 		
 		case File::Deflate: {
+			
 			arx_assert(uncompressedSize != (size_t)-1);
-			uLongf decompressedSize = uncompressedSize;
-			char * uncompressed = (char*)malloc(uncompressedSize);
-			int ret = uncompress((Bytef*)uncompressed, &decompressedSize, (const Bytef*)buf, storedSize);
+			
+			z_stream strm;
+			strm.zalloc = Z_NULL, strm.zfree = Z_NULL, strm.opaque = Z_NULL;
+			strm.next_in = Z_NULL, strm.avail_in = 0;
+			int ret = inflateInit(&strm);
 			if(ret != Z_OK) {
 				LogError << "Error decompressing deflated " << name << ": " << zError(ret) << " (" << ret << ')';
-				free(buf);
-				free(uncompressed);
 				size = 0;
-				return NULL;
+				return false;
 			}
-			if(decompressedSize != uncompressedSize) {
-				LogError << "Unexpedect uncompressed size " << decompressedSize << " while loading "
+			
+			strm.next_out = (Bytef*)buf, strm.avail_out = size;
+			
+			do {
+				if(strm.avail_in == 0) {
+					size_t count;
+					strm.next_in = (Bytef*)reader.next(count), strm.avail_in = count;
+					if(count == 0) {
+						ret = Z_DATA_ERROR;
+						break;
+					}
+				}
+				ret = inflate(&strm, Z_NO_FLUSH);
+			} while(ret == Z_OK);
+			
+			size = strm.total_out;
+			inflateEnd(&strm);
+			
+			if(ret != Z_STREAM_END) {
+				LogError << "Error decompressing deflated " << name << ": " << zError(ret) << " (" << ret << ')';
+				size = 0;
+				return false;
+			}
+			if(size != uncompressedSize) {
+				LogError << "Unexpedect uncompressed size " << size << " while loading "
 				         << name << ", expected " << uncompressedSize;
 			}
-			size = decompressedSize;
-			free(buf);
-			return uncompressed;
+			return true;
 		}
 		
 		default: {
 			LogError << "Error decompressing " << name << ": unknown format";
-			free(buf);
 			size = 0;
-			return NULL;
+			return false;
 		}
 		
 	}
@@ -392,7 +542,7 @@ bool SaveBlock::flush(const string & important) {
 	arx_assert_msg(important.find_first_of(BADSAVCHAR) == string::npos,
 	               "bad save filename: \"%s\"", important.c_str());
 	
-	if((usedSize * 2 < totalSize || chunkCount > (files.size() * 4 / 3))) {
+	if(isFragmented()) {
 		defragment();
 	}
 	
@@ -403,6 +553,12 @@ bool SaveBlock::flush(const string & important) {
 	return handle.good();
 }
 
+bool SaveBlock::isFragmented() const {
+	size_t wasted = totalSize - usedSize;
+	return (usedSize * 2 < totalSize && wasted >= SAV_DEFRAG_MIN_WASTED)
+	       || chunkCount > files.size() * 2;
+}
+
 bool SaveBlock::defragment() {
 	
 	LogDebug("defragmenting " << savefile << " save: using " << usedSize << " / " << totalSize
@@ -431,26 +587,20 @@ bool SaveBlock::defragment() {
 			continue;
 		}
 		
-		char * buf = new char[file->second.storedSize];
-		char * p = buf;
-		
-		for(File::ChunkList::iterator chunk = file->second.chunks.begin();
-		    chunk != file->second.chunks.end(); ++chunk) {
-			handle.seekg(chunk->offset + 4);
-			handle.read(p, chunk->size);
-			p += chunk->size;
-		}
-		
-		arx_assert(p == buf + file->second.storedSize);
+		// Copy the chunks using a bounded buffer instead of loading the whole file
+		File::ChunkReader reader(handle, file->second);
+		size_t count;
+		do {
+			const char * buf = reader.next(count);
+			tempFile.write(buf, count);
+		} while(count != 0);
 		
-		tempFile.write(buf, file->second.storedSize);
+		arx_assert(reader.offset() == file->second.storedSize);
 		
 		file->second.chunks.resize(1);
 		file->second.chunks.front().offset = totalSize;
 		file->second.chunks.front().size = file->second.storedSize;
 		
-		delete[] buf;
-		
 		totalSize += file->second.storedSize;
 	}
 	
@@ -551,6 +701,31 @@ char * SaveBlock::load(const string & name, size_t & size) {
 	return (file == files.end()) ? NULL : file->second.loadData(handle, size, name);
 }
 
+bool SaveBlock::load(const string & name, char * buffer, size_t & size) {
+	
+	arx_assert_msg(name.find_first_of(BADSAVCHAR) == string::npos,
+	               "bad save filename: \"%s\"", name.c_str());
+	
+	Files::const_iterator file = files.find(name);
+	if(file == files.end()) {
+		size = 0;
+		return false;
+	}
+	
+	return file->second.loadData(handle, buffer, size, name);
+}
+
+size_t SaveBlock::getSize(const string & name) const {
+	
+	Files::const_iterator file = files.find(name);
+	if(file == files.end()) {
+		return size_t(-1);
+	}
+	
+	return (file->second.comp == File::None) ? file->second.storedSize
+	                                          : file->second.uncompressedSize;
+}
+
 bool SaveBlock::hasFile(const string & name) const {
 	arx_assert_msg(name.find_first_of(BADSAVCHAR) == string::npos,
 	               "bad save filename: \"%s\"", name.c_str());
@@ -568,33 +743,26 @@ vector<string> SaveBlock::getFiles() const {
 	return result;
 }
 
-char * SaveBlock::load(const fs::path & savefile, const std::string & filename, size_t & size) {
+bool SaveBlock::findFile(std::istream & handle, const fs::path & savefile,
+                         const std::string & filename, File & file) {
 	
 	arx_assert_msg(filename.find_first_of(BADSAVCHAR) == string::npos,
 	               "bad save filename: \"%s\"", filename.c_str());
 	
 	LogDebug("reading savefile " << savefile);
 	
-	size = 0;
-	
-	fs::ifstream handle(savefile, fs::fstream::in | fs::fstream::binary);
-	if(!handle.is_open()) {
-		LogWarning << "Cannot open save file " << savefile;
-		return NULL;
-	}
-	
 	u32 fatOffset;
 	if(fs::read(handle, fatOffset).fail()) {
-		return NULL;
+		return false;
 	}
 	if(handle.seekg(fatOffset + 4).fail()) {
 		LogError << "Cannot seek to FAT";
-		return NULL;
+		return false;
 	}
 	
 	u32 version;
 	if(fs::read(handle, version).fail()) {
-		return NULL;
+		return false;
 	}
 	if(version != SAV_VERSION_DEFLATE && version != SAV_VERSION_RELEASE && version != SAV_VERSION_NOEXT) {
 		LogWarning << "Unexpected savegame version: " << version << " for " << savefile;
@@ -602,17 +770,15 @@ char * SaveBlock::load(const fs::path & savefile, const std::string & filename,
 	
 	u32 nFiles;
 	if(fs::read(handle, nFiles).fail()) {
-		return NULL;
+		return false;
 	}
 	
-	File file;
-	
 	for(u32 i = 0; i < nFiles; i++) {
 		
 		// Read the file name.
 		string name;
 		if(fs::read(handle, name).fail()) {
-			return NULL;
+			return false;
 		}
 		if(version < SAV_VERSION_NOEXT) {
 			boost::to_lower(name);
@@ -622,7 +788,7 @@ char * SaveBlock::load(const fs::path & savefile, const std::string & filename,
 		}
 		
 		if(!file.loadOffsets(handle, version)) {
-			return NULL;
+			return false;
 		}
 		
 		if(!i && version == SAV_VERSION_OLD) {
@@ -634,8 +800,45 @@ char * SaveBlock::load(const fs::path & savefile, const std::string & filename,
 			continue;
 		}
 		
-		return file.loadData(handle, size, name);
+		return true;
+	}
+	
+	return false;
+}
+
+char * SaveBlock::load(const fs::path & savefile, const std::string & filename, size_t & size) {
+	
+	size = 0;
+	
+	fs::ifstream handle(savefile, fs::fstream::in | fs::fstream::binary);
+	if(!handle.is_open()) {
+		LogWarning << "Cannot open save file " << savefile;
+		return NULL;
+	}
+	
+	File file;
+	if(!findFile(handle, savefile, filename, file)) {
+		return NULL;
+	}
+	
+	return file.loadData(handle, size, filename);
+}
+
+bool SaveBlock::load(const fs::path & savefile, const std::string & filename, char * buffer,
+                     size_t & size) {
+	
+	fs::ifstream handle(savefile, fs::fstream::in | fs::fstream::binary);
+	if(!handle.is_open()) {
+		LogWarning << "Cannot open save file " << savefile;
+		size = 0;
+		return false;
+	}
+	
+	File file;
+	if(!findFile(handle, savefile, filename, file)) {
+		size = 0;
+		return false;
 	}
 	
-	return NULL;
+	return file.loadData(handle, buffer, size, filename);
 }
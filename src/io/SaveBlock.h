@@ -75,6 +75,8 @@ private:
 		
 		typedef std::vector<Chunk> ChunkList;
 		
+		class ChunkReader;
+		
 		enum Compression {
 			Unknown,
 			None,
@@ -95,6 +97,13 @@ private:
 		
 		char * loadData(std::istream & handle, size_t & size, const std::string & name) const;
 		
+		/*!
+		 * Decompress the file directly into the given buffer.
+		 * @param size the size of the buffer, will be set to the loaded size
+		 */
+		bool loadData(std::istream & handle, char * buf, size_t & size,
+		              const std::string & name) const;
+		
 	};
 	
 	typedef boost::unordered_map<std::string, File> Files;
@@ -106,10 +115,15 @@ private:
 	size_t chunkCount;
 	Files files;
 	
+	bool isFragmented() const;
 	bool defragment();
 	bool loadFileTable();
 	void writeFileTable(const std::string & important);
 	
+	//! Read the file table of a save block up to the entry for filename
+	static bool findFile(std::istream & handle, const fs::path & savefile,
+	                     const std::string & filename, File & file);
+	
 public:
 	
 	explicit SaveBlock(const fs::path & savefile);
@@ -141,6 +155,25 @@ public:
 	bool save(const std::string & name, const char * data, size_t size);
 	
 	char * load(const std::string & name, size_t & size);
+	
+	/*!
+	 * Load a file into a caller-provided buffer.
+	 * 
+	 * The stored chunks are streamed and decompressed directly into the buffer without
+	 * allocating any intermediate copies.
+	 * 
+	 * @param size the size of the buffer, will be set to the loaded size
+	 * @return false if the file doesn't exist, could not be decompressed or doesn't fit
+	 *         into the buffer.
+	 */
+	bool load(const std::string & name, char * buffer, size_t & size);
+	
+	/*!
+	 * Get the uncompressed size of a file.
+	 * @return the size or size_t(-1) if the file doesn't exist or the size is not known.
+	 */
+	size_t getSize(const std::string & name) const;
+	
 	bool hasFile(const std::string & name) const;
 	
 	std::vector<std::string> getFiles() const;
@@ -163,6 +196,16 @@ public:
 	 */
 	static char * load(const fs::path & savefile, const std::string & name, size_t & size);
 	
+	/*!
+	 * Load a single file from the save block into a caller-provided buffer.
+	 * 
+	 * @param size the size of the buffer, will be set to the loaded size
+	 * @return false if the save block could not be opened, doesn't contain the file or
+	 *         the file doesn't fit into the buffer.
+	 */
+	static bool load(const fs::path & savefile, const std::string & name, char * buffer,
+	                 size_t & size);
+	
 };
 
 #endif // ARX_IO_SAVEBLOCK_H
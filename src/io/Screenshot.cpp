@@ -47,60 +47,213 @@ ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
 #include "io/Screenshot.h"
 
 #include <cstdio>
+#include <deque>
 #include <string>
 #include <sstream>
 
 #include "graphics/Renderer.h"
 #include "graphics/image/Image.h"
 #include "io/fs/Filesystem.h"
+#include "io/log/Logger.h"
+#include "platform/Lock.h"
+#include "platform/Profiler.h"
+#include "platform/Thread.h"
+#include "platform/Time.h"
 
 using std::ostringstream;
 
+namespace {
+
+//! Maximum number of screenshots waiting to be written
+const size_t MAX_QUEUED_SCREENSHOTS = 4;
+
+//! Time to wait for new screenshots when the queue is empty, in milliseconds
+const unsigned WRITER_IDLE_INTERVAL = 10;
+
+struct ScreenshotJob {
+	Image * image;
+	fs::path file;
+	unsigned width; //!< Size to resize the image to, or 0 to keep the original size
+	unsigned height;
+	u64 requested; //!< Time of the screenshot request, in microseconds
+};
+
+class ScreenshotWriter : public StoppableThread {
+	
+	Lock lock;
+	std::deque<ScreenshotJob> jobs;
+	
+	bool writeNext() {
+		
+		ScreenshotJob job;
+		{
+			Autolock l(lock);
+			if(jobs.empty()) {
+				return false;
+			}
+			job = jobs.front();
+			jobs.pop_front();
+		}
+		
+		bool saved;
+		{
+			ARX_PROFILE("Write screenshot");
+			if(job.width && job.height) {
+				Image resized;
+				resized.ResizeFrom(*job.image, job.width, job.height);
+				saved = resized.save(job.file);
+			} else {
+				saved = job.image->save(job.file);
+			}
+		}
+		delete job.image;
+		
+		if(saved) {
+			u64 latency = Time::getElapsedUs(job.requested);
+			LogInfo << "Saved screenshot " << job.file << " in " << (latency / 1000) << "ms";
+		} else {
+			LogError << "Failed to save screenshot " << job.file;
+		}
+		
+		return true;
+	}
+	
+	void run() {
+		
+		profiler::registerThread("Screenshot Writer");
+		
+		while(!isStopRequested()) {
+			if(!writeNext()) {
+				sleep(WRITER_IDLE_INTERVAL);
+			}
+		}
+		
+		// Don't lose screenshots that were requested right before shutdown
+		while(writeNext()) { }
+	}
+	
+public:
+	
+	//! Queue an image to be written - takes ownership of the image.
+	bool add(const ScreenshotJob & job) {
+		
+		Autolock l(lock);
+		
+		if(jobs.size() >= MAX_QUEUED_SCREENSHOTS) {
+			return false;
+		}
+		
+		jobs.push_back(job);
+		
+		return true;
+	}
+	
+};
+
+ScreenshotWriter * writer = NULL;
+
+bool saveScreenshot(Image * image, const fs::path & file, unsigned width, unsigned height,
+                    u64 requested) {
+	
+	ScreenshotJob job;
+	job.image = image;
+	job.file = file;
+	job.width = width;
+	job.height = height;
+	job.requested = requested;
+	
+	if(writer && writer->add(job)) {
+		return true;
+	}
+	
+	if(writer) {
+		LogWarning << "Too many screenshots queued, dropping " << file;
+		delete image;
+		return false;
+	}
+	
+	// No background thread - save right away
+	bool saved;
+	if(width && height) {
+		Image resized;
+		resized.ResizeFrom(*image, width, height);
+		saved = resized.save(file);
+	} else {
+		saved = image->save(file);
+	}
+	delete image;
+	
+	return saved;
+}
+
+} // anonymous namespace
+
 static SnapShot * pSnapShot;
 
-SnapShot::SnapShot(const fs::path & name, bool replace) {
+SnapShot::SnapShot(const fs::path & _name, bool _replace)
+	: name(_name), replace(_replace), num(0) { }
+
+SnapShot::~SnapShot() { }
+
+fs::path SnapShot::nextFile() {
+	
+	if(replace) {
+		num = 0;
+	}
 	
-	int num = 0;
+	fs::path file;
 	
 	do {
 		
 		ostringstream oss;
-		oss << name.filename() << '_' << num << ".bmp";
+		oss << name.filename() << '_' << num << ".png";
 		
 		file = name.parent() / oss.str();
 		
 		num++;
 	} while(!replace && fs::exists(file));
 	
+	return file;
 }
 
-SnapShot::~SnapShot() { }
-
 bool SnapShot::GetSnapShot() {
 	
-	Image image;
+	u64 requested = Time::getUs();
+	
+	Image * image = new Image;
 	
-	if(!GRenderer->getSnapshot(image)) {
+	if(!GRenderer->getSnapshot(*image)) {
+		delete image;
 		return false;
 	}
 	
-	return image.save(file);
+	return saveScreenshot(image, nextFile(), 0, 0, requested);
 }
 
 bool SnapShot::GetSnapShotDim(int width, int height) {
 	
-	Image image;
+	u64 requested = Time::getUs();
+	
+	Image * image = new Image;
 	
-	if(!GRenderer->getSnapshot(image, width, height)) {
+	// Download the full image and resize it in the background
+	if(!GRenderer->getSnapshot(*image)) {
+		delete image;
 		return false;
 	}
 	
-	return image.save(file);
+	return saveScreenshot(image, nextFile(), width, height, requested);
 }
 
 void InitSnapShot(const fs::path & name) {
+	
 	FreeSnapShot();
+	
 	pSnapShot = new SnapShot(name);
+	
+	writer = new ScreenshotWriter();
+	writer->setThreadName("Screenshot Writer");
+	writer->start();
 }
 
 void GetSnapShot() {
@@ -110,5 +263,11 @@ void GetSnapShot() {
 }
 
 void FreeSnapShot() {
+	
+	if(writer) {
+		writer->stop();
+		delete writer, writer = NULL;
+	}
+	
 	delete pSnapShot, pSnapShot = NULL;
 }
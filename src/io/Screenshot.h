@@ -46,11 +46,21 @@ ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
 
 #include "io/fs/FilePath.h"
 
+/*!
+ * Screenshots are copied from the framebuffer on the calling thread and then
+ * resized, encoded and written to disk by a background thread, so that
+ * taking screenshots does not stall rendering.
+ */
 class SnapShot {
 	
 private:
 	
-	fs::path file;
+	fs::path name;
+	bool replace;
+	int num;
+	
+	//! Get the next screenshot filename
+	fs::path nextFile();
 	
 public:
 	
@@ -64,6 +74,7 @@ public:
 
 void InitSnapShot(const fs::path & name);
 void GetSnapShot();
+//! Wait until all queued screenshots have been written.
 void FreeSnapShot();
 
 #endif // ARX_IO_SCREENSHOT_H
@@ -54,6 +54,12 @@ bool is_regular_file(const path & p);
  */
 std::time_t last_write_time(const path & p);
 
+/*!
+ * Set the last write time of an existing file to the current time.
+ * @return true if the time was updated or false if there was an error.
+ */
+bool touch(const path & p);
+
 /*!
  * Get the size of a file.
  * @return the filesize or (u64)-1 if there was an error (file doesn't exist, ...).
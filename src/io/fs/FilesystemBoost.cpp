@@ -59,6 +59,12 @@ std::time_t last_write_time(const path & p) {
 	return ec ? 0 : time;
 }
 
+bool touch(const path & p) {
+	error_code ec;
+	fs_boost::last_write_time(p.string(), std::time(NULL), ec);
+	return !ec;
+}
+
 u64 file_size(const path & p) {
 	error_code ec;
 	uintmax_t size = fs_boost::file_size(p.string(), ec);
@@ -30,6 +30,7 @@
 #include <sys/errno.h>
 #include <dirent.h>
 #include <unistd.h>
+#include <utime.h>
 
 #include <boost/algorithm/string/case_conv.hpp>
 
@@ -64,6 +65,10 @@ std::time_t last_write_time(const path & p) {
 	return stat(p.string().c_str(), &buf) ? 0 : buf.st_mtime;
 }
 
+bool touch(const path & p) {
+	return !utime(p.string().c_str(), NULL);
+}
+
 u64 file_size(const path & p) {
 	struct stat buf;
 	return stat(p.string().c_str(), &buf) ? (u64)-1 : (u64)buf.st_size;
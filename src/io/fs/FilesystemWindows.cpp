@@ -110,6 +110,22 @@ std::time_t last_write_time(const path & p) {
 	return writeTime;
 }
 
+bool touch(const path & p) {
+	
+	HANDLE hFile = CreateFileA(p.string().c_str(), FILE_WRITE_ATTRIBUTES, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if(hFile == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+	
+	FILETIME now;
+	GetSystemTimeAsFileTime(&now);
+	BOOL res = SetFileTime(hFile, NULL, NULL, &now);
+	
+	::CloseHandle(hFile);
+	
+	return res != FALSE;
+}
+
 u64 file_size(const path & p) {
 	HANDLE hFile = CreateFileA(p.string().c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
 	if(hFile == INVALID_HANDLE_VALUE)
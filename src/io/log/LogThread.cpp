@@ -0,0 +1,77 @@
+/*
+ * Copyright 2013 Arx Libertatis Team (see the AUTHORS file)
+ *
+ * This file is part of Arx Libertatis.
+ *
+ * Arx Libertatis is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Arx Libertatis is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Arx Libertatis.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "io/log/LogThread.h"
+
+#include <stddef.h>
+
+#include "io/log/Logger.h"
+#include "platform/Thread.h"
+
+namespace logger {
+
+namespace {
+
+//! Time to wait for new messages when the queue is empty, in milliseconds
+const unsigned WRITER_IDLE_INTERVAL = 5;
+
+class WriterThread : public StoppableThread {
+	
+	void run() {
+		while(!isStopRequested()) {
+			if(Logger::writeQueued() == 0) {
+				sleep(WRITER_IDLE_INTERVAL);
+			}
+		}
+	}
+	
+};
+
+WriterThread * writer = NULL;
+
+} // anonymous namespace
+
+void startWriterThread() {
+	
+	if(writer) {
+		return;
+	}
+	
+	writer = new WriterThread();
+	writer->setThreadName("Log Writer");
+	writer->start();
+	
+	Logger::setAsync(true);
+}
+
+void stopWriterThread() {
+	
+	if(!writer) {
+		return;
+	}
+	
+	Logger::setAsync(false);
+	
+	writer->stop();
+	delete writer, writer = NULL;
+	
+	LogDebug("log queue high water mark: " << Logger::getQueueHighWaterMark());
+}
+
+} // namespace logger
@@ -0,0 +1,39 @@
+/*
+ * Copyright 2013 Arx Libertatis Team (see the AUTHORS file)
+ *
+ * This file is part of Arx Libertatis.
+ *
+ * Arx Libertatis is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Arx Libertatis is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Arx Libertatis.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ARX_IO_LOG_LOGTHREAD_H
+#define ARX_IO_LOG_LOGTHREAD_H
+
+namespace logger {
+
+/*!
+ * Start a background thread that writes out queued log messages
+ * and switch the logger to asynchronous mode.
+ */
+void startWriterThread();
+
+/*!
+ * Write out all remaining messages, switch back to synchronous logging
+ * and stop the writer thread.
+ */
+void stopWriterThread();
+
+} // namespace logger
+
+#endif // ARX_IO_LOG_LOGTHREAD_H
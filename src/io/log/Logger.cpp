@@ -31,7 +31,9 @@
 #include "io/log/LogBackend.h"
 #include "io/log/MsvcLogger.h"
 
+#include "platform/Atomic.h"
 #include "platform/Lock.h"
+#include "platform/MPSCQueue.h"
 #include "platform/ProgramOptions.h"
 
 #include "Configure.h"
@@ -59,14 +61,145 @@ struct LogManager {
 	
 	static logger::Source * getSource(const char * file);
 	static void deleteAllBackends();
+	
+	//! Pass a message to all backends - the lock must be held
+	static void dispatch(const char * file, int line, Logger::LogLevel level, const string & str);
+	
+	//! Pass all queued messages to the backends - the lock must be held
+	static size_t dispatchQueued();
+	
+	//! Non-zero if messages are queued for the writer thread - read without the lock
+	static volatile u32 async;
+	
+};
+
+/*!
+ * Lock-free cache of the log level for each source file.
+ * 
+ * Entries are never reassigned to a different file, and are invalidated by
+ * incrementing the generation whenever the log rules change.
+ */
+class LevelCache {
+	
+	struct Entry {
+		const char * volatile file;
+		volatile u32 value; //!< (generation << 8) | level
+	};
+	
+	static const size_t Size = 1024;
+	static const size_t MaxProbes = 8;
+	
+	Entry m_entries[Size];
+	volatile u32 m_generation;
+	
+	static size_t hash(const char * file) {
+		return (size_t(file) >> 3) * 2654435761u;
+	}
+	
+public:
+	
+	LevelCache() : m_generation(0) {
+		std::memset((void *)m_entries, 0, sizeof(m_entries));
+	}
+	
+	bool get(const char * file, Logger::LogLevel & level) const {
+		
+		u32 generation = platform::atomicLoad(&m_generation) & 0xffffff;
+		
+		size_t index = hash(file);
+		for(size_t i = 0; i < MaxProbes; i++, index++) {
+			const Entry & entry = m_entries[index % Size];
+			const char * entryFile = platform::atomicLoad(&entry.file);
+			if(entryFile == file) {
+				u32 value = platform::atomicLoad(&entry.value);
+				if((value >> 8) != generation) {
+					return false;
+				}
+				level = Logger::LogLevel(value & 0xff);
+				return true;
+			} else if(!entryFile) {
+				return false;
+			}
+		}
+		
+		return false;
+	}
+	
+	//! Must only be called while holding LogManager::lock
+	void set(const char * file, Logger::LogLevel level) {
+		
+		u32 value = ((m_generation & 0xffffff) << 8) | u32(level);
+		
+		size_t index = hash(file);
+		for(size_t i = 0; i < MaxProbes; i++, index++) {
+			Entry & entry = m_entries[index % Size];
+			if(entry.file == file) {
+				platform::atomicStore(&entry.value, value);
+				return;
+			} else if(!entry.file) {
+				platform::atomicStore(&entry.value, value);
+				platform::atomicStore(&entry.file, file);
+				return;
+			}
+		}
+	}
+	
+	//! Must only be called while holding LogManager::lock
+	void invalidate() {
+		platform::atomicAdd(&m_generation, 1);
+	}
+	
 };
 
+LevelCache g_levelCache;
+
+struct QueuedMessage {
+	const char * file;
+	int line;
+	Logger::LogLevel level;
+	string str;
+};
+
+/*!
+ * Formatted log messages waiting to be written.
+ * 
+ * Producers reserve slots without locking, the consumer must hold LogManager::lock.
+ */
+typedef platform::MPSCQueue<QueuedMessage, 1024> MessageQueue;
+
+MessageQueue g_messageQueue;
+
+struct Dispatch {
+	void operator()(const QueuedMessage & message) const {
+		LogManager::dispatch(message.file, message.line, message.level, message.str);
+	}
+};
+
+//! @return false if the queue is full
+bool queueMessage(const char * file, int line, Logger::LogLevel level, const string & str) {
+	
+	u32 ticket;
+	QueuedMessage * message = g_messageQueue.reserve(ticket);
+	if(!message) {
+		return false;
+	}
+	
+	message->file = file;
+	message->line = line;
+	message->level = level;
+	message->str = str;
+	g_messageQueue.commit(ticket);
+	
+	return true;
+}
+
 const Logger::LogLevel LogManager::defaultLevel = Logger::Info;
 Logger::LogLevel LogManager::minimumLevel = LogManager::defaultLevel;
 LogManager::Sources LogManager::sources;
 LogManager::Backends LogManager::backends;
 LogManager::Rules LogManager::rules;
 Lock LogManager::lock;
+volatile u32 LogManager::async = 0;
 
 logger::Source * LogManager::getSource(const char * file) {
 	
@@ -112,6 +245,19 @@ logger::Source * LogManager::getSource(const char * file) {
 	return source;
 }
 
+void LogManager::dispatch(const char * file, int line, Logger::LogLevel level, const string & str) {
+	
+	const logger::Source * source = getSource(file);
+	
+	for(Backends::const_iterator i = backends.begin(); i != backends.end(); ++i) {
+		(*i)->log(*source, line, level, str);
+	}
+}
+
+size_t LogManager::dispatchQueued() {
+	return g_messageQueue.consume(Dispatch());
+}
+
 void LogManager::deleteAllBackends() {
 	for(Backends::const_iterator i = backends.begin(); i != backends.end(); ++i) {
 		delete *i;
@@ -146,9 +292,17 @@ bool Logger::isEnabled(const char * file, LogLevel level) {
 		return false;
 	}
 	
+	LogLevel sourceLevel;
+	if(g_levelCache.get(file, sourceLevel)) {
+		return (sourceLevel <= level);
+	}
+	
 	Autolock lock(LogManager::lock);
 	
-	return (LogManager::getSource(file)->level <= level);
+	sourceLevel = LogManager::getSource(file)->level;
+	g_levelCache.set(file, sourceLevel);
+	
+	return (sourceLevel <= level);
 }
 
 void Logger::log(const char * file, int line, LogLevel level, const string & str) {
@@ -157,16 +311,57 @@ void Logger::log(const char * file, int line, LogLevel level, const string & str
 		return;
 	}
 	
+	if(platform::atomicLoad(&LogManager::async) && level != Critical) {
+		if(queueMessage(file, line, level, str)) {
+			return;
+		}
+		// The queue is full - make room ourselves
+		// Messages from this thread that are still queued must be written first
+		Autolock lock(LogManager::lock);
+		do {
+			LogManager::dispatchQueued();
+		} while(!queueMessage(file, line, level, str));
+		return;
+	}
+	
 	Autolock lock(LogManager::lock);
 	
-	const logger::Source * source = LogManager::getSource(file);
+	LogManager::dispatchQueued();
+	LogManager::dispatch(file, line, level, str);
 	
-	for(LogManager::Backends::const_iterator i = LogManager::backends.begin();
-		  i != LogManager::backends.end(); ++i) {
-		(*i)->log(*source, line, level, str);
+	if(level == Critical) {
+		for(LogManager::Backends::const_iterator i = LogManager::backends.begin();
+		    i != LogManager::backends.end(); ++i) {
+			(*i)->flush();
+		}
+	}
+}
+
+void Logger::setAsync(bool async) {
+	
+	Autolock lock(LogManager::lock);
+	
+	LogManager::dispatchQueued();
+	platform::atomicStore(&LogManager::async, async ? 1 : 0);
+}
+
+size_t Logger::writeQueued() {
+	
+	Autolock lock(LogManager::lock);
+	
+	size_t count = LogManager::dispatchQueued();
+	if(count != 0) {
+		for(LogManager::Backends::const_iterator i = LogManager::backends.begin();
+		    i != LogManager::backends.end(); ++i) {
+			(*i)->flush();
+		}
 	}
 	
-	LogManager::lock.unlock();
+	return count;
+}
+
+size_t Logger::getQueueHighWaterMark() {
+	return g_messageQueue.highWaterMark();
 }
 
 void Logger::set(const string & prefix, Logger::LogLevel level) {
@@ -199,6 +394,7 @@ void Logger::set(const string & prefix, Logger::LogLevel level) {
 	LogManager::minimumLevel = std::min(LogManager::minimumLevel, level);
 	
 	LogManager::sources.clear();
+	g_levelCache.invalidate();
 }
 
 void Logger::reset(const string & prefix) {
@@ -221,12 +417,15 @@ void Logger::reset(const string & prefix) {
 	LogManager::rules.erase(i);
 	
 	LogManager::sources.clear();
+	g_levelCache.invalidate();
 }
 
 void Logger::flush() {
 	
 	Autolock lock(LogManager::lock);
 	
+	LogManager::dispatchQueued();
+	
 	for(LogManager::Backends::const_iterator i = LogManager::backends.begin();
 	    i != LogManager::backends.end(); ++i) {
 		(*i)->flush();
@@ -296,7 +495,11 @@ void Logger::shutdown() {
 	
 	Autolock lock(LogManager::lock);
 	
+	LogManager::dispatchQueued();
+	platform::atomicStore(&LogManager::async, 0);
+	
 	LogManager::sources.clear();
+	g_levelCache.invalidate();
 	LogManager::rules.clear();
 	
 	LogManager::minimumLevel = LogManager::defaultLevel;
@@ -305,6 +508,15 @@ void Logger::shutdown() {
 }
 
 void Logger::quickShutdown() {
+	
+	// Don't wait for the lock, the crashed thread might hold it.
+	// Only one thread may consume the message queue at a time - if the writer thread has
+	// the lock it is already writing the queued messages.
+	if(LogManager::lock.tryLock()) {
+		LogManager::dispatchQueued();
+		LogManager::lock.unlock();
+	}
+	
 	for(LogManager::Backends::const_iterator i = LogManager::backends.begin();
 	    i != LogManager::backends.end(); ++i) {
 		(*i)->quickShutdown();
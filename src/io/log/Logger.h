@@ -165,6 +165,24 @@ public:
 	 */
 	static void flush();
 	
+	/*!
+	 * Enable or disable asynchronous logging.
+	 * 
+	 * While enabled, log messages (except critical ones) are only queued and must be
+	 * passed to the backends by calling writeQueued(), usually from a dedicated thread.
+	 * Messages are still written synchronously if the queue is full.
+	 */
+	static void setAsync(bool async);
+	
+	/*!
+	 * Pass all queued log messages to the backends and flush them.
+	 * @return the number of messages written.
+	 */
+	static size_t writeQueued();
+	
+	//! @return the maximum number of messages that were queued at once.
+	static size_t getQueueHighWaterMark();
+	
 	/*!
 	* Helper class to pass a C string that might be NULL to the logger.
 	* If the pointer is NULL, the string "NULL" is logged.
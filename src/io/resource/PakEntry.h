@@ -20,6 +20,7 @@
 #ifndef ARX_IO_RESOURCE_PAKENTRY_H
 #define ARX_IO_RESOURCE_PAKENTRY_H
 
+#include <ctime>
 #include <string>
 #include <map>
 
@@ -56,6 +57,9 @@ public:
 	
 	virtual PakFileHandle * open() const = 0;
 	
+	//! @return the last write time of the file or of the archive containing it
+	virtual std::time_t modified() const = 0;
+	
 };
 
 class PakDirectory {
@@ -75,16 +75,20 @@ class UncompressedFile : public PakFile {
 	
 	std::istream & archive;
 	size_t offset;
+	std::time_t archiveTime;
 	
 public:
 	
-	explicit UncompressedFile(std::istream * _archive, size_t _offset, size_t size)
-		: PakFile(size), archive(*_archive), offset(_offset) { }
+	explicit UncompressedFile(std::istream * _archive, size_t _offset, size_t size,
+	                          std::time_t _archiveTime)
+		: PakFile(size), archive(*_archive), offset(_offset), archiveTime(_archiveTime) { }
 	
 	void read(void * buf) const;
 	
 	PakFileHandle * open() const;
 	
+	std::time_t modified() const { return archiveTime; }
+	
 	friend class UncompressedFileHandle;
 	
 };
@@ -176,17 +180,21 @@ class CompressedFile : public PakFile {
 	std::ifstream & archive;
 	size_t offset;
 	size_t storedSize;
+	std::time_t archiveTime;
 	
 public:
 	
 	explicit CompressedFile(std::ifstream * _archive, size_t _offset, size_t size,
-	                        size_t _storedSize)
-		: PakFile(size), archive(*_archive), offset(_offset), storedSize(_storedSize) { }
+	                        size_t _storedSize, std::time_t _archiveTime)
+		: PakFile(size), archive(*_archive), offset(_offset), storedSize(_storedSize),
+		  archiveTime(_archiveTime) { }
 	
 	void read(void * buf) const;
 	
 	PakFileHandle * open() const;
 	
+	std::time_t modified() const { return archiveTime; }
+	
 	friend class CompressedFileHandle;
 	
 };
@@ -376,6 +384,8 @@ public:
 	
 	PakFileHandle * open() const;
 	
+	std::time_t modified() const { return fs::last_write_time(path); }
+	
 };
 
 class PlainFileHandle : public PakFileHandle {
@@ -487,6 +497,8 @@ bool PakReader::addArchive(const fs::path & pakfile) {
 	}
 	release |= key;
 	
+	std::time_t archiveTime = fs::last_write_time(pakfile);
+	
 	char * pos = fat;
 	
 	paks.push_back(ifs);
@@ -531,9 +543,9 @@ bool PakReader::addArchive(const fs::path & pakfile) {
 			const u32 PAK_FILE_COMPRESSED = 1;
 			PakFile * file;
 			if((flags & PAK_FILE_COMPRESSED) && size != 0) {
-				file = new CompressedFile(ifs, offset, uncompressedSize, size);
+				file = new CompressedFile(ifs, offset, uncompressedSize, size, archiveTime);
 			} else {
-				file = new UncompressedFile(ifs, offset, size);
+				file = new UncompressedFile(ifs, offset, size, archiveTime);
 			}
 			
 			dir->addFile(std::string(filename, len), file);
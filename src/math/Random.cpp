@@ -21,12 +21,74 @@
 
 #include <ctime>
 
-Random::Generator Random::rng;
+#include "platform/Atomic.h"
+
+ARX_THREAD_LOCAL Random::Generator Random::rng;
+u64 Random::baseSeed = 0;
+u32 Random::epoch = 1;
+
+namespace {
+
+// Stream used by the thread that calls Random::seed().
+const u64 mainStream = 0;
+
+// Number of other threads that have seeded their generator.
+volatile u32 seededThreads = 0;
+
+template <class Generator>
+void fillGenerator(Generator & rng, float * begin, float * end, float min, float max) {
+	
+	// Work on a local copy so the state can stay in registers for the whole batch.
+	Generator local = rng;
+	
+	for(float * it = begin; it != end; ++it) {
+		*it = detail::uniformReal(local, min, max);
+	}
+	
+	rng = local;
+}
+
+u64 hashName(const char * name) {
+	u64 hash = 0xcbf29ce484222325ull;
+	for(; *name; name++) {
+		hash ^= u64(u8(*name));
+		hash *= 0x100000001b3ull;
+	}
+	return hash;
+}
+
+} // anonymous namespace
+
+void Random::seedThread() {
+	// Other threads get their own stream, numbered in the order they first use the generator.
+	u32 index = platform::atomicAdd(&seededThreads, 1);
+	rng.seed(baseSeed, mainStream + index);
+}
+
+void Random::fill(float * begin, float * end, float min, float max) {
+	fillGenerator(generator(), begin, end, min, max);
+}
 
 void Random::seed() {
-	rng.seed((size_t)std::time(NULL));
+	seed((unsigned int)std::time(NULL));
 }
 
 void Random::seed(unsigned int seedVal) {
-	rng.seed(seedVal);
+	baseSeed = seedVal;
+	epoch++;
+	rng.seed(baseSeed, mainStream);
+}
+
+RandomStream::RandomStream(const char * name)
+	: m_id(hashName(name)), m_epoch(0) {
+	m_rng.state = m_rng.inc = 0;
+}
+
+void RandomStream::restart() {
+	m_rng.seed(Random::baseSeed, m_id);
+	m_epoch = Random::epoch;
+}
+
+void RandomStream::fill(float * begin, float * end, float min, float max) {
+	fillGenerator(generator(), begin, end, min, max);
 }
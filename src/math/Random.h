@@ -16,63 +16,136 @@
  * You should have received a copy of the GNU General Public License
  * along with Arx Libertatis.  If not, see <http://www.gnu.org/licenses/>.
  */
-
 #ifndef ARX_MATH_RANDOM_H
 #define ARX_MATH_RANDOM_H
 
+#include <cstddef>
+#include <iterator>
 #include <limits>
 
-#include <boost/version.hpp>
-#include <boost/random/mersenne_twister.hpp>
-
-#if BOOST_VERSION >= 104700 // 1.47
-
-#include <boost/random/uniform_int_distribution.hpp>
-#include <boost/random/uniform_real_distribution.hpp>
+#include "platform/Platform.h"
 
 namespace detail {
 
-// not boost 1.47 still has the old sybols put presumably they will be deprecated at some point
-
-typedef boost::random::mt19937 mt19937;
-
-template <typename IntType>
-struct uniform_int_distribution {
-	typedef boost::random::uniform_int_distribution<IntType> type;
+/*!
+ * PCG32 (XSH RR) generator: 64 bits of state, 32-bit output and 2^63 selectable streams.
+ * This is a POD so that it can live in thread-local storage.
+ */
+struct PCG32 {
+	
+	u64 state;
+	u64 inc; //!< Stream selector, always odd once seeded.
+	
+	void seed(u64 initState, u64 stream) {
+		state = 0;
+		inc = (stream << 1) | 1;
+		next();
+		state += initState;
+		next();
+	}
+	
+	u32 next() {
+		u64 old = state;
+		state = old * 6364136223846793005ull + inc;
+		u32 xorshifted = u32(((old >> 18) ^ old) >> 27);
+		u32 rot = u32(old >> 59);
+		return (xorshifted >> rot) | (xorshifted << ((0u - rot) & 31));
+	}
+	
+	//! Uniform value in [0, range] without modulo bias.
+	u64 uniform(u64 range) {
+		
+		if(range <= 0xffffffffull) {
+			
+			if(range == 0xffffffffull) {
+				return next();
+			}
+			
+			// Lemire's multiply-shift with rejection of the biased low values
+			u32 bound = u32(range) + 1;
+			u64 m = u64(next()) * bound;
+			if(u32(m) < bound) {
+				u32 threshold = (0u - bound) % bound;
+				while(u32(m) < threshold) {
+					m = u64(next()) * bound;
+				}
+			}
+			return m >> 32;
+		}
+		
+		if(range == std::numeric_limits<u64>::max()) {
+			return next64();
+		}
+		
+		u64 bound = range + 1;
+		u64 threshold = (0ull - bound) % bound;
+		u64 value;
+		do {
+			value = next64();
+		} while(value < threshold);
+		return value % bound;
+	}
+	
+	u64 next64() {
+		u64 high = next();
+		return (high << 32) | next();
+	}
+	
+	//! Uniform value in [0, 1).
+	float unitFloat() {
+		return float(next() >> 8) * (1.f / 16777216.f);
+	}
+	
+	//! Uniform value in [0, 1).
+	double unitDouble() {
+		u64 high = next() >> 5;
+		u64 low = next() >> 6;
+		return double((high << 26) | low) * (1.0 / 9007199254740992.0);
+	}
+	
 };
 
-template <typename RealType>
-struct uniform_real_distribution {
-	typedef boost::random::uniform_real_distribution<RealType> type;
+template <class RealType>
+struct UnitReal {
+	static RealType get(PCG32 & rng) { return RealType(rng.unitDouble()); }
 };
 
-} // namespace detail
-
-#else
-
-#include <boost/random/uniform_int.hpp>
-#include <boost/random/uniform_real.hpp>
-
-namespace detail {
-
-typedef boost::mt19937 mt19937;
-
-template <typename IntType>
-struct uniform_int_distribution {
-	typedef boost::uniform_int<IntType> type;
+template <>
+struct UnitReal<float> {
+	static float get(PCG32 & rng) { return rng.unitFloat(); }
 };
 
-template <typename RealType>
-struct uniform_real_distribution {
-	typedef boost::uniform_real<RealType> type;
-};
+template <class IntType>
+inline IntType uniformInt(PCG32 & rng, IntType min, IntType max) {
+	// The difference is exact modulo 2^64 even for negative signed values.
+	u64 range = u64(max) - u64(min);
+	return IntType(u64(min) + rng.uniform(range));
+}
+
+//! Uniform value in [min, max). Values that round up to max are drawn again.
+template <class RealType>
+inline RealType uniformReal(PCG32 & rng, RealType min, RealType max) {
+	RealType range = max - min;
+	RealType value;
+	do {
+		value = min + UnitReal<RealType>::get(rng) * range;
+	} while(value >= max && min < max);
+	return value;
+}
 
 } // namespace detail
 
-#endif
+class RandomStream;
 
 /*!
  * Random number generator.
+ * 
+ * Every thread has its own generator, so this can be used from worker threads
+ * without locking. The generator of the thread calling seed(unsigned int) produces
+ * a reproducible sequence; other threads are seeded lazily from the same base seed
+ * and a stream numbered in the order in which they first use the generator. Use
+ * RandomStream for sequences that should not depend on which thread runs or on what
+ * other code consumes.
  */
 class Random {
 	
@@ -87,6 +160,9 @@ public:
 	template <class RealType> static inline RealType getf(RealType realMin, RealType realMax);
 	static inline float getf(float realMin = 0.0f, float realMax = 1.0f);
 
+	/// Fills [begin, end) with random floating point values in the range [realMin, realMax).
+	static void fill(float * begin, float * end, float realMin = 0.0f, float realMax = 1.0f);
+
 	/// Return a random iterator pointing in the range [begin, end).
 	template <class Iterator>
 	static inline Iterator getIterator(Iterator begin, Iterator end);
@@ -102,21 +178,72 @@ public:
 	/// Seed the random number generator using the current time.
 	static void seed();
 
-	/// Seed the random number generator with the given value.
+	/// Seed the random number generator and all named streams with the given value.
 	static void seed(unsigned int seedVal);
 
 private:
 	
-	typedef detail::mt19937 Generator;
+	typedef detail::PCG32 Generator;
+	
+	static inline Generator & generator();
+	
+	static void seedThread();
+	
+	static ARX_THREAD_LOCAL Generator rng;
+	
+	//! Base seed for threads and streams.
+	static u64 baseSeed;
+	
+	//! Incremented on every seed so that streams know when to restart.
+	static u32 epoch;
+	
+	friend class RandomStream;
+};
+
+/*!
+ * Named, independently seeded random number sequence.
+ * 
+ * Two streams with the same name produce the same values after every call to
+ * Random::seed(unsigned int), no matter what else uses the global generator.
+ * Streams are not synchronized: use each one from only one thread at a time.
+ */
+class RandomStream {
+	
+public:
+	
+	explicit RandomStream(const char * name);
+	
+	template <typename IntType> inline IntType get(IntType min, IntType max);
+	inline int get(int min = 0, int max = std::numeric_limits<int>::max());
+	
+	template <class RealType> inline RealType getf(RealType realMin, RealType realMax);
+	inline float getf(float realMin = 0.0f, float realMax = 1.0f);
+	
+	void fill(float * begin, float * end, float realMin = 0.0f, float realMax = 1.0f);
+	
+private:
+	
+	inline Random::Generator & generator();
+	
+	void restart();
 	
-	static Generator rng;
+	u64 m_id;
+	u32 m_epoch;
+	Random::Generator m_rng;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
 
+Random::Generator & Random::generator() {
+	if(!rng.inc) {
+		seedThread();
+	}
+	return rng;
+}
+
 template <class IntType>
 IntType Random::get(IntType min, IntType max) {
-	return typename detail::uniform_int_distribution<IntType>::type(min, max)(rng);
+	return detail::uniformInt(generator(), min, max);
 }
 
 template <class IntType>
@@ -130,7 +257,7 @@ int Random::get(int min, int max) {
 
 template <class RealType>
 RealType Random::getf(RealType min, RealType max) {
-	return typename detail::uniform_real_distribution<RealType>::type(min, max)(rng);
+	return detail::uniformReal(generator(), min, max);
 }
 
 template <class RealType>
@@ -164,4 +291,29 @@ typename Container::const_iterator Random::getIterator(const Container& containe
 	return getIterator(container.begin(), container.end());
 }
 
+Random::Generator & RandomStream::generator() {
+	if(m_epoch != Random::epoch) {
+		restart();
+	}
+	return m_rng;
+}
+
+template <class IntType>
+IntType RandomStream::get(IntType min, IntType max) {
+	return detail::uniformInt(generator(), min, max);
+}
+
+int RandomStream::get(int min, int max) {
+	return get<int>(min, max);
+}
+
+template <class RealType>
+RealType RandomStream::getf(RealType min, RealType max) {
+	return detail::uniformReal(generator(), min, max);
+}
+
+float RandomStream::getf(float min, float max) {
+	return getf<float>(min, max);
+}
+
 #endif // ARX_MATH_RANDOM_H
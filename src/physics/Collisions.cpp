@@ -78,7 +78,7 @@ bool DIRECT_PATH=true;
 
 //-----------------------------------------------------------------------------
 // Added immediate return (return anything;)
-inline float IsPolyInCylinder(EERIEPOLY *ep, EERIE_CYLINDER * cyl,long flag)
+inline float IsPolyInCylinder(const CollisionPoly * ep, EERIE_CYLINDER * cyl, long flag)
 {
 	long flags=flag;
 	POLYIN=0;
@@ -95,7 +95,7 @@ inline float IsPolyInCylinder(EERIEPOLY *ep, EERIE_CYLINDER * cyl,long flag)
 
 	for (long num=0;num<to;num++)
 	{
-		float dd = fdist(Vec2f(ep->v[num].p.x, ep->v[num].p.z), Vec2f(cyl->origin.x, cyl->origin.z));
+		float dd = fdist(Vec2f(ep->v[num].x, ep->v[num].z), Vec2f(cyl->origin.x, cyl->origin.z));
 
 		if (dd<nearest)
 		{
@@ -121,7 +121,7 @@ inline float IsPolyInCylinder(EERIEPOLY *ep, EERIE_CYLINDER * cyl,long flag)
 	{	
 		POLYIN = 1;
 		
-		if (ep->norm.y<0.5f)
+		if (ep->normy<0.5f)
 			anything=min(anything,ep->min.y);
 		else
 			anything=min(anything,ep->center.y);
@@ -142,7 +142,7 @@ inline float IsPolyInCylinder(EERIEPOLY *ep, EERIE_CYLINDER * cyl,long flag)
 			for (long o=0;o<5;o++)
 			{
 				float p=(float)o*( 1.0f / 5 );
-				center = ep->v[n].p * p + ep->center * (1.f-p);
+				center = ep->v[n] * p + ep->center * (1.f-p);
 				if(PointInCylinder(cyl, &center)) {
 					anything=min(anything,center.y);
 					POLYIN=1;
@@ -154,7 +154,7 @@ inline float IsPolyInCylinder(EERIEPOLY *ep, EERIE_CYLINDER * cyl,long flag)
 		if ((ep->area>2000.f) 
 		        || (flags & CFLAG_EXTRA_PRECISION)  )
 		{
-			center = (ep->v[n].p + ep->v[r].p) * 0.5f;
+			center = (ep->v[n] + ep->v[r]) * 0.5f;
 			if(PointInCylinder(cyl, &center)) {
 				anything=min(anything,center.y);
 				POLYIN=1;
@@ -162,7 +162,7 @@ inline float IsPolyInCylinder(EERIEPOLY *ep, EERIE_CYLINDER * cyl,long flag)
 			}
 
 			if ((ep->area>4000.f) || (flags & CFLAG_EXTRA_PRECISION)) {
-				center = (ep->v[n].p + ep->center) * 0.5f;
+				center = (ep->v[n] + ep->center) * 0.5f;
 				if (PointInCylinder(cyl, &center)) 
 				{	
 					anything=min(anything,center.y);
@@ -173,7 +173,7 @@ inline float IsPolyInCylinder(EERIEPOLY *ep, EERIE_CYLINDER * cyl,long flag)
 			}
 
 			if ((ep->area>6000.f) || (flags & CFLAG_EXTRA_PRECISION)) {
-				center = (center + ep->v[n].p) * 0.5f;
+				center = (center + ep->v[n]) * 0.5f;
 				if(PointInCylinder(cyl, &center))
 				{
 					anything=min(anything,center.y);
@@ -184,9 +184,9 @@ inline float IsPolyInCylinder(EERIEPOLY *ep, EERIE_CYLINDER * cyl,long flag)
 			}
 		}
 
-		if(PointInCylinder(cyl, &ep->v[n].p)) {
+		if(PointInCylinder(cyl, &ep->v[n])) {
 			
-			anything=min(anything,ep->v[n].p.y);
+			anything=min(anything,ep->v[n].y);
 			POLYIN = 1;
 
 			if (!(flags & CFLAG_EXTRA_PRECISION)) return anything;
@@ -224,14 +224,14 @@ inline float IsPolyInCylinder(EERIEPOLY *ep, EERIE_CYLINDER * cyl,long flag)
 		}
 	} 
 //}*/
-	if ((anything!=999999.f) && (ep->norm.y<0.1f) && (ep->norm.y>-0.1f))
+	if ((anything!=999999.f) && (ep->normy<0.1f) && (ep->normy>-0.1f))
 		anything=min(anything,ep->min.y);
 
 	return anything;
 }
 
 //-----------------------------------------------------------------------------
-inline bool IsPolyInSphere(EERIEPOLY *ep, EERIE_SPHERE * sph)
+inline bool IsPolyInSphere(const CollisionPoly * ep, EERIE_SPHERE * sph)
 {
 	if ((!ep) || (!sph)) return false;
 
@@ -246,25 +246,25 @@ inline bool IsPolyInSphere(EERIEPOLY *ep, EERIE_SPHERE * sph)
 	{
 		
 		if(ep->area > 2000.f) {
-			center = (ep->v[n].p + ep->v[r].p) * 0.5f;
+			center = (ep->v[n] + ep->v[r]) * 0.5f;
 			if(sph->contains(center)) {	
 				return true;
 			}
 			if(ep->area > 4000.f) {
-				center = (ep->v[n].p + ep->center) * 0.5f;
+				center = (ep->v[n] + ep->center) * 0.5f;
 				if(sph->contains(center)) {
 					return true;
 				}
 			}
 			if(ep->area > 6000.f) {
-				center = (center + ep->v[n].p) * 0.5f;
+				center = (center + ep->v[n]) * 0.5f;
 				if(sph->contains(center)) {
 					return true;
 				}
 			}
 		}
 		
-		Vec3f v(ep->v[n].p.x, ep->v[n].p.y, ep->v[n].p.z);
+		const Vec3f & v = ep->v[n];
 
 		if(sph->contains(v)) {
 			return true;
@@ -523,7 +523,7 @@ float CheckAnythingInCylinder(EERIE_CYLINDER * cyl,Entity * ioo,long flags) {
 
 	float anything = 999999.f; 
 	
-	EERIEPOLY * ep;
+	CollisionPoly * ep;
 	FAST_BKG_DATA * feg;
 	
 	for (long j=pz-rad;j<=pz+rad;j++)
@@ -558,7 +558,7 @@ float CheckAnythingInCylinder(EERIE_CYLINDER * cyl,Entity * ioo,long flags) {
 		feg=&ACTIVEBKG->fastdata[i][j];
 		for (long k=0;k<feg->nbpoly;k++)
 		{
-			ep=&feg->polydata[k];	
+			ep=&feg->coldata[k];
 
 			if (ep->type & (POLY_WATER | POLY_TRANS | POLY_NOCOL) ) continue;
 
@@ -578,9 +578,7 @@ float CheckAnythingInCylinder(EERIE_CYLINDER * cyl,Entity * ioo,long flags) {
 
 	float tempo;
 	
-	ep=CheckInPoly(cyl->origin.x,cyl->origin.y+cyl->height,cyl->origin.z,&tempo);
-	
-	if (ep) 
+	if (CheckInPoly(cyl->origin.x,cyl->origin.y+cyl->height,cyl->origin.z,&tempo)) 
 		{
 			anything=min(anything,tempo);
 	}
@@ -1058,7 +1056,7 @@ EERIEPOLY * CheckBackgroundInSphere(EERIE_SPHERE * sphere) //except source...
 	long spz = std::max(pz - rad, 0L);
 	long epz = std::min(pz + rad, ACTIVEBKG->Zsize - 1L);
 
-	EERIEPOLY * ep;
+	CollisionPoly * ep;
 	FAST_BKG_DATA * feg;
 
 	for (long j=spz;j<=epz;j++)
@@ -1068,13 +1066,13 @@ EERIEPOLY * CheckBackgroundInSphere(EERIE_SPHERE * sphere) //except source...
 
 		for (long k=0;k<feg->nbpoly;k++)
 		{
-			ep=&feg->polydata[k];	
+			ep=&feg->coldata[k];
 
 			if (ep->type & (POLY_WATER | POLY_TRANS | POLY_NOCOL)) continue;
 
 			if (IsPolyInSphere(ep,sphere)) 
 			{
-				return ep;					
+				return ep->ep;
 			}			
 		}
 	}	
@@ -1104,7 +1102,7 @@ bool CheckAnythingInSphere(EERIE_SPHERE * sphere, long source, CASFlags flags, l
 			FAST_BKG_DATA *feg=&ACTIVEBKG->fastdata[i][j];
 
 			for(long k = 0; k < feg->nbpoly; k++) {
-				EERIEPOLY *ep=&feg->polydata[k];
+				CollisionPoly *ep=&feg->coldata[k];
 
 				if(ep->type & (POLY_WATER | POLY_TRANS | POLY_NOCOL))
 					continue;
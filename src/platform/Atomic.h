@@ -0,0 +1,117 @@
+/*
+ * Copyright 2013 Arx Libertatis Team (see the AUTHORS file)
+ *
+ * This file is part of Arx Libertatis.
+ *
+ * Arx Libertatis is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Arx Libertatis is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Arx Libertatis.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ARX_PLATFORM_ATOMIC_H
+#define ARX_PLATFORM_ATOMIC_H
+
+#include "platform/Platform.h"
+
+#if ARX_COMPILER_MSVC
+#include <intrin.h>
+#endif
+
+/*!
+ * Minimal atomic operations on 32-bit integers and pointers.
+ * 
+ * All read-modify-write operations act as full memory barriers.
+ * atomicLoad() has acquire and atomicStore() has release semantics.
+ */
+namespace platform {
+
+#if ARX_COMPILER_MSVC
+
+inline u32 atomicAdd(volatile u32 * value, u32 delta) {
+	return u32(_InterlockedExchangeAdd(reinterpret_cast<volatile long *>(value), long(delta))) + delta;
+}
+
+inline bool atomicCompareExchange(volatile u32 * value, u32 expected, u32 desired) {
+	volatile long * v = reinterpret_cast<volatile long *>(value);
+	return u32(_InterlockedCompareExchange(v, long(desired), long(expected))) == expected;
+}
+
+inline u32 atomicExchange(volatile u32 * value, u32 desired) {
+	return u32(_InterlockedExchange(reinterpret_cast<volatile long *>(value), long(desired)));
+}
+
+inline u32 atomicLoad(const volatile u32 * value) {
+	u32 result = *value;
+	_ReadWriteBarrier();
+	return result;
+}
+
+inline void atomicStore(volatile u32 * value, u32 desired) {
+	_ReadWriteBarrier();
+	*value = desired;
+}
+
+#else
+
+inline u32 atomicAdd(volatile u32 * value, u32 delta) {
+	return __sync_add_and_fetch(value, delta);
+}
+
+inline bool atomicCompareExchange(volatile u32 * value, u32 expected, u32 desired) {
+	return __sync_bool_compare_and_swap(value, expected, desired);
+}
+
+inline u32 atomicExchange(volatile u32 * value, u32 desired) {
+	u32 old;
+	do {
+		old = *value;
+	} while(!__sync_bool_compare_and_swap(value, old, desired));
+	return old;
+}
+
+inline u32 atomicLoad(const volatile u32 * value) {
+	u32 result = *value;
+	__sync_synchronize();
+	return result;
+}
+
+inline void atomicStore(volatile u32 * value, u32 desired) {
+	__sync_synchronize();
+	*value = desired;
+}
+
+#endif
+
+template <typename T>
+inline T * atomicLoad(T * const volatile * value) {
+	T * result = *value;
+#if ARX_COMPILER_MSVC
+	_ReadWriteBarrier();
+#else
+	__sync_synchronize();
+#endif
+	return result;
+}
+
+template <typename T>
+inline void atomicStore(T * volatile * value, T * desired) {
+#if ARX_COMPILER_MSVC
+	_ReadWriteBarrier();
+#else
+	__sync_synchronize();
+#endif
+	*value = desired;
+}
+
+} // namespace platform
+
+#endif // ARX_PLATFORM_ATOMIC_H
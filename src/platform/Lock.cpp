@@ -48,6 +48,18 @@ void Lock::lock() {
 	pthread_mutex_unlock(&mutex);
 }
 
+bool Lock::tryLock() {
+	
+	pthread_mutex_lock(&mutex);
+	
+	bool acquired = !locked;
+	locked = true;
+	
+	pthread_mutex_unlock(&mutex);
+	
+	return acquired;
+}
+
 void Lock::unlock() {
 	pthread_mutex_lock(&mutex);
 	locked = false;
@@ -72,6 +84,10 @@ void Lock::lock() {
 	ARX_UNUSED(rc);
 }
 
+bool Lock::tryLock() {
+	return WaitForSingleObject(mutex, 0) == WAIT_OBJECT_0;
+}
+
 void Lock::unlock() {
 	ReleaseMutex(mutex);
 }
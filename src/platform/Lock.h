@@ -49,6 +49,9 @@ public:
 	
 	void lock();
 	
+	//! Acquire the lock only if no other thread holds it \return true if the lock was acquired
+	bool tryLock();
+	
 	void unlock();
 	
 };
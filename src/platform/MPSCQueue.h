@@ -0,0 +1,246 @@
+/*
+ * Copyright 2013 Arx Libertatis Team (see the AUTHORS file)
+ *
+ * This file is part of Arx Libertatis.
+ *
+ * Arx Libertatis is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Arx Libertatis is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Arx Libertatis.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ARX_PLATFORM_MPSCQUEUE_H
+#define ARX_PLATFORM_MPSCQUEUE_H
+
+#include <stddef.h>
+#include <vector>
+
+#include <boost/static_assert.hpp>
+
+#include "platform/Atomic.h"
+#include "platform/Lock.h"
+#include "platform/Platform.h"
+
+namespace platform {
+
+/*!
+ * Bounded lock-free multi-producer single-consumer queue.
+ * 
+ * Producers reserve a slot with reserve(), fill it in place and then publish it using
+ * commit(). Any number of threads may produce concurrently, but only one thread at a time
+ * may call consume().
+ * 
+ * Consumed values are not destroyed - they are re-used by later producers.
+ * 
+ * \tparam Size Number of slots - must be a power of two.
+ */
+template <typename T, u32 Size>
+class MPSCQueue {
+	
+	BOOST_STATIC_ASSERT((Size & (Size - 1)) == 0);
+	
+	struct Slot {
+		volatile u32 sequence;
+		T value;
+	};
+	
+	Slot m_slots[Size];
+	volatile u32 m_writePos;
+	u32 m_readPos;
+	volatile u32 m_highWaterMark; //!< Only written by the consumer
+	
+public:
+	
+	MPSCQueue() : m_writePos(0), m_readPos(0), m_highWaterMark(0) {
+		for(u32 i = 0; i < Size; i++) {
+			m_slots[i].sequence = i;
+		}
+	}
+	
+	/*!
+	 * Reserve a slot at the end of the queue.
+	 * 
+	 * \return the slot to fill in or NULL if the queue is full.
+	 *         The slot must be published using commit(ticket) once it has been filled in.
+	 */
+	T * reserve(u32 & ticket) {
+		
+		u32 pos = atomicLoad(&m_writePos);
+		
+		for(;;) {
+			
+			Slot & slot = m_slots[pos & (Size - 1)];
+			s32 diff = s32(atomicLoad(&slot.sequence) - pos);
+			
+			if(diff == 0) {
+				if(atomicCompareExchange(&m_writePos, pos, pos + 1)) {
+					ticket = pos;
+					return &slot.value;
+				}
+				pos = atomicLoad(&m_writePos);
+			} else if(diff < 0) {
+				return NULL;
+			} else {
+				pos = atomicLoad(&m_writePos);
+			}
+		}
+	}
+	
+	//! Publish a slot previously returned by reserve()
+	void commit(u32 ticket) {
+		atomicStore(&m_slots[ticket & (Size - 1)].sequence, ticket + 1);
+	}
+	
+	/*!
+	 * Pass all published values to f, in order.
+	 * 
+	 * Stops at the first slot that has been reserved but not yet committed.
+	 * 
+	 * \return the number of consumed values.
+	 */
+	template <typename F>
+	size_t consume(F f) {
+		
+		// Includes slots that have been reserved but not yet committed
+		u32 depth = atomicLoad(&m_writePos) - m_readPos;
+		if(depth > m_highWaterMark) {
+			atomicStore(&m_highWaterMark, depth);
+		}
+		
+		size_t count = 0;
+		
+		for(;; count++) {
+			
+			Slot & slot = m_slots[m_readPos & (Size - 1)];
+			if(atomicLoad(&slot.sequence) != m_readPos + 1) {
+				break;
+			}
+			
+			f(slot.value);
+			
+			atomicStore(&slot.sequence, m_readPos + Size);
+			m_readPos++;
+		}
+		
+		return count;
+	}
+	
+	/*!
+	 * Check if there are no committed or reserved slots left.
+	 * Must only be called from the consumer thread.
+	 */
+	bool empty() const { return atomicLoad(&m_writePos) == m_readPos; }
+	
+	/*!
+	 * Maximum number of values that were in the queue when consume() was called.
+	 * May be called from any thread.
+	 */
+	u32 highWaterMark() const { return atomicLoad(&m_highWaterMark); }
+	
+};
+
+/*!
+ * Multi-producer single-consumer queue that never drops values.
+ * 
+ * Values are passed through a MPSCQueue. If that is full, they are added to a locked
+ * overflow list instead. Once the overflow list is in use, all new values go there
+ * until the consumer has caught up.
+ * Values posted by any one thread are consumed in the order they were posted.
+ */
+template <typename T, u32 Size>
+class UnboundedMPSCQueue {
+	
+	MPSCQueue<T, Size> m_queue;
+	Lock m_overflowLock;
+	std::vector<T> m_overflow;
+	volatile u32 m_overflowUsed;
+	
+	struct Discard {
+		void operator()(const T & value) const {
+			ARX_UNUSED(value);
+		}
+	};
+	
+public:
+	
+	UnboundedMPSCQueue() : m_overflowUsed(0) { }
+	
+	//! Add a value to the end of the queue - may be called from any thread
+	void push(const T & value) {
+		
+		if(!atomicLoad(&m_overflowUsed)) {
+			u32 ticket;
+			T * slot = m_queue.reserve(ticket);
+			if(slot) {
+				*slot = value;
+				m_queue.commit(ticket);
+				return;
+			}
+		}
+		
+		Autolock lock(m_overflowLock);
+		m_overflow.push_back(value);
+		atomicStore(&m_overflowUsed, 1);
+	}
+	
+	/*!
+	 * Pass all posted values to f, in order.
+	 * 
+	 * \return the number of consumed values.
+	 */
+	template <typename F>
+	size_t consume(F f) {
+		
+		size_t count = m_queue.consume(f);
+		
+		if(atomicLoad(&m_overflowUsed)) {
+			
+			Autolock lock(m_overflowLock);
+			
+			// Values that made it into the queue before it was full must be consumed first
+			count += m_queue.consume(f);
+			
+			if(!m_queue.empty()) {
+				// A producer has reserved a slot but not committed it yet. Values behind
+				// that slot may have been posted before values in the overflow list by the
+				// same thread, so the overflow list has to wait until the ring is drained.
+				return count;
+			}
+			
+			for(size_t i = 0; i < m_overflow.size(); i++) {
+				f(m_overflow[i]);
+			}
+			count += m_overflow.size();
+			m_overflow.clear();
+			
+			atomicStore(&m_overflowUsed, 0);
+		}
+		
+		return count;
+	}
+	
+	//! Discard all posted values, except for slots that have not been committed yet
+	void clear() {
+		m_queue.consume(Discard());
+		Autolock lock(m_overflowLock);
+		m_queue.consume(Discard());
+		m_overflow.clear();
+		atomicStore(&m_overflowUsed, 0);
+	}
+	
+	//! Maximum number of values that were in the ring buffer when consume() was called
+	u32 highWaterMark() const { return m_queue.highWaterMark(); }
+	
+};
+
+} // namespace platform
+
+#endif // ARX_PLATFORM_MPSCQUEUE_H
@@ -141,6 +141,16 @@ typedef double f64; // 64 bits double float
 	#define ARX_DISCARD(...) ((void)0)
 #endif
 
+/*!
+ * ARX_THREAD_LOCAL - Declare a variable with thread storage duration.
+ * Only usable for POD types with constant initializers.
+ */
+#if ARX_COMPILER_MSVC
+	#define ARX_THREAD_LOCAL __declspec(thread)
+#else
+	#define ARX_THREAD_LOCAL __thread
+#endif
+
 /*!
  * Declare that a function argument is a printf-like format string.
  * 
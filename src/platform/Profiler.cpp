@@ -0,0 +1,341 @@
+/*
+ * Copyright 2013 Arx Libertatis Team (see the AUTHORS file)
+ *
+ * This file is part of Arx Libertatis.
+ *
+ * Arx Libertatis is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Arx Libertatis is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Arx Libertatis.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "platform/Profiler.h"
+
+#ifdef BUILD_PROFILER
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+
+#include "io/log/Logger.h"
+
+#include "platform/Atomic.h"
+#include "platform/Lock.h"
+#include "platform/ProgramOptions.h"
+
+namespace profiler {
+
+namespace {
+
+struct Sample {
+	const char * tag;
+	u32 depth;
+	u64 startTime;
+	u64 endTime;
+};
+
+//! Number of samples kept per thread, must be a power of two
+const u32 MaxSamples = 1 << 16;
+
+const size_t MaxThreads = 32;
+
+/*!
+ * Ring buffer of samples only written to by the owning thread.
+ * 
+ * Readers may only access samples before the published writePos and must check that
+ * the writer has not wrapped around and overwritten them while they were being copied.
+ */
+struct ThreadData {
+	
+	std::string name;
+	
+	//! Total number of samples published - samples[writePos % MaxSamples] is the next slot
+	volatile u32 writePos;
+	
+	Sample samples[MaxSamples];
+	
+	explicit ThreadData(const std::string & _name) : name(_name), writePos(0) { }
+	
+};
+
+Lock g_lock;
+ThreadData * g_threads[MaxThreads];
+volatile u32 g_threadCount = 0;
+bool g_threadLimitWarned = false;
+
+ARX_THREAD_LOCAL ThreadData * t_thread = NULL;
+ARX_THREAD_LOCAL bool t_dropped = false;
+ARX_THREAD_LOCAL u32 t_depth = 0;
+
+//! Start times of the last complete frame and the current frame, only used by the main thread
+u64 g_frameStart[2] = { 0, 0 };
+
+std::string g_outputFile;
+
+ThreadData * createThreadData(const std::string & name) {
+	
+	Autolock lock(g_lock);
+	
+	u32 count = g_threadCount;
+	if(count == MaxThreads) {
+		if(!g_threadLimitWarned) {
+			LogWarning << "Profiler thread limit reached, not recording samples for " << name
+			           << " and any later threads";
+			g_threadLimitWarned = true;
+		}
+		return NULL;
+	}
+	
+	ThreadData * data = new ThreadData(name);
+	g_threads[count] = data;
+	platform::atomicStore(&g_threadCount, count + 1);
+	
+	return data;
+}
+
+/*!
+ * Copy the published samples of a thread, newest first.
+ * 
+ * Stops after the first sample that ended before minEndTime.
+ * Samples that may have been overwritten by the owning thread during the copy are discarded.
+ */
+void copySamples(const ThreadData & data, std::vector<Sample> & samples, u64 minEndTime = 0) {
+	
+	samples.clear();
+	
+	u32 end = platform::atomicLoad(&data.writePos);
+	u32 count = std::min(end, MaxSamples);
+	for(u32 i = 0; i < count; i++) {
+		samples.push_back(data.samples[(end - 1 - i) & (MaxSamples - 1)]);
+		if(samples.back().endTime < minEndTime) {
+			break;
+		}
+	}
+	
+	// Everything older than the last MaxSamples published samples may have been overwritten
+	u32 newEnd = platform::atomicLoad(&data.writePos);
+	u32 overwritten = newEnd - end;
+	if(overwritten >= MaxSamples) {
+		samples.clear();
+	} else if(samples.size() > size_t(MaxSamples - overwritten)) {
+		samples.resize(MaxSamples - overwritten);
+	}
+}
+
+struct TagLess {
+	bool operator()(const char * a, const char * b) const {
+		return std::strcmp(a, b) < 0;
+	}
+};
+
+struct StatOrder {
+	
+	const std::vector<u64> & firstStart;
+	
+	explicit StatOrder(const std::vector<u64> & _firstStart) : firstStart(_firstStart) { }
+	
+	bool operator()(size_t a, size_t b) const {
+		return firstStart[a] < firstStart[b];
+	}
+	
+};
+
+void writeJsonString(std::ostream & os, const char * str) {
+	os << '"';
+	for(; *str; str++) {
+		if(*str == '"' || *str == '\\') {
+			os << '\\';
+		}
+		os << *str;
+	}
+	os << '"';
+}
+
+} // anonymous namespace
+
+void registerThread(const std::string & name) {
+	if(!t_thread && !t_dropped) {
+		t_thread = createThreadData(name);
+		t_dropped = !t_thread;
+	}
+}
+
+u32 & currentDepth() {
+	return t_depth;
+}
+
+void addSample(const char * tag, u32 depth, u64 startTime, u64 endTime) {
+	
+	ThreadData * data = t_thread;
+	if(!data) {
+		if(t_dropped) {
+			return;
+		}
+		std::ostringstream oss;
+		oss << "thread " << platform::atomicLoad(&g_threadCount);
+		data = t_thread = createThreadData(oss.str());
+		if(!data) {
+			t_dropped = true;
+			return;
+		}
+	}
+	
+	u32 pos = data->writePos;
+	Sample & sample = data->samples[pos & (MaxSamples - 1)];
+	sample.tag = tag;
+	sample.depth = depth;
+	sample.startTime = startTime;
+	sample.endTime = endTime;
+	
+	// Publish the sample to readers
+	platform::atomicStore(&data->writePos, pos + 1);
+}
+
+void frameStart() {
+	g_frameStart[0] = g_frameStart[1];
+	g_frameStart[1] = Time::getUs();
+}
+
+void getFrameStats(std::vector<Stat> & stats) {
+	
+	stats.clear();
+	
+	u64 frameBegin = g_frameStart[0], frameEnd = g_frameStart[1];
+	if(frameBegin == 0) {
+		return;
+	}
+	
+	std::vector<Sample> samples;
+	
+	u32 threadCount = platform::atomicLoad(&g_threadCount);
+	for(u32 thread = 0; thread < threadCount; thread++) {
+		
+		std::vector<Stat> threadStats;
+		std::vector<u64> firstStart;
+		typedef std::map<const char *, size_t, TagLess> Index;
+		Index index;
+		
+		// Samples are stored in the order they ended - walk back until the frame start
+		copySamples(*g_threads[thread], samples, frameBegin);
+		for(size_t i = 0; i < samples.size(); i++) {
+			
+			const Sample & sample = samples[i];
+			if(sample.endTime < frameBegin) {
+				break;
+			}
+			if(sample.endTime > frameEnd || sample.startTime < frameBegin) {
+				continue;
+			}
+			
+			std::pair<Index::iterator, bool> entry = index.insert(Index::value_type(sample.tag,
+			                                                                        threadStats.size()));
+			if(entry.second) {
+				Stat stat;
+				stat.tag = sample.tag;
+				stat.thread = thread;
+				stat.depth = sample.depth;
+				stat.time = 0;
+				stat.count = 0;
+				threadStats.push_back(stat);
+				firstStart.push_back(sample.startTime);
+			}
+			
+			size_t j = entry.first->second;
+			threadStats[j].time += sample.endTime - sample.startTime;
+			threadStats[j].count++;
+			threadStats[j].depth = std::min(threadStats[j].depth, sample.depth);
+			firstStart[j] = std::min(firstStart[j], sample.startTime);
+		}
+		
+		// Sort by first occurrence so that nested scopes follow their parents
+		std::vector<size_t> order(threadStats.size());
+		for(size_t i = 0; i < order.size(); i++) {
+			order[i] = i;
+		}
+		std::stable_sort(order.begin(), order.end(), StatOrder(firstStart));
+		for(size_t i = 0; i < order.size(); i++) {
+			stats.push_back(threadStats[order[i]]);
+		}
+	}
+}
+
+std::string getThreadName(size_t thread) {
+	if(thread >= platform::atomicLoad(&g_threadCount)) {
+		return std::string();
+	}
+	return g_threads[thread]->name;
+}
+
+bool writeChromeTrace(const std::string & file) {
+	
+	std::ofstream os(file.c_str(), std::ios_base::out | std::ios_base::trunc);
+	if(!os.is_open()) {
+		LogError << "Could not open profiler output " << file;
+		return false;
+	}
+	
+	os << "{\"traceEvents\":[\n";
+	
+	bool first = true;
+	
+	std::vector<Sample> samples;
+	
+	u32 threadCount = platform::atomicLoad(&g_threadCount);
+	for(u32 thread = 0; thread < threadCount; thread++) {
+		
+		const ThreadData & data = *g_threads[thread];
+		
+		os << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":"
+		   << thread << ",\"args\":{\"name\":";
+		writeJsonString(os, data.name.c_str());
+		os << "}}";
+		first = false;
+		
+		copySamples(data, samples);
+		for(std::vector<Sample>::const_reverse_iterator i = samples.rbegin(); i != samples.rend(); ++i) {
+			const Sample & sample = *i;
+			os << ",\n{\"name\":";
+			writeJsonString(os, sample.tag);
+			os << ",\"ph\":\"X\",\"pid\":0,\"tid\":" << thread << ",\"ts\":" << sample.startTime
+			   << ",\"dur\":" << (sample.endTime - sample.startTime) << '}';
+		}
+	}
+	
+	os << "\n]}\n";
+	
+	if(os.fail()) {
+		LogError << "Error writing profiler output " << file;
+		return false;
+	}
+	
+	LogInfo << "Wrote profiler trace to " << file;
+	
+	return true;
+}
+
+void setOutputFile(const std::string & file) {
+	g_outputFile = file;
+}
+
+void flush() {
+	if(!g_outputFile.empty()) {
+		writeChromeTrace(g_outputFile);
+	}
+}
+
+} // namespace profiler
+
+ARX_PROGRAM_OPTION("profile", "p", "Write profiler samples to FILE on exit (Chrome trace format)",
+                   &profiler::setOutputFile, "FILE");
+
+#endif // BUILD_PROFILER
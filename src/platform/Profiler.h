@@ -0,0 +1,128 @@
+/*
+ * Copyright 2013 Arx Libertatis Team (see the AUTHORS file)
+ *
+ * This file is part of Arx Libertatis.
+ *
+ * Arx Libertatis is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Arx Libertatis is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Arx Libertatis.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ARX_PLATFORM_PROFILER_H
+#define ARX_PLATFORM_PROFILER_H
+
+#include <string>
+#include <vector>
+
+#include <boost/preprocessor/cat.hpp>
+
+#include "Configure.h"
+
+#include "platform/Platform.h"
+#include "platform/Time.h"
+
+/*!
+ * Low-overhead hierarchical frame profiler.
+ * 
+ * Code sections are instrumented with ARX_PROFILE(tag) or ARX_PROFILE_FUNC(),
+ * which record the time spent until the end of the enclosing scope.
+ * Each thread records into its own ring buffer so that no locking is required.
+ * 
+ * Everything is compiled out unless the BUILD_PROFILER option is enabled.
+ */
+namespace profiler {
+
+#ifdef BUILD_PROFILER
+
+/*!
+ * Register the current thread under the given name.
+ * Threads that are not registered explicitly are registered on their first sample.
+ */
+void registerThread(const std::string & name);
+
+//! Record a sample for the current thread - use ARX_PROFILE instead.
+void addSample(const char * tag, u32 depth, u64 startTime, u64 endTime);
+
+//! Mark the start of a new frame.
+void frameStart();
+
+//! Accumulated time for one tag in one thread.
+struct Stat {
+	
+	const char * tag;
+	size_t thread;
+	u32 depth; //!< Minimum nesting depth of the tag
+	u64 time; //!< Total time in microseconds
+	u32 count; //!< Number of samples
+	
+};
+
+/*!
+ * Get the accumulated times for the last complete frame.
+ * The stats are sorted by thread and by the time of the first sample.
+ */
+void getFrameStats(std::vector<Stat> & stats);
+
+//! @return the name of a registered thread
+std::string getThreadName(size_t thread);
+
+/*!
+ * Write all recorded samples in the Chrome trace event format.
+ * The resulting file can be viewed in chrome://tracing.
+ */
+bool writeChromeTrace(const std::string & file);
+
+//! Set a file to write the Chrome trace to when flush() is called.
+void setOutputFile(const std::string & file);
+
+//! Write the Chrome trace to the configured output file, if any.
+void flush();
+
+//! Current nesting depth of the calling thread - use ARX_PROFILE instead.
+u32 & currentDepth();
+
+//! Records the time until the end of the current scope.
+class Scope {
+	
+	const char * m_tag;
+	u64 m_startTime;
+	
+public:
+	
+	explicit Scope(const char * tag) : m_tag(tag), m_startTime(Time::getUs()) {
+		currentDepth()++;
+	}
+	
+	~Scope() {
+		u32 depth = --currentDepth();
+		addSample(m_tag, depth, m_startTime, Time::getUs());
+	}
+	
+};
+
+#define ARX_PROFILE(tag) ::profiler::Scope BOOST_PP_CAT(profileScope, __LINE__)(tag)
+#define ARX_PROFILE_FUNC() ARX_PROFILE(__FUNCTION__)
+
+#else // BUILD_PROFILER
+
+inline void registerThread(const std::string & name) { ARX_UNUSED(name); }
+inline void frameStart() { }
+inline void flush() { }
+
+#define ARX_PROFILE(tag) ARX_DISCARD(tag)
+#define ARX_PROFILE_FUNC() ARX_DISCARD()
+
+#endif // BUILD_PROFILER
+
+} // namespace profiler
+
+#endif // ARX_PLATFORM_PROFILER_H
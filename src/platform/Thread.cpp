@@ -21,6 +21,7 @@
 
 #include "platform/CrashHandler.h"
 #include "platform/Platform.h"
+#include "platform/Profiler.h"
 
 void Thread::setThreadName(const std::string & _threadName) {
 	threadName = _threadName;
@@ -116,6 +117,7 @@ void * Thread::entryPoint(void * param) {
 #endif
 	
 	CrashHandler::registerThreadCrashHandlers();
+	profiler::registerThread(thread.threadName);
 	thread.run();
 	CrashHandler::unregisterThreadCrashHandlers();
 	return NULL;
@@ -212,6 +214,7 @@ DWORD WINAPI Thread::entryPoint(LPVOID param) {
 	SetCurrentThreadName(((Thread*)param)->threadName);
 	
 	CrashHandler::registerThreadCrashHandlers();
+	profiler::registerThread(((Thread*)param)->threadName);
 	((Thread*)param)->run();
 	CrashHandler::unregisterThreadCrashHandlers();
 	return 0;
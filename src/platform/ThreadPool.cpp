@@ -0,0 +1,222 @@
+/*
+ * Copyright 2013 Arx Libertatis Team (see the AUTHORS file)
+ *
+ * This file is part of Arx Libertatis.
+ *
+ * Arx Libertatis is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Arx Libertatis is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Arx Libertatis.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "platform/ThreadPool.h"
+
+#include <algorithm>
+#include <sstream>
+
+#include "io/log/Logger.h"
+#include "platform/Atomic.h"
+#include "platform/Thread.h"
+
+#if defined(ARX_HAVE_PTHREADS)
+#include <unistd.h>
+#endif
+
+//! Counting semaphore
+class Semaphore {
+	
+#if defined(ARX_HAVE_PTHREADS)
+	pthread_mutex_t mutex;
+	pthread_cond_t cond;
+	size_t value;
+#elif defined(ARX_HAVE_WINAPI)
+	HANDLE semaphore;
+#endif
+	
+public:
+	
+#if defined(ARX_HAVE_PTHREADS)
+	
+	Semaphore() : value(0) {
+		pthread_mutex_init(&mutex, NULL);
+		pthread_cond_init(&cond, NULL);
+	}
+	
+	~Semaphore() {
+		pthread_cond_destroy(&cond);
+		pthread_mutex_destroy(&mutex);
+	}
+	
+	void wait() {
+		pthread_mutex_lock(&mutex);
+		while(!value) {
+			pthread_cond_wait(&cond, &mutex);
+		}
+		value--;
+		pthread_mutex_unlock(&mutex);
+	}
+	
+	void post(size_t count = 1) {
+		pthread_mutex_lock(&mutex);
+		value += count;
+		pthread_cond_broadcast(&cond);
+		pthread_mutex_unlock(&mutex);
+	}
+	
+#elif defined(ARX_HAVE_WINAPI)
+	
+	Semaphore() {
+		semaphore = CreateSemaphore(NULL, 0, 0x7fffffff, NULL);
+	}
+	
+	~Semaphore() {
+		CloseHandle(semaphore);
+	}
+	
+	void wait() {
+		WaitForSingleObject(semaphore, INFINITE);
+	}
+	
+	void post(size_t count = 1) {
+		ReleaseSemaphore(semaphore, LONG(count), NULL);
+	}
+	
+#endif
+	
+};
+
+class WorkerThread : public Thread {
+	
+	ThreadPool * m_pool;
+	
+public:
+	
+	explicit WorkerThread(ThreadPool * pool) : m_pool(pool) { }
+	
+	void run() {
+		for(;;) {
+			m_pool->m_start->wait();
+			if(platform::atomicLoad(&m_pool->m_stop)) {
+				break;
+			}
+			m_pool->work();
+			m_pool->m_done->post();
+		}
+	}
+	
+};
+
+ThreadPool * ThreadPool::s_instance = NULL;
+
+static size_t getProcessorCount() {
+#if defined(ARX_HAVE_PTHREADS) && defined(_SC_NPROCESSORS_ONLN)
+	long count = sysconf(_SC_NPROCESSORS_ONLN);
+	return (count > 0) ? size_t(count) : 1;
+#elif defined(ARX_HAVE_WINAPI)
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return (info.dwNumberOfProcessors > 0) ? size_t(info.dwNumberOfProcessors) : 1;
+#else
+	return 1;
+#endif
+}
+
+ThreadPool::ThreadPool(size_t threads)
+	: m_start(new Semaphore), m_done(new Semaphore),
+	  m_job(NULL), m_data(NULL), m_count(0), m_next(0), m_stop(0) {
+	
+	m_workers.resize(threads);
+	for(size_t i = 0; i < threads; i++) {
+		m_workers[i] = new WorkerThread(this);
+		std::ostringstream name;
+		name << "Worker " << (i + 1);
+		m_workers[i]->setThreadName(name.str());
+		m_workers[i]->start();
+	}
+}
+
+ThreadPool::~ThreadPool() {
+	
+	platform::atomicStore(&m_stop, 1);
+	m_start->post(m_workers.size());
+	
+	for(size_t i = 0; i < m_workers.size(); i++) {
+		m_workers[i]->waitForCompletion();
+		delete m_workers[i];
+	}
+	
+	delete m_start;
+	delete m_done;
+}
+
+void ThreadPool::work() {
+	for(;;) {
+		u32 index = platform::atomicAdd(&m_next, 1) - 1;
+		if(index >= m_count) {
+			break;
+		}
+		m_job(m_data, index);
+	}
+}
+
+void ThreadPool::execute(Job job, void * data, size_t count) {
+	
+	Autolock lock(m_lock);
+	
+	m_job = job;
+	m_data = data;
+	m_count = u32(count);
+	platform::atomicStore(&m_next, 0);
+	
+	// Don't wake up more workers than there is work for
+	size_t workers = std::min(m_workers.size(), count - 1);
+	m_start->post(workers);
+	
+	work();
+	
+	for(size_t i = 0; i < workers; i++) {
+		m_done->wait();
+	}
+}
+
+void ThreadPool::init(long threads) {
+	
+	shutdown();
+	
+	if(threads < 0) {
+		threads = long(getProcessorCount()) - 1;
+	}
+	
+	if(threads > 0) {
+		LogInfo << "Using " << threads << " worker threads";
+		s_instance = new ThreadPool(size_t(threads));
+	}
+}
+
+void ThreadPool::shutdown() {
+	delete s_instance, s_instance = NULL;
+}
+
+void ThreadPool::run(Job job, void * data, size_t count) {
+	
+	if(!s_instance || count < 2) {
+		for(size_t i = 0; i < count; i++) {
+			job(data, i);
+		}
+		return;
+	}
+	
+	s_instance->execute(job, data, count);
+}
+
+size_t ThreadPool::getThreadCount() {
+	return s_instance ? s_instance->m_workers.size() + 1 : 1;
+}
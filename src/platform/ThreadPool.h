@@ -0,0 +1,95 @@
+/*
+ * Copyright 2013 Arx Libertatis Team (see the AUTHORS file)
+ *
+ * This file is part of Arx Libertatis.
+ *
+ * Arx Libertatis is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Arx Libertatis is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Arx Libertatis.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ARX_PLATFORM_THREADPOOL_H
+#define ARX_PLATFORM_THREADPOOL_H
+
+#include <stddef.h>
+#include <vector>
+
+#include "platform/Lock.h"
+#include "platform/Platform.h"
+
+class Semaphore;
+class WorkerThread;
+
+/*!
+ * Fixed set of worker threads that execute data-parallel jobs.
+ * 
+ * There is one global pool that is created by init() and destroyed by shutdown().
+ * Jobs must not use any renderer or OpenGL functions.
+ */
+class ThreadPool {
+	
+public:
+	
+	//! Function executed for each index of a parallel job
+	typedef void (*Job)(void * data, size_t index);
+	
+	/*!
+	 * Create the global thread pool.
+	 * @param threads Number of worker threads, in addition to the calling thread.
+	 *                If this is negative, one less than the number of processors is used.
+	 */
+	static void init(long threads = -1);
+	
+	//! Stop all worker threads.
+	static void shutdown();
+	
+	/*!
+	 * Call job(data, i) for all i in [0, count) and wait until all calls have finished.
+	 * 
+	 * The calls are distributed between the worker threads and the calling thread.
+	 * If there is no thread pool, all calls are made from the calling thread.
+	 * Calls for different indices may run concurrently and in any order.
+	 * Jobs must not call run() themselves.
+	 */
+	static void run(Job job, void * data, size_t count);
+	
+	//! @return the number of threads that execute jobs, including the calling thread
+	static size_t getThreadCount();
+	
+private:
+	
+	ThreadPool(size_t threads);
+	~ThreadPool();
+	
+	void execute(Job job, void * data, size_t count);
+	
+	void work();
+	
+	std::vector<WorkerThread *> m_workers;
+	Semaphore * m_start;
+	Semaphore * m_done;
+	Lock m_lock; //!< Serializes calls to execute()
+	
+	// State for the current job
+	Job m_job;
+	void * m_data;
+	volatile u32 m_count;
+	volatile u32 m_next;
+	volatile u32 m_stop;
+	
+	static ThreadPool * s_instance;
+	
+	friend class WorkerThread;
+	
+};
+
+#endif // ARX_PLATFORM_THREADPOOL_H
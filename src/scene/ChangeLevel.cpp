@@ -46,9 +46,15 @@ ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
 
 #include "scene/ChangeLevel.h"
 
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
 #include <iomanip>
+#include <map>
 #include <sstream>
-#include <cstdio>
+#include <vector>
 
 #include <boost/algorithm/string/case_conv.hpp>
 
@@ -134,6 +140,150 @@ static SaveBlock * pSaveBlock = NULL;
 static ARX_CHANGELEVEL_IO_INDEX * idx_io = NULL;
 static ARX_CHANGELEVEL_INVENTORY_DATA_SAVE ** Gaids = NULL;
 
+/*!
+ * In-memory cache of the uncompressed files written to the current game save block.
+ * 
+ * Files are tagged with the level they were saved for so that going back and forth
+ * between recently visited levels can skip reading and decompressing them again.
+ * All files are still written to the save block, which remains authoritative:
+ * the cache is only ever populated with data that was successfully saved.
+ */
+class LevelFileCache {
+	
+	struct File {
+		long level;
+		std::vector<char> data;
+	};
+	
+	typedef std::map<string, File> Files;
+	
+	Files m_files;
+	std::deque<long> m_levels; //!< Cached levels, most recently used last
+	size_t m_size;
+	size_t m_hits;
+	size_t m_misses;
+	
+	//! Maximum number of levels to keep data for
+	static const size_t MaxLevels = 3;
+	
+	//! Maximum number of bytes to cache
+	static const size_t MaxSize = 32 * 1024 * 1024;
+	
+	void evict(long level) {
+		for(Files::iterator i = m_files.begin(); i != m_files.end();) {
+			if(i->second.level == level) {
+				m_size -= i->second.data.size();
+				m_files.erase(i++);
+			} else {
+				++i;
+			}
+		}
+		m_levels.erase(std::remove(m_levels.begin(), m_levels.end(), level), m_levels.end());
+	}
+	
+	void trim() {
+		while(!m_levels.empty() && (m_levels.size() > MaxLevels || m_size > MaxSize)) {
+			LogDebug("evicting level " << m_levels.front() << " from the level cache");
+			evict(m_levels.front());
+		}
+	}
+	
+public:
+	
+	LevelFileCache() : m_size(0), m_hits(0), m_misses(0) { }
+	
+	//! Mark a level as most recently used.
+	void touch(long level) {
+		if(level < 0) {
+			return;
+		}
+		m_levels.erase(std::remove(m_levels.begin(), m_levels.end(), level), m_levels.end());
+		m_levels.push_back(level);
+	}
+	
+	/*!
+	 * Store a copy of a file.
+	 * @param level the level the file belongs to or -1 for level-independent files
+	 */
+	void store(const string & name, long level, const char * data, size_t size) {
+		
+		File & file = m_files[name];
+		m_size -= file.data.size();
+		file.level = level;
+		file.data.assign(data, data + size);
+		m_size += size;
+		
+		touch(level);
+		trim();
+	}
+	
+	void remove(const string & name) {
+		Files::iterator file = m_files.find(name);
+		if(file != m_files.end()) {
+			m_size -= file->second.data.size();
+			m_files.erase(file);
+		}
+	}
+	
+	/*!
+	 * Load a file from the cache.
+	 * @return a new, malloc-allocated buffer or NULL if the file is not cached
+	 */
+	char * load(const string & name, size_t & size) {
+		
+		Files::const_iterator file = m_files.find(name);
+		if(file == m_files.end()) {
+			m_misses++;
+			return NULL;
+		}
+		
+		m_hits++;
+		size = file->second.data.size();
+		char * dat = (char *)malloc(std::max(size, size_t(1)));
+		if(size) {
+			memcpy(dat, &file->second.data[0], size);
+		}
+		return dat;
+	}
+	
+	void clear() {
+		m_files.clear();
+		m_levels.clear();
+		m_size = 0;
+	}
+	
+	void logStats() const {
+		LogDebug("level cache: " << m_files.size() << " files, " << m_size << " bytes for "
+		         << m_levels.size() << " levels, " << m_hits << " hits, " << m_misses << " misses");
+	}
+	
+};
+
+static LevelFileCache g_levelCache;
+
+//! Save a file to the current game save block and the level cache.
+static bool ARX_CHANGELEVEL_SaveFile(const string & name, long level, const char * dat, size_t size) {
+	
+	if(pSaveBlock->save(name, dat, size)) {
+		g_levelCache.store(name, level, dat, size);
+		return true;
+	}
+	
+	g_levelCache.remove(name);
+	return false;
+}
+
+//! Load a file from the level cache or the current game save block.
+static char * ARX_CHANGELEVEL_LoadFile(const string & name, size_t & size) {
+	
+	char * dat = g_levelCache.load(name, size);
+	if(dat) {
+		return dat;
+	}
+	
+	return pSaveBlock->load(name, size);
+}
+
 static Entity * convertToValidIO(const string & ident) {
 	
 	CONVERT_CREATED = 0;
@@ -211,6 +361,8 @@ bool ARX_Changelevel_CurGame_Clear() {
 		CURRENT_GAME_FILE = fs::paths.user / "current.sav";
 	}
 	
+	g_levelCache.clear();
+	
 	// If there's a left over current game file, clear it
 	if(fs::is_regular_file(CURRENT_GAME_FILE)) {
 		if(!fs::remove(CURRENT_GAME_FILE)) {
@@ -505,7 +657,7 @@ static bool ARX_CHANGELEVEL_Push_Index(long num) {
 	
 	char savefile[256];
 	sprintf(savefile, "lvl%03ld", num);
-	bool ret = pSaveBlock->save(savefile, dat, pos);
+	bool ret = ARX_CHANGELEVEL_SaveFile(savefile, num, dat, pos);
 	
 	delete[] dat;
 	
@@ -594,7 +746,7 @@ static void ARX_CHANGELEVEL_Push_Globals() {
 		}
 	}
 	
-	pSaveBlock->save("globals", dat, pos);
+	ARX_CHANGELEVEL_SaveFile("globals", -1, dat, pos);
 	
 	delete[] dat;
 }
@@ -801,7 +953,7 @@ static long ARX_CHANGELEVEL_Push_Player(long level) {
 	
 	LastValidPlayerPos = asp->LAST_VALID_POS;
 	
-	pSaveBlock->save("player", dat, pos);
+	ARX_CHANGELEVEL_SaveFile("player", -1, dat, pos);
 	
 	delete[] dat;
 	
@@ -1451,7 +1603,7 @@ static long ARX_CHANGELEVEL_Push_IO(const Entity * io, long level) {
 		LogError << "SaveBuffer Overflow " << pos << " >> " << allocsize;
 	}
 	
-	pSaveBlock->save(savefile, dat, pos);
+	ARX_CHANGELEVEL_SaveFile(savefile, level, dat, pos);
 	
 	delete[] dat;
 	
@@ -1468,7 +1620,7 @@ static long ARX_CHANGELEVEL_Pop_Index(ARX_CHANGELEVEL_INDEX * asi, long num) {
 	loadfile = ss.str();
 	
 	size_t size; // TODO size is not used
-	char * dat = pSaveBlock->load(loadfile, size);
+	char * dat = ARX_CHANGELEVEL_LoadFile(loadfile, size);
 	if(!dat) {
 		LogError << "Unable to Open " << loadfile << " for Read...";
 		return -1;
@@ -1510,8 +1662,7 @@ long ARX_CHANGELEVEL_Pop_Zones_n_Lights(ARX_CHANGELEVEL_INDEX * asi, long num) {
 	std::string loadfile = ss.str();
 	
 	size_t size; // TODO size not used
-	// TODO this has already been loaded and decompressed in ARX_CHANGELEVEL_Pop_Index!
-	char * dat = pSaveBlock->load(loadfile, size);
+	char * dat = ARX_CHANGELEVEL_LoadFile(loadfile, size);
 	if(!dat) {
 		LogError << "Unable to Open " << loadfile << " for Read...";
 		return -1;
@@ -1629,7 +1780,7 @@ static long ARX_CHANGELEVEL_Pop_Player() {
 	const string & loadfile = "player";
 	
 	size_t size;
-	char * dat = pSaveBlock->load(loadfile, size);
+	char * dat = ARX_CHANGELEVEL_LoadFile(loadfile, size);
 	if(!dat) {
 		LogError << "Unable to Open " << loadfile << " for Read...";
 		return -1;
@@ -1929,7 +2080,7 @@ static Entity * ARX_CHANGELEVEL_Pop_IO(const string & ident, long num) {
 	LogDebug("--> loading interactive object " << ident);
 	
 	size_t size = 0; // TODO size not used
-	char * dat = pSaveBlock->load(ident, size);
+	char * dat = ARX_CHANGELEVEL_LoadFile(ident, size);
 	if(!dat) {
 		LogError << "Unable to Open " << ident << " for Read...";
 		return NULL;
@@ -2125,8 +2276,6 @@ static Entity * ARX_CHANGELEVEL_Pop_IO(const string & ident, long num) {
 				continue;
 			}
 			
-			ActiveTimers++;
-			
 			if(ats->script) {
 				scr_timer[num].es = &io->over_script;
 			} else {
@@ -2134,7 +2283,6 @@ static Entity * ARX_CHANGELEVEL_Pop_IO(const string & ident, long num) {
 			}
 			
 			scr_timer[num].flags = sFlags;
-			scr_timer[num].exist = 1;
 			scr_timer[num].io = io;
 			scr_timer[num].msecs = ats->msecs;
 			scr_timer[num].name = boost::to_lower_copy(util::loadString(ats->name));
@@ -2149,6 +2297,8 @@ static Entity * ARX_CHANGELEVEL_Pop_IO(const string & ident, long num) {
 			}
 			
 			scr_timer[num].times = ats->times;
+			
+			ARX_SCRIPT_Timer_Register(num);
 		}
 		
 		if(!loadScriptData(io->script, dat, pos) || !loadScriptData(io->over_script, dat, pos)) {
@@ -2547,7 +2697,7 @@ static void ARX_CHANGELEVEL_Pop_Globals() {
 	ARX_SCRIPT_Free_All_Global_Variables();
 	
 	size_t size;
-	char * dat = pSaveBlock->load("globals", size);
+	char * dat = ARX_CHANGELEVEL_LoadFile("globals", size);
 	if(!dat) {
 		LogError << "Unable to Open globals for Read...";
 		return;
@@ -2647,6 +2797,8 @@ static bool ARX_CHANGELEVEL_PopLevel(long instance, long reloadflag) {
 		NO_PLAYER_POSITION_RESET = 1;
 	}
 	LogDebug("firstTime = " << firstTime);
+	g_levelCache.touch(instance);
+	g_levelCache.logStats();
 	
 	PROGRESS_BAR_COUNT += 2.f;
 	LoadLevelScreen(instance);
@@ -2687,11 +2839,7 @@ static bool ARX_CHANGELEVEL_PopLevel(long instance, long reloadflag) {
 	
 	if(firstTime) {
 		unsigned long ulDTime = checked_range_cast<unsigned long>(ARX_CHANGELEVEL_DesiredTime);
-		for(long i = 0; i < MAX_TIMER_SCRIPT; i++) {
-			if(scr_timer[i].exist) {
-				scr_timer[i].tim = ulDTime;
-			}
-		}
+		ARX_SCRIPT_Timer_Restart(ulDTime);
 	} else {
 		LogDebug("Before ARX_CHANGELEVEL_PopAllIO");
 		ARX_CHANGELEVEL_PopAllIO(&asi);
@@ -2843,25 +2991,23 @@ static bool ARX_CHANGELEVEL_Get_Player_LevelData(ARX_CHANGELEVEL_PLAYER_LEVEL_DA
 		return false;
 	}
 	
-	size_t size;
-	char * dat = SaveBlock::load(savefile, "pld", size);
-	if(!dat) {
+	// Load the data straight into pld
+	size_t size = sizeof(ARX_CHANGELEVEL_PLAYER_LEVEL_DATA);
+	if(!SaveBlock::load(savefile, "pld", reinterpret_cast<char *>(&pld), size)) {
 		LogError << "Unable to open pld in " << savefile;
 		return false;
 	}
 	
-	// Stores Data in pld
-	memcpy(&pld, dat, sizeof(ARX_CHANGELEVEL_PLAYER_LEVEL_DATA));
+	if(size != sizeof(ARX_CHANGELEVEL_PLAYER_LEVEL_DATA)) {
+		LogError << "Truncated data";
+		return false;
+	}
 	
 	if(pld.version != ARX_GAMESAVE_VERSION) {
 		LogError << "Invalid GameSave Version";
-		free(dat);
 		return false;
 	}
 	
-	// Release Data
-	free(dat);
-	
 	return true;
 }
 
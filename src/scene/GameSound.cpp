@@ -71,6 +71,7 @@ ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
 #include "io/log/Logger.h"
 
 #include "platform/Platform.h"
+#include "platform/Profiler.h"
 #include "platform/Thread.h"
 
 #include "scene/Interactive.h"
@@ -1842,6 +1843,7 @@ class SoundUpdateThread : public StoppableThread {
 			
 			sleep(ARX_SOUND_UPDATE_INTERVAL);
 			
+			ARX_PROFILE("audio::update");
 			audio::update();
 		}
 		
@@ -59,6 +59,7 @@ ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
 #include "ai/Paths.h"
 
 #include "animation/Animation.h"
+#include "animation/AnimationRender.h"
 
 #include "core/Application.h"
 #include "core/GameTime.h"
@@ -100,7 +101,10 @@ ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
 #include "physics/Box.h"
 #include "physics/Clothes.h"
 
+#include "platform/Profiler.h"
+#include "platform/ProgramOptions.h"
 #include "platform/Thread.h"
+#include "platform/ThreadPool.h"
 
 #include "scene/ChangeLevel.h"
 #include "scene/GameSound.h"
@@ -1400,15 +1404,14 @@ void ARX_INTERACTIVE_TeleportBehindTarget(Entity * io)
 
 		if(num != -1) {
 			long t = io->index();
-			ActiveTimers++;
 			scr_timer[num].es = NULL;
-			scr_timer[num].exist = 1;
 			scr_timer[num].io = io;
 			scr_timer[num].msecs = Random::get(3000, 6000);
 			scr_timer[num].name = "_r_a_t_";
 			scr_timer[num].pos = -1; 
 			scr_timer[num].tim = (unsigned long)(arxtime);
 			scr_timer[num].times = 1;
+			ARX_SCRIPT_Timer_Register(num);
 			entities[t]->show = SHOW_FLAG_TELEPORTING;
 			AddRandomSmoke(io, 10);
 			ARX_PARTICLES_Add_Smoke(&io->pos, 3, 20);
@@ -2953,11 +2956,133 @@ EERIEMATRIX convertToMatrixForDrawEERIEInter(const PHYSICS_BOX_DATA &box) {
 	return mat;
 }
 
+namespace {
+
+/*!
+ * Level of detail for animated entities, chosen by their size on screen.
+ * Entities still move and are skinned every frame, only the animation
+ * sampling and lighting are reduced.
+ */
+enum AnimationLOD {
+	AnimationLODAuto = -1,
+	AnimationLODFull,    //!< Sample the animation every frame, light every vertex
+	AnimationLODReduced, //!< Sample the animation every other frame
+	AnimationLODLow      //!< Sample the animation every fourth frame, light per bone
+};
+
+//! Largest on-screen size, as a fraction of the screen height, for each reduced LOD
+const float ANIMATION_LOD_SIZE[] = { 0.f, 1.f / 6, 1.f / 16 };
+const unsigned ANIMATION_LOD_INTERVAL[] = { 1, 2, 4 };
+
+AnimationLOD g_forcedAnimationLOD = AnimationLODAuto;
+unsigned g_animationLODFrame = 0;
+AnimationLODStats g_animationLODStats;
+
+//! An animated entity that is posed by RenderInter()
+struct AnimatedEntity {
+	
+	Entity * io;
+	Anglef angle;
+	Vec3f pos;
+	Vec3f ftr;
+	float scale;
+	bool render;
+	bool parallel; //!< false if the object is shared with an earlier entity in the list
+	AnimationLOD lod;
+	bool updatePose;
+	
+};
+
+std::vector<AnimatedEntity> animatedEntities;
+std::vector<std::pair<EERIE_3DOBJ *, size_t> > animatedObjects;
+
+void ARX_INTERACTIVE_SetAnimationLOD(const std::string & level) {
+	if(level == "full") {
+		g_forcedAnimationLOD = AnimationLODFull;
+	} else if(level == "reduced") {
+		g_forcedAnimationLOD = AnimationLODReduced;
+	} else if(level == "low") {
+		g_forcedAnimationLOD = AnimationLODLow;
+	} else {
+		LogWarning << "Unknown animation LOD: " << level;
+		g_forcedAnimationLOD = AnimationLODAuto;
+	}
+}
+
+//! Choose a level of detail using the bounding box from the last frame.
+AnimationLOD ARX_INTERACTIVE_GetAnimationLOD(const Entity * io) {
+	
+	if(g_forcedAnimationLOD != AnimationLODAuto) {
+		return g_forcedAnimationLOD;
+	}
+	
+	// Entities that weren't visible last frame have no usable bounding box
+	if(EDITMODE || io->bbox2.x < io->bbox1.x || io->bbox2.y < io->bbox1.y) {
+		return AnimationLODFull;
+	}
+	
+	float size = float(std::max(io->bbox2.x - io->bbox1.x, io->bbox2.y - io->bbox1.y));
+	size /= float(DANAESIZY);
+	
+	if(size < ANIMATION_LOD_SIZE[AnimationLODLow]) {
+		return AnimationLODLow;
+	} else if(size < ANIMATION_LOD_SIZE[AnimationLODReduced]) {
+		return AnimationLODReduced;
+	}
+	
+	return AnimationLODFull;
+}
+
+void ARX_INTERACTIVE_PoseJob(void * data, size_t index) {
+	
+	ARX_UNUSED(data);
+	
+	AnimatedEntity & entry = animatedEntities[index];
+	if(!entry.parallel) {
+		return;
+	}
+	
+	Entity * io = entry.io;
+	Vec2f bboxMin, bboxMax;
+	Cedric_AnimateEntity(io->obj, &io->animlayer[0], &entry.angle, &entry.pos, io, entry.ftr,
+	                     entry.scale, bboxMin, bboxMax, entry.updatePose);
+}
+
+void ARX_INTERACTIVE_DrawEditorBBox(Entity * io) {
+	
+	Color color = Color::blue;
+	if(io->bbox1.x != io->bbox2.x && io->bbox1.x < DANAESIZX) {
+		EERIEDraw2DLine(io->bbox1.x, io->bbox1.y, io->bbox2.x, io->bbox1.y, 0.01f, color);
+		EERIEDraw2DLine(io->bbox2.x, io->bbox1.y, io->bbox2.x, io->bbox2.y, 0.01f, color);
+		EERIEDraw2DLine(io->bbox2.x, io->bbox2.y, io->bbox1.x, io->bbox2.y, 0.01f, color);
+		EERIEDraw2DLine(io->bbox1.x, io->bbox2.y, io->bbox1.x, io->bbox1.y, 0.01f, color);
+	}
+}
+
+} // anonymous namespace
+
+ARX_PROGRAM_OPTION("animation-lod", "a",
+                   "Force the animation level of detail for all entities (full, reduced or low)",
+                   &ARX_INTERACTIVE_SetAnimationLOD, "LEVEL");
+
+const AnimationLODStats & ARX_INTERACTIVE_GetAnimationLODStats() {
+	return g_animationLODStats;
+}
+
 /**
  * @brief Render entities
+ * 
+ * Animated entities are drawn in three steps: the animations are advanced for all
+ * entities, then the skeletons are posed and skinned in parallel and finally the
+ * results are drawn.
  */
 void RenderInter() {
-
+	
+	ARX_PROFILE_FUNC();
+	
+	animatedEntities.clear();
+	g_animationLODFrame++;
+	
 	for(size_t i = 1; i < entities.size(); i++) { // Player isn't rendered here...		
 		Entity * io = entities[i];
 
@@ -2973,6 +3098,8 @@ void RenderInter() {
 		}
 
 		UpdateIOInvisibility(io);
+		
+		AnimationLOD lod = ARX_INTERACTIVE_GetAnimationLOD(io);
 
 		io->bbox1.x = 9999;
 		io->bbox2.x = -1;
@@ -3004,10 +3131,22 @@ void RenderInter() {
 				pos.y = io->_npcdata->vvpos;
 			}
 
-			bool render = (EDITMODE || !ARX_SCENE_PORTAL_Basic_ClipIO(io));
-
-			EERIEDrawAnimQuat(io->obj, &io->animlayer[0], &temp, &pos, diff, io, render);
-
+			AnimatedEntity entry;
+			entry.io = io;
+			entry.angle = temp;
+			entry.pos = pos;
+			entry.render = (EDITMODE || !ARX_SCENE_PORTAL_Basic_ClipIO(io));
+			entry.parallel = true;
+			entry.lod = lod;
+			
+			if(EERIEPrepareAnimQuat(io->obj, &io->animlayer[0], diff, io, true, entry.ftr, entry.scale)) {
+				animatedEntities.push_back(entry);
+			} else if(EDITMODE) {
+				ARX_INTERACTIVE_DrawEditorBBox(io);
+			}
+			
+			continue;
+			
 		} else {
 			if(!EDITMODE && ARX_SCENE_PORTAL_Basic_ClipIO(io))
 				continue;
@@ -3055,13 +3194,61 @@ void RenderInter() {
 		}
 
 		if(EDITMODE) {
-			Color color = Color::blue;
-			if(io->bbox1.x != io->bbox2.x && io->bbox1.x < DANAESIZX) {
-				EERIEDraw2DLine(io->bbox1.x, io->bbox1.y, io->bbox2.x, io->bbox1.y, 0.01f, color);
-				EERIEDraw2DLine(io->bbox2.x, io->bbox1.y, io->bbox2.x, io->bbox2.y, 0.01f, color);
-				EERIEDraw2DLine(io->bbox2.x, io->bbox2.y, io->bbox1.x, io->bbox2.y, 0.01f, color);
-				EERIEDraw2DLine(io->bbox1.x, io->bbox2.y, io->bbox1.x, io->bbox1.y, 0.01f, color);
-			}
+			ARX_INTERACTIVE_DrawEditorBBox(io);
+		}
+	}
+	
+	// Entities sharing the same object can't be posed in parallel
+	animatedObjects.clear();
+	for(size_t i = 0; i < animatedEntities.size(); i++) {
+		animatedObjects.push_back(std::make_pair(animatedEntities[i].io->obj, i));
+	}
+	std::sort(animatedObjects.begin(), animatedObjects.end());
+	for(size_t i = 1; i < animatedObjects.size(); i++) {
+		if(animatedObjects[i].first == animatedObjects[i - 1].first) {
+			animatedEntities[animatedObjects[i].second].parallel = false;
+			// Shared objects don't keep the pose of one entity between frames
+			animatedEntities[animatedObjects[i].second].lod = AnimationLODFull;
+			animatedEntities[animatedObjects[i - 1].second].lod = AnimationLODFull;
+		}
+	}
+	
+	memset(&g_animationLODStats, 0, sizeof(g_animationLODStats));
+	for(size_t i = 0; i < animatedEntities.size(); i++) {
+		AnimatedEntity & entry = animatedEntities[i];
+		// Stagger the updates so that not all entities are sampled in the same frame
+		size_t phase = g_animationLODFrame + entry.io->index();
+		entry.updatePose = (phase % ANIMATION_LOD_INTERVAL[entry.lod] == 0);
+		switch(entry.lod) {
+			case AnimationLODReduced: g_animationLODStats.reduced++; break;
+			case AnimationLODLow: g_animationLODStats.low++; break;
+			default: g_animationLODStats.full++; break;
+		}
+		if(!entry.updatePose) {
+			g_animationLODStats.skippedPoses++;
+		}
+	}
+	
+	{
+		ARX_PROFILE("Pose entities");
+		ThreadPool::run(ARX_INTERACTIVE_PoseJob, NULL, animatedEntities.size());
+	}
+	
+	for(size_t i = 0; i < animatedEntities.size(); i++) {
+		
+		AnimatedEntity & entry = animatedEntities[i];
+		Entity * io = entry.io;
+		
+		if(!entry.parallel) {
+			Cedric_AnimateDrawEntity(io->obj, &io->animlayer[0], &entry.angle, &entry.pos, io,
+			                         entry.ftr, entry.scale);
+		}
+		
+		EERIEFinishAnimQuat(io->obj, &entry.pos, entry.ftr, io, entry.render,
+		                    entry.lod != AnimationLODLow);
+		
+		if(EDITMODE) {
+			ARX_INTERACTIVE_DrawEditorBBox(io);
 		}
 	}
 }
@@ -210,6 +210,16 @@ void UpdateCameras();
 Entity * InterClick(Vec2s * pos);
  
 void RenderInter();
+
+//! Animated entities drawn by the last RenderInter() call, by level of detail
+struct AnimationLODStats {
+	size_t full; //!< Posed every frame and lit per vertex
+	size_t reduced; //!< Posed every other frame
+	size_t low; //!< Posed every fourth frame and lit per bone
+	size_t skippedPoses; //!< Entities that reused the pose from an earlier frame
+};
+
+const AnimationLODStats & ARX_INTERACTIVE_GetAnimationLODStats();
 void SetWeapon_On(Entity * io);
  
 void Prepare_SetWeapon(Entity * io, const res::path & temp);
@@ -47,10 +47,14 @@ ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
 #include "scene/Object.h"
 
 #include <cstdio>
+#include <string>
+#include <vector>
 
 #include <boost/algorithm/string/case_conv.hpp>
 #include <boost/algorithm/string/predicate.hpp>
 
+#include "animation/AnimationTracks.h"
+
 #include "core/Config.h"
 #include "core/Core.h"
 
@@ -64,6 +68,8 @@ ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
 #include "graphics/data/TextureContainer.h"
 
 #include "io/fs/FilePath.h"
+#include "io/fs/FileStream.h"
+#include "io/fs/Filesystem.h"
 #include "io/fs/SystemPaths.h"
 #include "io/resource/ResourcePath.h"
 #include "io/resource/PakReader.h"
@@ -73,6 +79,7 @@ ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
 #include "physics/Box.h"
 #include "physics/CollisionShapes.h"
 
+
 #include "scene/LinkedObject.h"
 #include "scene/GameSound.h"
 #include "scene/ObjectFormat.h"
@@ -211,7 +218,7 @@ void ReleaseAnim(EERIE_ANIM * ea) {
 		free(ea->frames);
 	}
 	
-	free(ea->groups);
+	delete ea->groups;
 	free(ea->voidgroups);
 	free(ea);
 }
@@ -244,9 +251,53 @@ static T * copyStruct(const T * src, size_t n = 1) {
 	return result;
 }
 
-EERIE_ANIM * TheaToEerie(const char * adr, size_t size, const res::path & file) {
+//! FNV-1a hash of an animation file, used to detect outdated caches
+static u32 getAnimationHash(const char * data, size_t size) {
+	u32 hash = 2166136261u;
+	for(size_t i = 0; i < size; i++) {
+		hash = (hash ^ u8(data[i])) * 16777619u;
+	}
+	return hash;
+}
+
+/*!
+ * Compress the group key frames of an animation, or load them from the cache
+ * in the user directory if the animation file hasn't changed.
+ */
+static AnimationTracks * loadAnimationTracks(const std::vector<EERIE_GROUP> & groups,
+                                             const EERIE_FRAME * frames, size_t nb_key_frames,
+                                             size_t nb_groups, const char * adr, size_t size,
+                                             const res::path & file) {
+	
+	AnimationTracks * tracks = new AnimationTracks;
+	
+	u32 hash = getAnimationHash(adr, size);
+	fs::path cache;
+	if(!fs::paths.user.empty()) {
+		cache = fs::paths.user / "cache" / file.string();
+		cache.set_ext("anc");
+		std::string data = fs::read(cache);
+		if(!data.empty() && tracks->deserialize(data.data(), data.size(), hash)
+		   && tracks->keys() == nb_key_frames && tracks->groups() == nb_groups) {
+			return tracks;
+		}
+	}
 	
-	(void)size; // TODO use size
+	tracks->build(groups.empty() ? NULL : &groups[0], frames, nb_key_frames, nb_groups);
+	
+	if(!cache.empty() && fs::create_directories(cache.parent())) {
+		std::string data;
+		tracks->serialize(data, hash);
+		fs::ofstream ofs(cache, fs::fstream::out | fs::fstream::binary | fs::fstream::trunc);
+		if(!ofs.is_open() || !fs::write(ofs, data.data(), data.size())) {
+			LogWarning << "Could not write animation cache " << cache;
+		}
+	}
+	
+	return tracks;
+}
+
+EERIE_ANIM * TheaToEerie(const char * adr, size_t size, const res::path & file) {
 	
 	LogDebug("Loading animation file " << file);
 	
@@ -271,7 +322,7 @@ EERIE_ANIM * TheaToEerie(const char * adr, size_t size, const res::path & file)
 	eerie->nb_key_frames = th->nb_key_frames;
 	
 	eerie->frames = allocStructZero<EERIE_FRAME>(th->nb_key_frames);
-	eerie->groups = allocStructZero<EERIE_GROUP>(th->nb_key_frames * th->nb_groups);
+	std::vector<EERIE_GROUP> groups(th->nb_key_frames * th->nb_groups);
 	eerie->voidgroups = allocStructZero<unsigned char>(th->nb_groups);
 	
 	eerie->anim_time = 0;
@@ -356,11 +407,11 @@ EERIE_ANIM * TheaToEerie(const char * adr, size_t size, const res::path & file)
 			const THEO_GROUPANIM * tga = reinterpret_cast<const THEO_GROUPANIM *>(adr + pos);
 			pos += sizeof(THEO_GROUPANIM);
 			
-			EERIE_GROUP * eg = &eerie->groups[j + i * th->nb_groups];
-			eg->key = tga->key_group;
-			eg->quat = tga->Quaternion;
-			eg->translate = tga->translate;
-			eg->zoom = tga->zoom;
+			EERIE_GROUP & eg = groups[j + i * th->nb_groups];
+			eg.key = tga->key_group;
+			eg.quat = tga->Quaternion;
+			eg.translate = tga->translate;
+			eg.zoom = tga->zoom;
 		}
 		
 		// Now Read Sound Data included in this frame
@@ -447,12 +498,12 @@ EERIE_ANIM * TheaToEerie(const char * adr, size_t size, const res::path & file)
 		for(long j = 0; j < eerie->nb_key_frames; j++) {
 			long pos = i + (j * eerie->nb_groups);
 			
-			if((eerie->groups[pos].quat.x != 0.f)
-			   || (eerie->groups[pos].quat.y != 0.f)
-			   || (eerie->groups[pos].quat.z != 0.f)
-			   || (eerie->groups[pos].quat.w != 1.f)
-			   || eerie->groups[pos].translate != Vec3f::ZERO
-			   || eerie->groups[pos].zoom != Vec3f::ZERO) {
+			if((groups[pos].quat.x != 0.f)
+			   || (groups[pos].quat.y != 0.f)
+			   || (groups[pos].quat.z != 0.f)
+			   || (groups[pos].quat.w != 1.f)
+			   || groups[pos].translate != Vec3f::ZERO
+			   || groups[pos].zoom != Vec3f::ZERO) {
 				voidd = false;
 				break;
 			}
@@ -468,6 +519,13 @@ EERIE_ANIM * TheaToEerie(const char * adr, size_t size, const res::path & file)
 		eerie->anim_time = 1;
 	}
 	
+	eerie->groups = loadAnimationTracks(groups, eerie->frames, th->nb_key_frames, th->nb_groups,
+	                                    adr, size, file);
+	
+	LogDebug("Compressed " << eerie->groups->rawSize() << " bytes of key frames to "
+	         << eerie->groups->memorySize() << ", " << eerie->groups->storedKeys() << " of "
+	         << (th->nb_key_frames * th->nb_groups * 3) << " keys");
+	
 	LogDebug("Finished Conversion TEA -> EERIE - " << (eerie->anim_time / 1000) << " seconds");
 	
 	return eerie;
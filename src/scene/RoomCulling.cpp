@@ -0,0 +1,217 @@
+/*
+ * Copyright 2013 Arx Libertatis Team (see the AUTHORS file)
+ *
+ * This file is part of Arx Libertatis.
+ *
+ * Arx Libertatis is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Arx Libertatis is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Arx Libertatis.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "scene/RoomCulling.h"
+
+#ifdef ARX_HAVE_SSE2_CULLING
+#include <emmintrin.h>
+#endif
+
+void RoomCullData::resize(size_t count) {
+	
+	// Pad to a multiple of four for the SIMD kernels
+	size_t size = (count + 3) & ~size_t(3);
+	
+	m_cx.resize(size), m_cy.resize(size), m_cz.resize(size), m_radius.resize(size);
+	m_n1x.resize(size), m_n1y.resize(size), m_n1z.resize(size);
+	m_n2x.resize(size), m_n2y.resize(size), m_n2z.resize(size);
+	m_vx.resize(size), m_vy.resize(size), m_vz.resize(size);
+	m_flags.resize(size, 0);
+}
+
+void RoomCullData::clear() {
+	m_count = 0;
+	resize(0);
+}
+
+void RoomCullData::add(const EERIEPOLY & ep, bool drawable) {
+	
+	size_t i = m_count;
+	resize(++m_count);
+	
+	m_cx[i] = ep.center.x, m_cy[i] = ep.center.y, m_cz[i] = ep.center.z;
+	m_radius[i] = ep.v[0].rhw;
+	
+	m_n1x[i] = ep.norm.x, m_n1y[i] = ep.norm.y, m_n1z[i] = ep.norm.z;
+	const Vec3f & norm2 = (ep.type & POLY_QUAD) ? ep.norm2 : ep.norm;
+	m_n2x[i] = norm2.x, m_n2y[i] = norm2.y, m_n2z[i] = norm2.z;
+	
+	m_vx[i] = ep.v[2].p.x, m_vy[i] = ep.v[2].p.y, m_vz[i] = ep.v[2].p.z;
+	
+	m_flags[i] = (drawable ? Drawable : 0) | ((ep.type & POLY_DOUBLESIDED) ? 0 : SingleSided);
+}
+
+size_t RoomCullData::cull(const EERIE_FRUSTRUM_DATA & frustrums,
+                          const EERIE_FRUSTRUM_PLANE & near, const Vec3f & camera,
+                          u32 * visible, float * dist) const {
+#ifdef ARX_HAVE_SSE2_CULLING
+	return cullSSE2(frustrums, near, camera, visible, dist);
+#else
+	return cullScalar(frustrums, near, camera, visible, dist);
+#endif
+}
+
+size_t RoomCullData::cullScalar(const EERIE_FRUSTRUM_DATA & frustrums,
+                                const EERIE_FRUSTRUM_PLANE & near, const Vec3f & camera,
+                                u32 * visible, float * dist) const {
+	
+	size_t count = 0;
+	
+	for(size_t i = 0; i < m_count; i++) {
+		
+		if(!(m_flags[i] & Drawable)) {
+			continue;
+		}
+		
+		float x = m_cx[i], y = m_cy[i], z = m_cz[i], r = m_radius[i];
+		
+		bool inside = false;
+		for(long f = 0; f < frustrums.nb_frustrums && !inside; f++) {
+			const EERIE_FRUSTRUM_PLANE * planes = frustrums.frustrums[f].plane;
+			inside = true;
+			for(long p = 0; p < 4; p++) {
+				float d = x * planes[p].a + y * planes[p].b + z * planes[p].c + planes[p].d;
+				if(!(d + r > 0)) {
+					inside = false;
+					break;
+				}
+			}
+		}
+		if(!inside) {
+			continue;
+		}
+		
+		float fDist = x * near.a + y * near.b + z * near.c + near.d;
+		if(r < -fDist) {
+			continue;
+		}
+		
+		if(m_flags[i] & SingleSided) {
+			float nx = m_vx[i] - camera.x, ny = m_vy[i] - camera.y, nz = m_vz[i] - camera.z;
+			float d1 = m_n1x[i] * nx + m_n1y[i] * ny + m_n1z[i] * nz;
+			float d2 = m_n2x[i] * nx + m_n2y[i] * ny + m_n2z[i] * nz;
+			if(d1 > 0.f && d2 > 0.f) {
+				continue;
+			}
+		}
+		
+		visible[count] = u32(i);
+		dist[count] = fDist - r;
+		count++;
+	}
+	
+	return count;
+}
+
+#ifdef ARX_HAVE_SSE2_CULLING
+
+size_t RoomCullData::cullSSE2(const EERIE_FRUSTRUM_DATA & frustrums,
+                              const EERIE_FRUSTRUM_PLANE & near, const Vec3f & camera,
+                              u32 * visible, float * dist) const {
+	
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 sign = _mm_castsi128_ps(_mm_set1_epi32(0x80000000));
+	const __m128i drawable = _mm_set1_epi32(Drawable);
+	const __m128i singleSided = _mm_set1_epi32(SingleSided);
+	
+	const __m128 na = _mm_set1_ps(near.a), nb = _mm_set1_ps(near.b);
+	const __m128 nc = _mm_set1_ps(near.c), nd = _mm_set1_ps(near.d);
+	const __m128 camx = _mm_set1_ps(camera.x);
+	const __m128 camy = _mm_set1_ps(camera.y);
+	const __m128 camz = _mm_set1_ps(camera.z);
+	
+	size_t count = 0;
+	
+	for(size_t i = 0; i < m_count; i += 4) {
+		
+		__m128i flags = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&m_flags[i]));
+		__m128 mask = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(flags, drawable),
+		                                               drawable));
+		if(!_mm_movemask_ps(mask)) {
+			continue;
+		}
+		
+		__m128 x = _mm_loadu_ps(&m_cx[i]);
+		__m128 y = _mm_loadu_ps(&m_cy[i]);
+		__m128 z = _mm_loadu_ps(&m_cz[i]);
+		__m128 r = _mm_loadu_ps(&m_radius[i]);
+		
+		// Frustum test: visible if inside all four planes of any frustum
+		__m128 inside = zero;
+		for(long f = 0; f < frustrums.nb_frustrums; f++) {
+			const EERIE_FRUSTRUM_PLANE * planes = frustrums.frustrums[f].plane;
+			__m128 in = mask;
+			for(long p = 0; p < 4; p++) {
+				__m128 d = _mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(planes[p].a)),
+				                      _mm_mul_ps(y, _mm_set1_ps(planes[p].b)));
+				d = _mm_add_ps(d, _mm_mul_ps(z, _mm_set1_ps(planes[p].c)));
+				d = _mm_add_ps(d, _mm_set1_ps(planes[p].d));
+				in = _mm_and_ps(in, _mm_cmpgt_ps(_mm_add_ps(d, r), zero));
+			}
+			inside = _mm_or_ps(inside, in);
+			if(_mm_movemask_ps(inside) == _mm_movemask_ps(mask)) {
+				break;
+			}
+		}
+		mask = _mm_and_ps(mask, inside);
+		if(!_mm_movemask_ps(mask)) {
+			continue;
+		}
+		
+		// Near plane test
+		__m128 fDist = _mm_add_ps(_mm_mul_ps(x, na), _mm_mul_ps(y, nb));
+		fDist = _mm_add_ps(fDist, _mm_mul_ps(z, nc));
+		fDist = _mm_add_ps(fDist, nd);
+		mask = _mm_and_ps(mask, _mm_cmpnlt_ps(r, _mm_xor_ps(fDist, sign)));
+		
+		// Backface test
+		__m128 nx = _mm_sub_ps(_mm_loadu_ps(&m_vx[i]), camx);
+		__m128 ny = _mm_sub_ps(_mm_loadu_ps(&m_vy[i]), camy);
+		__m128 nz = _mm_sub_ps(_mm_loadu_ps(&m_vz[i]), camz);
+		__m128 d1 = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&m_n1x[i]), nx),
+		                       _mm_mul_ps(_mm_loadu_ps(&m_n1y[i]), ny));
+		d1 = _mm_add_ps(d1, _mm_mul_ps(_mm_loadu_ps(&m_n1z[i]), nz));
+		__m128 d2 = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&m_n2x[i]), nx),
+		                       _mm_mul_ps(_mm_loadu_ps(&m_n2y[i]), ny));
+		d2 = _mm_add_ps(d2, _mm_mul_ps(_mm_loadu_ps(&m_n2z[i]), nz));
+		__m128 back = _mm_and_ps(_mm_cmpgt_ps(d1, zero), _mm_cmpgt_ps(d2, zero));
+		back = _mm_and_ps(back, _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(flags, singleSided),
+		                                                         singleSided)));
+		mask = _mm_andnot_ps(back, mask);
+		
+		int bits = _mm_movemask_ps(mask);
+		if(!bits) {
+			continue;
+		}
+		
+		float distances[4];
+		_mm_storeu_ps(distances, _mm_sub_ps(fDist, r));
+		for(size_t j = 0; j < 4; j++) {
+			if(bits & (1 << j)) {
+				visible[count] = u32(i + j);
+				dist[count] = distances[j];
+				count++;
+			}
+		}
+	}
+	
+	return count;
+}
+
+#endif // ARX_HAVE_SSE2_CULLING
@@ -0,0 +1,108 @@
+/*
+ * Copyright 2013 Arx Libertatis Team (see the AUTHORS file)
+ *
+ * This file is part of Arx Libertatis.
+ *
+ * Arx Libertatis is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Arx Libertatis is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Arx Libertatis.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ARX_SCENE_ROOMCULLING_H
+#define ARX_SCENE_ROOMCULLING_H
+
+#include <stddef.h>
+#include <vector>
+
+#include "graphics/data/Mesh.h"
+#include "math/Vector3.h"
+#include "platform/Platform.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ARX_HAVE_SSE2_CULLING 1
+#endif
+
+/*!
+ * Structure-of-arrays copy of the data needed to cull the polygons of a room.
+ * 
+ * Polygons are tested against the bounding spheres of the room's frustums,
+ * the near plane and the camera position for backface culling.
+ * The arrays are padded to a multiple of four entries so that they can be
+ * processed in SIMD batches - padding entries are never visible.
+ */
+class RoomCullData {
+	
+	enum Flags {
+		Drawable = (1 << 0), //!< Polygon has a texture and is not hidden
+		SingleSided = (1 << 1) //!< Polygon can be backface-culled
+	};
+	
+	size_t m_count;
+	
+	// Bounding sphere
+	std::vector<float> m_cx, m_cy, m_cz, m_radius;
+	
+	// Normals - norm2 is a copy of norm for triangles
+	std::vector<float> m_n1x, m_n1y, m_n1z;
+	std::vector<float> m_n2x, m_n2y, m_n2z;
+	
+	// Vertex used for backface culling
+	std::vector<float> m_vx, m_vy, m_vz;
+	
+	std::vector<u32> m_flags;
+	
+	void resize(size_t count);
+	
+public:
+	
+	RoomCullData() : m_count(0) { }
+	
+	void clear();
+	
+	/*!
+	 * Add a polygon.
+	 * @param drawable false if the polygon should never be returned as visible.
+	 */
+	void add(const EERIEPOLY & ep, bool drawable);
+	
+	//! @return the number of polygons added
+	size_t size() const { return m_count; }
+	
+	/*!
+	 * Cull all polygons of the room.
+	 * 
+	 * A polygon is visible if it is drawable, its bounding sphere intersects at least one
+	 * of the frustums and lies at least partially in front of the near plane and it is either
+	 * double-sided or faces the camera.
+	 * 
+	 * @param visible Receives the indices of all visible polygons in increasing order.
+	 *                Must have room for size() entries.
+	 * @param dist    Receives the distance from each visible polygon's bounding sphere
+	 *                to the near plane. Must have room for size() entries.
+	 * @return the number of visible polygons.
+	 */
+	size_t cull(const EERIE_FRUSTRUM_DATA & frustrums, const EERIE_FRUSTRUM_PLANE & near,
+	            const Vec3f & camera, u32 * visible, float * dist) const;
+	
+	//! Portable implementation of cull()
+	size_t cullScalar(const EERIE_FRUSTRUM_DATA & frustrums, const EERIE_FRUSTRUM_PLANE & near,
+	                  const Vec3f & camera, u32 * visible, float * dist) const;
+	
+#ifdef ARX_HAVE_SSE2_CULLING
+	//! SSE2 implementation of cull() - processes four polygons at once
+	size_t cullSSE2(const EERIE_FRUSTRUM_DATA & frustrums, const EERIE_FRUSTRUM_PLANE & near,
+	                const Vec3f & camera, u32 * visible, float * dist) const;
+#endif
+	
+};
+
+#endif // ARX_SCENE_ROOMCULLING_H
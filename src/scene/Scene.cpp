@@ -78,8 +78,12 @@ ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
 
 #include "io/log/Logger.h"
 
+#include "platform/Profiler.h"
+#include "platform/ThreadPool.h"
+
 #include "scene/Light.h"
 #include "scene/Interactive.h"
+#include "scene/RoomCulling.h"
 
 using std::vector;
 
@@ -178,6 +182,14 @@ EERIE_FRUSTRUM_PLANE efpPlaneNear;
 static vector<EERIEPOLY*> vPolyWater;
 static vector<EERIEPOLY*> vPolyLava;
 
+//! Visible polygons of one room in RoomDrawList, filled by the culling jobs
+struct RoomCullResult {
+	std::vector<u32> polys;
+	std::vector<float> dist;
+	size_t count;
+};
+static vector<RoomCullResult> vRoomCullResults;
+
 void PopAllTriangleListTransparency();
 
 std::vector<PORTAL_ROOM_DRAW> RoomDraw;
@@ -731,15 +743,6 @@ bool IsSphereInFrustrum(float radius, const Vec3f *point, const EERIE_FRUSTRUM *
 	
 }
 
-bool FrustrumsClipPoly(EERIE_FRUSTRUM_DATA *frustrums, EERIEPOLY *ep){
-	for(long i=0; i<frustrums->nb_frustrums; i++) {
-		if(IsSphereInFrustrum(ep->v[0].rhw, &ep->center, &frustrums->frustrums[i]))
-			return false;
-	}
-
-	return true;
-}
-
 void Frustrum_Set(EERIE_FRUSTRUM * fr,long plane,float a,float b,float c,float d)
 {
 	fr->plane[plane].a=a;
@@ -1297,21 +1300,24 @@ void ClearTileLights() {
 	}
 }
 
-void ARX_PORTALS_Frustrum_RenderRoomTCullSoft(long room_num, EERIE_FRUSTRUM_DATA *frustrums, long tim) {
+static bool ARX_PORTALS_HasRoomGeometry(long room_num) {
+	
 	if(!RoomDraw[room_num].count)
-		return;
-
+		return false;
+	
 	if(!portals->room[room_num].pVertexBuffer) {
 		// No need to spam this for every frame as there will already be an
 		// earlier warning
 		LogDebug("no vertex data for room " << room_num);
-		return;
+		return false;
 	}
+	
+	return true;
+}
 
-	SMY_VERTEX * pMyVertex = portals->room[room_num].pVertexBuffer->lock(NoOverwrite);
-
-	unsigned short *pIndices=portals->room[room_num].pussIndice;
-
+//! Compute lights for all tiles touched by a room
+static void ARX_PORTALS_ComputeRoomTileLights(long room_num) {
+	
 	EP_DATA *pEPDATA = &portals->room[room_num].epdata[0];
 
 	for(long lll=0; lll<portals->room[room_num].nb_polys; lll++, pEPDATA++) {
@@ -1338,91 +1344,101 @@ void ARX_PORTALS_Frustrum_RenderRoomTCullSoft(long room_num, EERIE_FRUSTRUM_DATA
 				}
 			}
 		}
+	}
+}
 
-		EERIEPOLY *ep = &feg->polydata[pEPDATA->idx];
-
-		if(!ep->tex) {
-			continue;
-		}
-
-		if(ep->type & (POLY_IGNORE | POLY_NODRAW| POLY_HIDE)) {
-			continue;
-		}
-
-		if(FrustrumsClipPoly(frustrums,ep)) {
-			continue;
-		}
-
-		//Clipp ZNear + Distance pour les ZMapps!!!
-		float fDist=(ep->center.x*efpPlaneNear.a + ep->center.y*efpPlaneNear.b + ep->center.z*efpPlaneNear.c + efpPlaneNear.d);
-
-		if(ep->v[0].rhw<-fDist) {
-			continue;
-		}
-
-		fDist -= ep->v[0].rhw;
-
-		Vec3f nrm = ep->v[2].p - ACTIVECAM->orgTrans.pos;
-		int to = (ep->type & POLY_QUAD) ? 4 : 3;
-
-		if(to == 4) {
-			if(	(!(ep->type&POLY_DOUBLESIDED))&&
-				(dot( ep->norm , nrm )>0.f)&&
-				(dot( ep->norm2 , nrm )>0.f) )
-			{
-				continue;
-			}
-		} else {
-			if(	(!(ep->type&POLY_DOUBLESIDED))&&
-				(dot( ep->norm , nrm )>0.f) )
-			{
-				continue;
-			}
-		}
+/*!
+ * Cull the polygons of RoomDrawList[index] and append their indices to the
+ * room's cull lists.
+ * Runs on the thread pool: only touches data private to that room (the
+ * room's index buffer, its tMatRoom entries and its RoomCullResult).
+ */
+static void ARX_PORTALS_CullRoomJob(void * data, size_t index) {
+	
+	ARX_UNUSED(data);
+	
+	long room_num = RoomDrawList[index];
+	RoomCullResult & result = vRoomCullResults[index];
+	result.count = 0;
+	
+	if(!RoomDraw[room_num].count || !portals->room[room_num].pVertexBuffer) {
+		return;
+	}
+	
+	// Frustum, near plane (Clipp ZNear + Distance pour les ZMapps!!!) and backface culling
+	const RoomCullData & cullData = *portals->room[room_num].pCullData;
+	result.polys.resize(cullData.size() + 1);
+	result.dist.resize(cullData.size() + 1);
+	result.count = cullData.cull(RoomDraw[room_num].frustrum, efpPlaneNear,
+	                             ACTIVECAM->orgTrans.pos, &result.polys[0], &result.dist[0]);
+	
+	unsigned short *pIndices=portals->room[room_num].pussIndice;
+	
+	for(size_t lll = 0; lll < result.count; lll++) {
+		EP_DATA *pEPDATA = &portals->room[room_num].epdata[result.polys[lll]];
+		EERIEPOLY *ep = &ACTIVEBKG->fastdata[pEPDATA->px][pEPDATA->py].polydata[pEPDATA->idx];
+		SMY_ARXMAT & mat = ep->tex->tMatRoom[room_num];
 
 		unsigned short *pIndicesCurr;
 		unsigned long *pNumIndices;
 
 		if(ep->type & POLY_TRANS) {
 			if(ep->transval>=2.f) { //MULTIPLICATIVE
-				pIndicesCurr=pIndices+ep->tex->tMatRoom[room_num].uslStartCull_TMultiplicative+ep->tex->tMatRoom[room_num].uslNbIndiceCull_TMultiplicative;
-				pNumIndices=&ep->tex->tMatRoom[room_num].uslNbIndiceCull_TMultiplicative;
+				pIndicesCurr=pIndices+mat.uslStartCull_TMultiplicative+mat.uslNbIndiceCull_TMultiplicative;
+				pNumIndices=&mat.uslNbIndiceCull_TMultiplicative;
 			}else if(ep->transval>=1.f) { //ADDITIVE
-				pIndicesCurr=pIndices+ep->tex->tMatRoom[room_num].uslStartCull_TAdditive+ep->tex->tMatRoom[room_num].uslNbIndiceCull_TAdditive;
-				pNumIndices=&ep->tex->tMatRoom[room_num].uslNbIndiceCull_TAdditive;
+				pIndicesCurr=pIndices+mat.uslStartCull_TAdditive+mat.uslNbIndiceCull_TAdditive;
+				pNumIndices=&mat.uslNbIndiceCull_TAdditive;
 			} else if(ep->transval>0.f) { //NORMAL TRANS
-				pIndicesCurr=pIndices+ep->tex->tMatRoom[room_num].uslStartCull_TNormalTrans+ep->tex->tMatRoom[room_num].uslNbIndiceCull_TNormalTrans;
-				pNumIndices=&ep->tex->tMatRoom[room_num].uslNbIndiceCull_TNormalTrans;
+				pIndicesCurr=pIndices+mat.uslStartCull_TNormalTrans+mat.uslNbIndiceCull_TNormalTrans;
+				pNumIndices=&mat.uslNbIndiceCull_TNormalTrans;
 			} else { //SUBTRACTIVE
-				pIndicesCurr=pIndices+ep->tex->tMatRoom[room_num].uslStartCull_TSubstractive+ep->tex->tMatRoom[room_num].uslNbIndiceCull_TSubstractive;
-				pNumIndices=&ep->tex->tMatRoom[room_num].uslNbIndiceCull_TSubstractive;
+				pIndicesCurr=pIndices+mat.uslStartCull_TSubstractive+mat.uslNbIndiceCull_TSubstractive;
+				pNumIndices=&mat.uslNbIndiceCull_TSubstractive;
 			}
 		} else {
-			pIndicesCurr=pIndices+ep->tex->tMatRoom[room_num].uslStartCull+ep->tex->tMatRoom[room_num].uslNbIndiceCull;
-			pNumIndices=&ep->tex->tMatRoom[room_num].uslNbIndiceCull;
-
-			if(ZMAPMODE) {
-				if((fDist<200)&&(ep->tex->TextureRefinement)) {
-					ep->tex->TextureRefinement->vPolyZMap.push_back(ep);
-				}
-			}
+			pIndicesCurr=pIndices+mat.uslStartCull+mat.uslNbIndiceCull;
+			pNumIndices=&mat.uslNbIndiceCull;
 		}
 
-		SMY_VERTEX *pMyVertexCurr;
-
 		*pIndicesCurr++ = ep->uslInd[0];
 		*pIndicesCurr++ = ep->uslInd[1];
 		*pIndicesCurr++ = ep->uslInd[2];
 		*pNumIndices += 3;
 
-		if(to == 4) {
+		if(ep->type & POLY_QUAD) {
 			*pIndicesCurr++ = ep->uslInd[3];
 			*pIndicesCurr++ = ep->uslInd[2];
 			*pIndicesCurr++ = ep->uslInd[1];
 			*pNumIndices += 3;
 		}
+	}
+}
 
-		pMyVertexCurr = &pMyVertex[ep->tex->tMatRoom[room_num].uslStartVertex];
+//! Update lighting and effects for the visible polygons of RoomDrawList[index]
+static void ARX_PORTALS_Frustrum_RenderRoomTCullSoft(size_t index, long tim) {
+	
+	long room_num = RoomDrawList[index];
+	const RoomCullResult & result = vRoomCullResults[index];
+	if(!result.count) {
+		return;
+	}
+	
+	SMY_VERTEX * pMyVertex = portals->room[room_num].pVertexBuffer->lock(NoOverwrite);
+
+	for(size_t lll = 0; lll < result.count; lll++) {
+		EP_DATA *pEPDATA = &portals->room[room_num].epdata[result.polys[lll]];
+		EERIEPOLY *ep = &ACTIVEBKG->fastdata[pEPDATA->px][pEPDATA->py].polydata[pEPDATA->idx];
+
+		int to = (ep->type & POLY_QUAD) ? 4 : 3;
+
+		if(ZMAPMODE && !(ep->type & POLY_TRANS)) {
+			if((result.dist[lll]<200)&&(ep->tex->TextureRefinement)) {
+				ep->tex->TextureRefinement->vPolyZMap.push_back(ep);
+			}
+		}
+
+		SMY_VERTEX *pMyVertexCurr = &pMyVertex[ep->tex->tMatRoom[room_num].uslStartVertex];
 
 		if(!Project.improve) { // Normal View...
 			if(ep->type & POLY_GLOW) {
@@ -1840,8 +1856,29 @@ void ARX_SCENE_Update() {
 		CreateScreenFrustrum(&frustrum);
 		ARX_PORTALS_Frustrum_ComputeRoom(room_num, &frustrum);
 
-		for(size_t i = 0; i < RoomDrawList.size(); i++) {
-			ARX_PORTALS_Frustrum_RenderRoomTCullSoft(RoomDrawList[i], &RoomDraw[RoomDrawList[i]].frustrum, tim);
+		{
+			ARX_PROFILE("Room tile lights");
+			for(size_t i = 0; i < RoomDrawList.size(); i++) {
+				if(ARX_PORTALS_HasRoomGeometry(RoomDrawList[i])) {
+					ARX_PORTALS_ComputeRoomTileLights(RoomDrawList[i]);
+				}
+			}
+		}
+		
+		// Culling and index generation only touch per-room data
+		if(vRoomCullResults.size() < RoomDrawList.size()) {
+			vRoomCullResults.resize(RoomDrawList.size());
+		}
+		{
+			ARX_PROFILE("Room culling");
+			ThreadPool::run(ARX_PORTALS_CullRoomJob, NULL, RoomDrawList.size());
+		}
+		
+		{
+			ARX_PROFILE("Room lighting");
+			for(size_t i = 0; i < RoomDrawList.size(); i++) {
+				ARX_PORTALS_Frustrum_RenderRoomTCullSoft(i, tim);
+			}
 		}
 	}
 }
@@ -1853,6 +1890,7 @@ extern long SPECIAL_DRAGINTER_RENDER;
 //*************************************************************************************
 ///////////////////////////////////////////////////////////
 void ARX_SCENE_Render() {
+	ARX_PROFILE_FUNC();
 
 	GRenderer->SetBlendFunc(Renderer::BlendZero, Renderer::BlendInvSrcColor);
 	for(size_t i = 0; i < RoomDrawList.size(); i++) {
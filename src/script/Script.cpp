@@ -51,8 +51,11 @@ ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
 #include <sstream>
 #include <cstdio>
 #include <algorithm>
+#include <deque>
+#include <vector>
 
 #include <boost/algorithm/string/predicate.hpp>
+#include <boost/unordered_map.hpp>
 
 #include "ai/Paths.h"
 
@@ -77,10 +80,14 @@ ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
 #include "io/resource/PakReader.h"
 #include "io/log/Logger.h"
 
+#include "platform/MPSCQueue.h"
+#include "platform/Profiler.h"
+
 #include "scene/Scene.h"
 #include "scene/Interactive.h"
 
 #include "script/ScriptEvent.h"
+#include "script/TimerQueue.h"
 
 using std::sprintf;
 using std::min;
@@ -1499,90 +1506,131 @@ void MakeSSEPARAMS(const char * params)
 	}
 }
 
-#define MAX_EVENT_STACK 800
+namespace {
+
 struct STACKED_EVENT {
 	Entity * sender;
-	long              exist;
+	bool              exist;
 	Entity * io;
 	ScriptMessage     msg;
 	std::string       params;
 	std::string       eventname;
 };
 
-STACKED_EVENT eventstack[MAX_EVENT_STACK];
+/*!
+ * Events posted using Stack_SendIOScriptEvent() that have not yet been moved to g_eventStack.
+ * 
+ * This can be written to from any thread - only the main thread consumes it.
+ */
+platform::UnboundedMPSCQueue<STACKED_EVENT, 1024> g_postedEvents;
+
+//! Events waiting to be executed, in order - only used from the main thread
+std::deque<STACKED_EVENT> g_eventStack;
+//! Number of events in g_eventStack for each target entity
+boost::unordered_map<Entity *, size_t> g_eventStackCounts;
+size_t g_eventStackHighWaterMark = 0;
+
+void ARX_SCRIPT_EventStackAdd(const STACKED_EVENT & event) {
+	
+	g_eventStack.push_back(event);
+	g_eventStackCounts[event.io]++;
+	
+	g_eventStackHighWaterMark = std::max(g_eventStackHighWaterMark, g_eventStack.size());
+}
+
+struct AddPostedEvent {
+	void operator()(const STACKED_EVENT & event) const {
+		ARX_SCRIPT_EventStackAdd(event);
+	}
+};
+
+//! Move posted events to g_eventStack - must be called from the main thread
+void ARX_SCRIPT_EventStackCollect() {
+	
+	g_postedEvents.consume(AddPostedEvent());
+}
+
+} // anonymous namespace
 
 void ARX_SCRIPT_EventStackInit()
 {
-	ARX_SCRIPT_EventStackClear( false ); // Clear everything in the stack
+	ARX_SCRIPT_EventStackClear(); // Clear everything in the stack
 }
-void ARX_SCRIPT_EventStackClear( bool check_exist )
+void ARX_SCRIPT_EventStackClear()
 {
 	LogDebug("Event Stack Clear");
-	for (long i = 0; i < MAX_EVENT_STACK; i++)
-	{
-		if ( check_exist ) // If we're not blatantly clearing everything
-			if ( !eventstack[i].exist ) // If the Stacked_Event is not being used
-				continue; // Continue on to the next one
-
-			// Otherwise, clear all the fields in this stacked_event
-			eventstack[i].sender = NULL;
-			eventstack[i].exist = 0;
-			eventstack[i].io = NULL;
-			eventstack[i].msg = SM_NULL;
-			eventstack[i].params.clear();
-			eventstack[i].eventname.clear();
-	}
+	
+	g_postedEvents.clear();
+	
+	g_eventStack.clear();
+	g_eventStackCounts.clear();
 }
 
 long STACK_FLOW = 8;
 
 void ARX_SCRIPT_EventStackClearForIo(Entity * io)
 {
-	for (long i = 0; i < MAX_EVENT_STACK; i++)
-	{
-		if (eventstack[i].exist)
-		{
-			if (eventstack[i].io == io)
-			{
-				eventstack[i].sender = NULL;
-				eventstack[i].exist = 0;
-				eventstack[i].io = NULL;
-				eventstack[i].msg = SM_NULL;
-				eventstack[i].params.clear();
-				eventstack[i].eventname.clear();
-			}
+	ARX_SCRIPT_EventStackCollect();
+	
+	boost::unordered_map<Entity *, size_t>::iterator count = g_eventStackCounts.find(io);
+	if(count == g_eventStackCounts.end()) {
+		// No events for this entity - nothing to do
+		return;
+	}
+	
+	g_eventStackCounts.erase(count);
+	
+	for(std::deque<STACKED_EVENT>::iterator i = g_eventStack.begin(); i != g_eventStack.end(); ++i) {
+		if(i->exist && i->io == io) {
+			i->sender = NULL;
+			i->exist = false;
+			i->io = NULL;
+			i->msg = SM_NULL;
+			i->params.clear();
+			i->eventname.clear();
 		}
 	}
 }
 
 void ARX_SCRIPT_EventStackExecute()
 {
+	ARX_PROFILE_FUNC();
+	
+	ARX_SCRIPT_EventStackCollect();
+	
+	// Events sent by the executed scripts are only collected in the next call
+	size_t pending = g_eventStack.size();
+	
 	long count = 0;
-
-	for (long i = 0; i < MAX_EVENT_STACK; i++)
-	{
-		if (eventstack[i].exist)
-		{
-			if(ValidIOAddress(eventstack[i].io)) {
-
-			if (ValidIOAddress(eventstack[i].sender))
-				EVENT_SENDER = eventstack[i].sender;
+	
+	for(; pending != 0 && !g_eventStack.empty(); pending--) {
+		
+		STACKED_EVENT event = g_eventStack.front();
+		g_eventStack.pop_front();
+		
+		if(!event.exist) {
+			// Cleared by ARX_SCRIPT_EventStackClearForIo()
+			continue;
+		}
+		
+		boost::unordered_map<Entity *, size_t>::iterator ioCount = g_eventStackCounts.find(event.io);
+		if(ioCount != g_eventStackCounts.end() && --ioCount->second == 0) {
+			g_eventStackCounts.erase(ioCount);
+		}
+		
+		if(ValidIOAddress(event.io)) {
+			
+			if (ValidIOAddress(event.sender))
+				EVENT_SENDER = event.sender;
 			else
 				EVENT_SENDER = NULL;
-
-			SendIOScriptEvent(eventstack[i].io, eventstack[i].msg, eventstack[i].params, eventstack[i].eventname);
-			}
-
-			eventstack[i].sender = NULL;
-			eventstack[i].exist = 0;
-			eventstack[i].io = NULL;
-			eventstack[i].msg = SM_NULL;
-			eventstack[i].params.clear();
-			eventstack[i].eventname.clear();
-			count++;
-
-			if (count >= STACK_FLOW) return;
+			
+			SendIOScriptEvent(event.io, event.msg, event.params, event.eventname);
 		}
+		
+		count++;
+		
+		if (count >= STACK_FLOW) return;
 	}
 }
 
@@ -1593,22 +1641,25 @@ void ARX_SCRIPT_EventStackExecuteAll()
 	STACK_FLOW = 20;
 }
 
+size_t ARX_SCRIPT_EventStackSize() {
+	return g_eventStack.size();
+}
+
+size_t ARX_SCRIPT_EventStackHighWaterMark() {
+	return std::max(g_eventStackHighWaterMark, size_t(g_postedEvents.highWaterMark()));
+}
+
 void Stack_SendIOScriptEvent(Entity * io, ScriptMessage msg, const std::string& params, const std::string& eventname)
 {
-	for (long i = 0; i < MAX_EVENT_STACK; i++)
-	{
-		if (!eventstack[i].exist)
-		{
-			eventstack[i].sender = EVENT_SENDER;
-			eventstack[i].io = io;
-			eventstack[i].msg = msg;
-			eventstack[i].exist = 1;
-			eventstack[i].params = params;
-			eventstack[i].eventname = eventname;
-
-			return;
-		}
-	}
+	STACKED_EVENT event;
+	event.sender = EVENT_SENDER;
+	event.exist = true;
+	event.io = io;
+	event.msg = msg;
+	event.params = params;
+	event.eventname = eventname;
+	
+	g_postedEvents.push(event);
 }
 
 ScriptResult SendIOScriptEventReverse(Entity * io, ScriptMessage msg, const std::string& params, const std::string& eventname)
@@ -1718,18 +1769,43 @@ ScriptResult SendInitScriptEvent(Entity * io) {
 	return ACCEPT;
 }
 
-//! Checks if timer named texx exists.
-static bool ARX_SCRIPT_Timer_Exist(const std::string & texx) {
+namespace {
+
+typedef boost::unordered_map<Entity *, std::vector<long> > TimersByEntity;
+typedef boost::unordered_map<std::string, long> TimerNames;
+
+//! Pending fire times of all active timers
+TimerQueue g_timerQueue;
+//! Active timer slots for each entity
+TimersByEntity g_timersByEntity;
+//! Number of active timers with each name
+TimerNames g_timerNames;
+//! All slots below this index are in use
+long g_timerFirstFree = 0;
+
+void ARX_SCRIPT_Timer_Schedule(long num) {
+	
+	const SCR_TIMER & st = scr_timer[num];
+	g_timerQueue.schedule(num, st.tim + st.msecs);
+}
+
+//! Rebuild the timer queue from scratch, dropping all stale entries
+void ARX_SCRIPT_Timer_RebuildQueue() {
+	
+	g_timerQueue.clear();
 	
 	for(long i = 0; i < MAX_TIMER_SCRIPT; i++) {
 		if(scr_timer[i].exist) {
-			if(scr_timer[i].name == texx) {
-				return true;
-			}
+			ARX_SCRIPT_Timer_Schedule(i);
 		}
 	}
-	
-	return false;
+}
+
+} // anonymous namespace
+
+//! Checks if timer named texx exists.
+static bool ARX_SCRIPT_Timer_Exist(const std::string & texx) {
+	return g_timerNames.find(texx) != g_timerNames.end();
 }
 
 string ARX_SCRIPT_Timer_GetDefaultName() {
@@ -1750,14 +1826,47 @@ string ARX_SCRIPT_Timer_GetDefaultName() {
 //*************************************************************************************
 long ARX_SCRIPT_Timer_GetFree() {
 	
-	for(long i = 0; i < MAX_TIMER_SCRIPT; i++) {
-		if(!(scr_timer[i].exist))
+	for(long i = g_timerFirstFree; i < MAX_TIMER_SCRIPT; i++) {
+		if(!(scr_timer[i].exist)) {
+			g_timerFirstFree = i;
 			return i;
+		}
 	}
 	
+	g_timerFirstFree = MAX_TIMER_SCRIPT;
+	
 	return -1;
 }
 
+void ARX_SCRIPT_Timer_Register(long num) {
+	
+	arx_assert(num >= 0 && num < MAX_TIMER_SCRIPT);
+	
+	SCR_TIMER & st = scr_timer[num];
+	arx_assert(!st.exist);
+	
+	st.exist = 1;
+	ActiveTimers++;
+	g_timerQueue.invalidate(num);
+	
+	g_timersByEntity[st.io].push_back(num);
+	g_timerNames[st.name]++;
+	
+	ARX_SCRIPT_Timer_Schedule(num);
+	g_timerQueue.compact(ActiveTimers);
+}
+
+void ARX_SCRIPT_Timer_Restart(unsigned long tim) {
+	
+	for(long i = 0; i < MAX_TIMER_SCRIPT; i++) {
+		if(scr_timer[i].exist) {
+			scr_timer[i].tim = tim;
+		}
+	}
+	
+	ARX_SCRIPT_Timer_RebuildQueue();
+}
+
 //*************************************************************************************
 // Count the number of active script timers...
 //*************************************************************************************
@@ -1770,42 +1879,74 @@ long ARX_SCRIPT_CountTimers() {
 // Clears a timer by its Index (long timer_idx) on the timers list
 //*************************************************************************************
 void ARX_SCRIPT_Timer_ClearByNum(long timer_idx) {
-	if(scr_timer[timer_idx].exist) {
-		scr_timer[timer_idx].name.clear();
-		ActiveTimers--;
-		scr_timer[timer_idx].exist = 0;
+	
+	SCR_TIMER & st = scr_timer[timer_idx];
+	if(!st.exist) {
+		return;
 	}
+	
+	TimersByEntity::iterator timers = g_timersByEntity.find(st.io);
+	arx_assert(timers != g_timersByEntity.end());
+	std::vector<long> & list = timers->second;
+	std::vector<long>::iterator it = std::find(list.begin(), list.end(), timer_idx);
+	arx_assert(it != list.end());
+	*it = list.back();
+	list.pop_back();
+	if(list.empty()) {
+		g_timersByEntity.erase(timers);
+	}
+	
+	TimerNames::iterator name = g_timerNames.find(st.name);
+	arx_assert(name != g_timerNames.end());
+	if(--name->second == 0) {
+		g_timerNames.erase(name);
+	}
+	
+	st.name.clear();
+	ActiveTimers--;
+	st.exist = 0;
+	g_timerQueue.invalidate(timer_idx);
+	g_timerFirstFree = std::min(g_timerFirstFree, timer_idx);
+}
+
+//! Get a copy of the timer slots used by an entity, as clearing them modifies the list
+static std::vector<long> ARX_SCRIPT_Timer_GetForIO(Entity * io) {
+	TimersByEntity::const_iterator timers = g_timersByEntity.find(io);
+	if(timers == g_timersByEntity.end()) {
+		return std::vector<long>();
+	}
+	return timers->second;
 }
 
 void ARX_SCRIPT_Timer_Clear_By_Name_And_IO(const string & timername, Entity * io) {
-	for(long i = 0; i < MAX_TIMER_SCRIPT; i++) {
-		if(scr_timer[i].exist && scr_timer[i].io == io && scr_timer[i].name == timername) {
-			ARX_SCRIPT_Timer_ClearByNum(i);
+	
+	if(g_timerNames.find(timername) == g_timerNames.end()) {
+		return;
+	}
+	
+	std::vector<long> timers = ARX_SCRIPT_Timer_GetForIO(io);
+	for(size_t i = 0; i < timers.size(); i++) {
+		if(scr_timer[timers[i]].name == timername) {
+			ARX_SCRIPT_Timer_ClearByNum(timers[i]);
 		}
 	}
 }
 
 void ARX_SCRIPT_Timer_Clear_All_Locals_For_IO(Entity * io)
 {
-	for (long i = 0; i < MAX_TIMER_SCRIPT; i++)
-	{
-		if (scr_timer[i].exist)
-		{
-			if ((scr_timer[i].io == io) && (scr_timer[i].es == &io->over_script))
-				ARX_SCRIPT_Timer_ClearByNum(i);
+	std::vector<long> timers = ARX_SCRIPT_Timer_GetForIO(io);
+	for(size_t i = 0; i < timers.size(); i++) {
+		if(scr_timer[timers[i]].es == &io->over_script) {
+			ARX_SCRIPT_Timer_ClearByNum(timers[i]);
 		}
 	}
 }
 
 void ARX_SCRIPT_Timer_Clear_By_IO(Entity * io)
 {
-	for (long i = 0; i < MAX_TIMER_SCRIPT; i++)
-	{
-		if (scr_timer[i].exist)
-		{
-			if (scr_timer[i].io == io)
-				ARX_SCRIPT_Timer_ClearByNum(i);
-		}
+	std::vector<long> timers = ARX_SCRIPT_Timer_GetForIO(io);
+	for(size_t i = 0; i < timers.size(); i++) {
+		ARX_SCRIPT_Timer_ClearByNum(timers[i]);
 	}
 }
 
@@ -1822,6 +1963,11 @@ void ARX_SCRIPT_Timer_FirstInit(long number)
 	delete[] scr_timer;
 	scr_timer = new SCR_TIMER[MAX_TIMER_SCRIPT];
 	ActiveTimers = 0;
+	
+	g_timerQueue.reset(MAX_TIMER_SCRIPT);
+	g_timersByEntity.clear();
+	g_timerNames.clear();
+	g_timerFirstFree = 0;
 }
 
 void ARX_SCRIPT_Timer_ClearAll()
@@ -1831,25 +1977,28 @@ void ARX_SCRIPT_Timer_ClearAll()
 			ARX_SCRIPT_Timer_ClearByNum(i);
 
 	ActiveTimers = 0;
+	
+	g_timerQueue.clear();
+	g_timersByEntity.clear();
+	g_timerNames.clear();
+	g_timerFirstFree = 0;
 }
 
 void ARX_SCRIPT_Timer_Clear_For_IO(Entity * io)
 {
-	for (long i = 0; i < MAX_TIMER_SCRIPT; i++)
-	{
-		if (scr_timer[i].exist)
-		{
-			if (scr_timer[i].io == io) ARX_SCRIPT_Timer_ClearByNum(i);
-		}
-	}
+	ARX_SCRIPT_Timer_Clear_By_IO(io);
 }
 
 long ARX_SCRIPT_GetSystemIOScript(Entity * io, const std::string & name) {
 	
 	if(ActiveTimers) {
-		for(long i = 0; i < MAX_TIMER_SCRIPT; i++) {
-			if(scr_timer[i].exist && scr_timer[i].io == io && scr_timer[i].name == name) {
-				return i;
+		TimersByEntity::const_iterator timers = g_timersByEntity.find(io);
+		if(timers != g_timersByEntity.end()) {
+			const std::vector<long> & list = timers->second;
+			for(size_t i = 0; i < list.size(); i++) {
+				if(scr_timer[list[i]].name == name) {
+					return list[i];
+				}
 			}
 		}
 	}
@@ -1903,22 +2052,28 @@ long Manage_Specific_RAT_Timer(SCR_TIMER * st)
 }
 
 void ARX_SCRIPT_Timer_Check() {
+	ARX_PROFILE_FUNC();
 	
 	if(!ActiveTimers) {
 		return;
 	}
 	
-	for(long i = 0; i < MAX_TIMER_SCRIPT; i++) {
+	unsigned long now = static_cast<unsigned long>(arxtime);
+	
+	// Timers that are rescheduled or started while we are running are only added to the
+	// queue once we are done so that each timer fires at most once per frame.
+	g_timerQueue.beginDeferred();
+	
+	long i;
+	while(g_timerQueue.pop(now, i)) {
 		
 		SCR_TIMER * st = &scr_timer[i];
-		if(!st->exist) {
-			continue;
-		}
+		arx_assert(st->exist);
 		
-		unsigned long now = static_cast<unsigned long>(arxtime);
 		unsigned long fire_time = st->tim + st->msecs;
 		if(fire_time > now) {
-			// Timer not ready to fire yet
+			// Timer was pushed back since it was scheduled
+			ARX_SCRIPT_Timer_Schedule(i);
 			continue;
 		}
 		
@@ -1928,6 +2083,7 @@ void ARX_SCRIPT_Timer_Check() {
 			st->tim += st->msecs * increment;
 			arx_assert_msg(st->tim <= now && st->tim + st->msecs > now,
 			               "start=%lu wait=%ld now=%lu", st->tim, st->msecs, now);
+			ARX_SCRIPT_Timer_Schedule(i);
 			continue;
 		}
 		
@@ -1937,6 +2093,7 @@ void ARX_SCRIPT_Timer_Check() {
 		
 		if(!es && st->name == "_r_a_t_") {
 			if(Manage_Specific_RAT_Timer(st)) {
+				ARX_SCRIPT_Timer_Schedule(i);
 				continue;
 			}
 		}
@@ -1948,6 +2105,7 @@ void ARX_SCRIPT_Timer_Check() {
 				st->times--;
 			}
 			st->tim += st->msecs;
+			ARX_SCRIPT_Timer_Schedule(i);
 		}
 		
 		if(es && ValidIOAddress(io)) {
@@ -1955,6 +2113,10 @@ void ARX_SCRIPT_Timer_Check() {
 		}
 		
 	}
+	
+	g_timerQueue.endDeferred();
+	
+	g_timerQueue.compact(ActiveTimers);
 }
 
 void ARX_SCRIPT_Init_Event_Stats() {
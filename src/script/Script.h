@@ -419,12 +419,22 @@ void ARX_SCRIPT_Timer_ClearAll();
 void ARX_SCRIPT_Timer_Clear_For_IO(Entity * io);
 void ARX_SCRIPT_Timer_Clear_By_IO(Entity * io);
 long ARX_SCRIPT_Timer_GetFree();
+
+/*!
+ * Activate a timer slot returned by ARX_SCRIPT_Timer_GetFree().
+ * All fields of the slot must have been filled in before calling this,
+ * and name, io, tim and msecs must not be changed directly afterwards.
+ */
+void ARX_SCRIPT_Timer_Register(long num);
+
+//! Set the start time of all active timers
+void ARX_SCRIPT_Timer_Restart(unsigned long tim);
  
 void ARX_SCRIPT_SetMainEvent(Entity * io, const std::string & newevent);
 void ARX_SCRIPT_EventStackExecute();
 void ARX_SCRIPT_EventStackExecuteAll();
 void ARX_SCRIPT_EventStackInit();
-void ARX_SCRIPT_EventStackClear(bool check_exist = true);
+void ARX_SCRIPT_EventStackClear();
 void ARX_SCRIPT_ResetObject(Entity * io, long flags);
 void ARX_SCRIPT_Reset(Entity * io, long flags);
 long ARX_SCRIPT_GetSystemIOScript(Entity * io, const std::string & name);
@@ -434,6 +444,10 @@ long ARX_SCRIPT_CountTimers();
 void ARX_SCRIPT_Timer_ClearByNum(long num);
 void ARX_SCRIPT_ResetAll(long flags);
 void ARX_SCRIPT_EventStackClearForIo(Entity * io);
+//! Number of events waiting in the script event stack
+size_t ARX_SCRIPT_EventStackSize();
+//! Maximum number of events that were waiting in the script event stack at any one time
+size_t ARX_SCRIPT_EventStackHighWaterMark();
 Entity * ARX_SCRIPT_Get_IO_Max_Events();
 Entity * ARX_SCRIPT_Get_IO_Max_Events_Sent();
 
@@ -468,6 +482,12 @@ ScriptResult SendIOScriptEvent(Entity * io, ScriptMessage msg, const std::string
 
 ScriptResult SendMsgToAllIO(ScriptMessage msg, const std::string & params = "");
 
+/*!
+ * Queue an event to be sent by ARX_SCRIPT_EventStackExecute().
+ * 
+ * This may be called from any thread. The sender is taken from EVENT_SENDER,
+ * which is only meaningful when called from the main thread.
+ */
 void Stack_SendIOScriptEvent(Entity * io, ScriptMessage msg, const std::string & params = "", const std::string & eventname = "");
 
 /*!
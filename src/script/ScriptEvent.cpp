@@ -51,6 +51,8 @@ ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
 
 #include "io/log/Logger.h"
 
+#include "platform/Profiler.h"
+
 #include "script/ScriptUtils.h"
 #include "script/ScriptedAnimation.h"
 #include "script/ScriptedCamera.h"
@@ -259,6 +261,8 @@ static const char * toString(ScriptResult ret) {
 ScriptResult ScriptEvent::send(EERIE_SCRIPT * es, ScriptMessage msg, const std::string & params,
                                Entity * io, const std::string & evname, long info) {
 	
+	ARX_PROFILE_FUNC();
+	
 	ScriptResult ret = ACCEPT;
 	string eventname;
 	long pos;
@@ -379,8 +383,11 @@ ScriptResult ScriptEvent::send(EERIE_SCRIPT * es, ScriptMessage msg, const std::
 	
 	script::Context context(es, pos, io, msg);
 	
+	// Re-used for all commands in this event to avoid allocating a new string for each one
+	string word;
+	
 	if(msg != SM_EXECUTELINE) {
-		string word = context.getCommand();
+		context.getCommand(word);
 		if(word != "{") {
 			ScriptEventWarning << "--> missing bracket after event, got \"" << word << "\"";
 			return ACCEPT;
@@ -391,7 +398,7 @@ ScriptResult ScriptEvent::send(EERIE_SCRIPT * es, ScriptMessage msg, const std::
 	
 	for(;;) {
 		
-		string word = context.getCommand(msg != SM_EXECUTELINE);
+		context.getCommand(word, msg != SM_EXECUTELINE);
 		if(word.empty()) {
 			if(msg == SM_EXECUTELINE && context.pos != es->size) {
 				arx_assert(es->data[context.pos] == '\n');
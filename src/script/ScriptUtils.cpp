@@ -51,13 +51,19 @@ string Context::getStringVar(const string & var) const {
 
 #define ScriptParserWarning Logger(__FILE__,__LINE__, isSuppressed(*this, "?") ? Logger::Debug : Logger::Warning) << ScriptContextPrefix(*this) << ": "
 
-std::string Context::getCommand(bool skipNewlines) {
+string Context::getCommand(bool skipNewlines) {
+	string word;
+	getCommand(word, skipNewlines);
+	return word;
+}
+
+void Context::getCommand(string & word, bool skipNewlines) {
 	
 	const char * esdat = script->data;
 	
 	skipWhitespace(skipNewlines);
 	
-	string word;
+	word.clear();
 	
 	// now take chars until it finds a space or unused char
 	for(; pos != script->size && !isWhitespace(esdat[pos]); pos++) {
@@ -79,23 +85,28 @@ std::string Context::getCommand(bool skipNewlines) {
 			word.push_back(c);
 		}
 	}
-	
-	return word;
 }
 
 string Context::getWord() {
+	string word;
+	getWord(word);
+	return word;
+}
+
+void Context::getWord(string & word) {
 	
 	skipWhitespace();
 	
+	word.clear();
+	
 	if(pos >= script->size) {
-		return string();
+		return;
 	}
 	
 	const char * esdat = script->data;
 	
 	bool tilde = false; // number of tildes
 	
-	string word;
 	string var;
 	
 	if(pos != script->size && esdat[pos] == '"') {
@@ -105,7 +116,7 @@ string Context::getWord() {
 				if(tilde) {
 					ScriptParserWarning << "unmatched '\"' before end of line";
 				}
-				return word;
+				return;
 			} else if(esdat[pos] == '~') {
 				if(tilde) {
 					word += GetVarValueInterpretedAsText(var, getMaster(), getEntity());
@@ -154,8 +165,6 @@ string Context::getWord() {
 	if(tilde) {
 		ScriptParserWarning << "unmatched '~'";
 	}
-	
-	return word;
 }
 
 void Context::skipWord() {
@@ -207,25 +216,32 @@ void Context::skipWhitespace(bool skipNewlines) {
 }
 
 string Context::getFlags() {
+	string flags;
+	getFlags(flags);
+	return flags;
+}
+
+void Context::getFlags(string & flags) {
 	
 	skipWhitespace();
 	
 	if(pos < script->size && script->data[pos] == '-') {
-		return getWord();
+		getWord(flags);
+	} else {
+		flags.clear();
 	}
-	
-	return string();
 }
 
 float Context::getFloat() {
-	return getFloatVar(getWord());
+	getWord(scratch);
+	return getFloatVar(scratch);
 }
 
 bool Context::getBool() {
 	
-	string word = getWord();
+	getWord(scratch);
 	
-	return (word == "on" || word == "yes");
+	return (scratch == "on" || scratch == "yes");
 }
 
 float Context::getFloatVar(const std::string & name) const {
@@ -282,7 +298,8 @@ bool Context::returnToCaller() {
 
 void Context::skipStatement() {
 	
-	string word = getCommand();
+	string & word = scratch;
+	getCommand(word);
 	if(pos == script->size) {
 		ScriptParserWarning << "missing statement before end of script";
 		return;
@@ -295,7 +312,7 @@ void Context::skipStatement() {
 			if(script->data[pos] == '\n') {
 				pos++;
 			}
-			word = getWord(); // TODO should not evaluate ~var~
+			getWord(word); // TODO should not evaluate ~var~
 			if(pos == script->size) {
 				ScriptParserWarning << "missing '}' before end of script";
 				return;
@@ -313,7 +330,7 @@ void Context::skipStatement() {
 	
 	skipWhitespace(true);
 	size_t oldpos = pos;
-	word = getCommand();
+	getCommand(word);
 	if(word != "else") {
 		pos = oldpos;
 	}
@@ -89,6 +89,7 @@ private:
 	Entity * entity;
 	ScriptMessage message;
 	std::vector<size_t> stack;
+	std::string scratch; //!< Reused buffer for tokens that are not returned to the caller
 	
 public:
 	
@@ -102,6 +103,16 @@ public:
 	
 	std::string getCommand(bool skipNewlines = true);
 	
+	/*!
+	 * Variants of getFlags(), getWord() and getCommand() that store the token in an
+	 * existing buffer instead of returning a new string.
+	 * The buffer is cleared first, but its capacity is kept so that re-using the same
+	 * buffer for multiple tokens avoids repeated allocations.
+	 */
+	void getFlags(std::string & flags);
+	void getWord(std::string & word);
+	void getCommand(std::string & word, bool skipNewlines = true);
+	
 	void skipWhitespace(bool skipNewlines = false);
 	
 	inline Entity * getEntity() const { return entity; }
@@ -559,6 +559,10 @@ class IfCommand : public Command {
 	typedef std::map<string, Operator *> Operators;
 	Operators operators;
 	
+	// Token and value buffers re-used between calls - if never runs other scripts
+	string left, op, right;
+	string s1, s2;
+	
 	void addOperator(Operator * op) {
 		
 		typedef std::pair<Operators::iterator, bool> Res;
@@ -773,11 +777,11 @@ public:
 	
 	Result execute(Context & context) {
 		
-		string left = context.getWord();
+		context.getWord(left);
 		
-		string op = context.getWord();
+		context.getWord(op);
 		
-		string right = context.getWord();
+		context.getWord(right);
 		
 		Operators::const_iterator it = operators.find(op);
 		if(it == operators.end()) {
@@ -786,7 +790,6 @@ public:
 		}
 		
 		float f1, f2;
-		string s1, s2;
 		ValueType t1 = getVar(context, left, s1, f1, it->second->getType());
 		ValueType t2 = getVar(context, right, s2, f2, t1);
 		
@@ -881,9 +884,7 @@ void timerCommand(const string & timer, Context & context) {
 		return;
 	}
 	
-	ActiveTimers++;
 	scr_timer[num].es = context.getScript();
-	scr_timer[num].exist = 1;
 	scr_timer[num].io = io;
 	scr_timer[num].msecs = millisecons;
 	scr_timer[num].name = timername;
@@ -893,6 +894,7 @@ void timerCommand(const string & timer, Context & context) {
 	
 	scr_timer[num].flags = (idle && io) ? 1 : 0;
 	
+	ARX_SCRIPT_Timer_Register(num);
 }
 
 void setupScriptedLang() {
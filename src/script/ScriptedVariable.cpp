@@ -59,6 +59,10 @@ namespace {
 
 class SetCommand : public Command {
 	
+	// Token buffers re-used between calls - set never runs other scripts
+	string var;
+	string val;
+	
 public:
 	
 	SetCommand() : Command("set") { }
@@ -71,8 +75,8 @@ public:
 			}
 		}
 		
-		string var = context.getWord();
-		string val = context.getWord();
+		context.getWord(var);
+		context.getWord(val);
 		
 		DebugScript(' ' << var << " \"" << val << '"');
 		
@@ -189,13 +193,15 @@ private:
 	
 	Operator op;
 	
+	string var; //!< Re-used between calls
+	
 public:
 	
 	ArithmeticCommand(const string & name, Operator _op) : Command(name), op(_op) { }
 	
 	Result execute(Context & context) {
 		
-		string var = context.getWord();
+		context.getWord(var);
 		float val = context.getFloat();
 		
 		DebugScript(' ' << var << ' ' << val);
@@ -341,13 +347,15 @@ class IncrementCommand : public Command {
 	
 	float diff;
 	
+	string var; //!< Re-used between calls
+	
 public:
 	
 	IncrementCommand(const string & name, float _diff) : Command(name), diff(_diff) { }
 	
 	Result execute(Context & context) {
 		
-		string var = context.getWord();
+		context.getWord(var);
 		
 		DebugScript(' ' << var);
 		
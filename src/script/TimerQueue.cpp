@@ -0,0 +1,108 @@
+/*
+ * Copyright 2013 Arx Libertatis Team (see the AUTHORS file)
+ *
+ * This file is part of Arx Libertatis.
+ *
+ * Arx Libertatis is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Arx Libertatis is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Arx Libertatis.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "script/TimerQueue.h"
+
+#include <algorithm>
+
+#include "platform/Platform.h"
+
+void TimerQueue::reset(size_t slots) {
+	clear();
+	m_generation.assign(slots, 0);
+}
+
+void TimerQueue::clear() {
+	m_queue.clear();
+	m_deferred.clear();
+}
+
+void TimerQueue::invalidate(long index) {
+	arx_assert(index >= 0 && size_t(index) < m_generation.size());
+	m_generation[index]++;
+}
+
+void TimerQueue::schedule(long index, unsigned long time) {
+	
+	arx_assert(index >= 0 && size_t(index) < m_generation.size());
+	
+	Entry entry(time, index, m_generation[index]);
+	
+	if(m_deferring) {
+		m_deferred.push_back(entry);
+		return;
+	}
+	
+	m_queue.push_back(entry);
+	std::push_heap(m_queue.begin(), m_queue.end());
+}
+
+bool TimerQueue::pop(unsigned long now, long & index) {
+	
+	while(!m_queue.empty() && m_queue.front().time <= now) {
+		
+		std::pop_heap(m_queue.begin(), m_queue.end());
+		Entry entry = m_queue.back();
+		m_queue.pop_back();
+		
+		if(isStale(entry)) {
+			// Slot was cleared or re-used since it was scheduled
+			continue;
+		}
+		
+		index = entry.index;
+		return true;
+	}
+	
+	return false;
+}
+
+void TimerQueue::beginDeferred() {
+	arx_assert(!m_deferring);
+	m_deferring = true;
+}
+
+void TimerQueue::endDeferred() {
+	
+	arx_assert(m_deferring);
+	m_deferring = false;
+	
+	for(size_t i = 0; i < m_deferred.size(); i++) {
+		m_queue.push_back(m_deferred[i]);
+		std::push_heap(m_queue.begin(), m_queue.end());
+	}
+	m_deferred.clear();
+}
+
+void TimerQueue::compact(size_t active) {
+	
+	if(m_queue.size() <= std::max(active, size_t(64)) * 2) {
+		return;
+	}
+	
+	size_t count = 0;
+	for(size_t i = 0; i < m_queue.size(); i++) {
+		if(!isStale(m_queue[i])) {
+			m_queue[count++] = m_queue[i];
+		}
+	}
+	m_queue.erase(m_queue.begin() + count, m_queue.end());
+	
+	std::make_heap(m_queue.begin(), m_queue.end());
+}
@@ -0,0 +1,105 @@
+/*
+ * Copyright 2013 Arx Libertatis Team (see the AUTHORS file)
+ *
+ * This file is part of Arx Libertatis.
+ *
+ * Arx Libertatis is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Arx Libertatis is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Arx Libertatis.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ARX_SCRIPT_TIMERQUEUE_H
+#define ARX_SCRIPT_TIMERQUEUE_H
+
+#include <stddef.h>
+#include <vector>
+
+/*!
+ * Pending fire times of the active script timers, identified by their slot index.
+ * 
+ * Entries are never removed when a timer is cleared or rescheduled - instead stale
+ * entries are detected using a per-slot generation and skipped when they come up.
+ */
+class TimerQueue {
+	
+	struct Entry {
+		
+		unsigned long time;
+		long index;
+		unsigned generation;
+		
+		Entry(unsigned long _time, long _index, unsigned _generation)
+			: time(_time), index(_index), generation(_generation) { }
+		
+		bool operator<(const Entry & o) const {
+			// Reversed so that std::push_heap / std::pop_heap give us a min-heap
+			if(time != o.time) {
+				return time > o.time;
+			}
+			return index > o.index;
+		}
+		
+	};
+	
+	std::vector<Entry> m_queue;
+	//! Entries scheduled between beginDeferred() and endDeferred()
+	std::vector<Entry> m_deferred;
+	bool m_deferring;
+	//! Incremented every time a slot is invalidated so that old entries can be detected
+	std::vector<unsigned> m_generation;
+	
+	bool isStale(const Entry & entry) const {
+		return m_generation[entry.index] != entry.generation;
+	}
+	
+public:
+	
+	TimerQueue() : m_deferring(false) { }
+	
+	//! Remove all entries and set the number of timer slots
+	void reset(size_t slots);
+	
+	//! Remove all entries
+	void clear();
+	
+	/*!
+	 * Drop all queued entries for a slot.
+	 * Must be called whenever a slot is (re-)used or freed.
+	 */
+	void invalidate(long index);
+	
+	//! Queue a slot to fire at the given time
+	void schedule(long index, unsigned long time);
+	
+	/*!
+	 * Remove the earliest slot that is due to fire at or before now.
+	 * 
+	 * \return false if no slot is due.
+	 */
+	bool pop(unsigned long now, long & index);
+	
+	/*!
+	 * Hold back newly scheduled entries until endDeferred() is called, so that pop()
+	 * does not return a slot again that was re-scheduled after it was popped.
+	 */
+	void beginDeferred();
+	void endDeferred();
+	
+	//! Drop stale entries once they start to outnumber the given number of active timers
+	void compact(size_t active);
+	
+	//! Number of queued entries, including stale ones
+	size_t size() const { return m_queue.size() + m_deferred.size(); }
+	
+};
+
+#endif // ARX_SCRIPT_TIMERQUEUE_H
@@ -0,0 +1,139 @@
+/*
+ * Copyright 2013 Arx Libertatis Team (see the AUTHORS file)
+ *
+ * This file is part of Arx Libertatis.
+ *
+ * Arx Libertatis is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Arx Libertatis is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Arx Libertatis.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "window/NullWindow.h"
+
+#include <algorithm>
+
+#include "core/Config.h"
+#include "graphics/null/NullRenderer.h"
+#include "io/fs/FilePath.h"
+#include "io/log/Logger.h"
+
+NullWindow::NullWindow() { }
+
+NullWindow::~NullWindow() {
+	
+	if(renderer) {
+		onRendererShutdown();
+		delete renderer, renderer = NULL;
+	}
+	
+}
+
+bool NullWindow::initializeFramework() {
+	
+	arx_assert(displayModes.empty());
+	
+	displayModes.push_back(DisplayMode(Vec2i(640, 480), 32));
+	displayModes.push_back(DisplayMode(Vec2i(800, 600), 32));
+	displayModes.push_back(DisplayMode(Vec2i(1024, 768), 32));
+	displayModes.push_back(DisplayMode(Vec2i(1280, 720), 32));
+	displayModes.push_back(DisplayMode(Vec2i(1920, 1080), 32));
+	
+	std::sort(displayModes.begin(), displayModes.end());
+	
+	return true;
+}
+
+bool NullWindow::initialize(const std::string & title, Vec2i size, bool fullscreen,
+                            unsigned depth) {
+	
+	arx_assert(!displayModes.empty());
+	
+	title_ = title;
+	size_ = size;
+	depth_ = depth ? depth : 32;
+	isFullscreen_ = fullscreen;
+	
+	onCreate();
+	
+	NullRenderer * nullRenderer = new NullRenderer;
+	
+	if(!config.window.nullRendererLog.empty()) {
+		commandLog.open(fs::path(config.window.nullRendererLog));
+		if(commandLog.is_open()) {
+			nullRenderer->setCommandLog(&commandLog);
+		} else {
+			LogWarning << "Could not open renderer command log " << config.window.nullRendererLog;
+		}
+	}
+	
+	renderer = nullRenderer;
+	renderer->Initialize();
+	renderer->SetViewport(Rect(size_.x, size_.y));
+	
+	onShow(true);
+	onFocus(true);
+	
+	onRendererInit();
+	
+	return true;
+}
+
+void NullWindow::setFullscreenMode(Vec2i resolution, unsigned depth) {
+	
+	if(resolution == Vec2i::ZERO) {
+		resolution = displayModes.back().resolution;
+	}
+	
+	if(isFullscreen_ && size_ == resolution && depth_ == depth) {
+		return;
+	}
+	
+	depth_ = depth ? depth : depth_;
+	renderer->SetViewport(Rect(resolution.x, resolution.y));
+	
+	if(size_ != resolution) {
+		onResize(resolution.x, resolution.y);
+	}
+	
+	if(!isFullscreen_) {
+		isFullscreen_ = true;
+		onToggleFullscreen();
+	}
+	
+}
+
+void NullWindow::setWindowSize(Vec2i size) {
+	
+	if(!isFullscreen_ && size == getSize()) {
+		return;
+	}
+	
+	renderer->SetViewport(Rect(size.x, size.y));
+	
+	if(size_ != size) {
+		onResize(size.x, size.y);
+	}
+	
+	if(isFullscreen_) {
+		isFullscreen_ = false;
+		onToggleFullscreen();
+	}
+	
+}
+
+void NullWindow::showFrame() {
+	static_cast<NullRenderer *>(renderer)->endFrame();
+}
+
+void NullWindow::hide() {
+	onShow(false);
+}
@@ -0,0 +1,57 @@
+/*
+ * Copyright 2013 Arx Libertatis Team (see the AUTHORS file)
+ *
+ * This file is part of Arx Libertatis.
+ *
+ * Arx Libertatis is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Arx Libertatis is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Arx Libertatis.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ARX_WINDOW_NULLWINDOW_H
+#define ARX_WINDOW_NULLWINDOW_H
+
+#include "io/fs/FileStream.h"
+#include "window/RenderWindow.h"
+
+/*!
+ * Window that is never shown, using the NullRenderer.
+ * 
+ * Allows running full frames without a display or GPU, e.g. for CPU benchmarks.
+ */
+class NullWindow : public RenderWindow {
+	
+public:
+	
+	NullWindow();
+	virtual ~NullWindow();
+	
+	bool initializeFramework();
+	bool initialize(const std::string & title, Vec2i size, bool fullscreen,
+	                unsigned depth = 0);
+	void * getHandle() { return NULL; }
+	void setFullscreenMode(Vec2i resolution, unsigned depth = 0);
+	void setWindowSize(Vec2i size);
+	void tick() { }
+	Vec2i getCursorPosition() const { return Vec2i::ZERO; }
+	
+	void showFrame();
+	
+	void hide();
+	
+private:
+	
+	fs::ofstream commandLog;
+	
+};
+
+#endif // ARX_WINDOW_NULLWINDOW_H
@@ -0,0 +1,193 @@
+/*
+ * Copyright 2013 Arx Libertatis Team (see the AUTHORS file)
+ *
+ * This file is part of Arx Libertatis.
+ *
+ * Arx Libertatis is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Arx Libertatis is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Arx Libertatis.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cppunit/TestAssert.h>
+
+#include "AnimationTracksTest.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <string>
+
+CPPUNIT_TEST_SUITE_REGISTRATION(AnimationTracksTest);
+
+namespace {
+
+const size_t KEYS = 40;
+const size_t GROUPS = 12;
+
+EERIE_QUAT axisRotation(float angle) {
+	EERIE_QUAT quat;
+	quat.x = std::sin(angle * 0.5f);
+	quat.y = 0.f;
+	quat.z = 0.f;
+	quat.w = std::cos(angle * 0.5f);
+	return quat;
+}
+
+bool near(float a, float b, float tolerance) {
+	return std::fabs(a - b) <= tolerance;
+}
+
+} // anonymous namespace
+
+void AnimationTracksTest::setUp() {
+	
+	std::srand(1234);
+	
+	groups.resize(KEYS * GROUPS);
+	times.resize(KEYS);
+	
+	float time = 0.f;
+	for(size_t k = 0; k < KEYS; k++) {
+		if(k != 0) {
+			time += float(1 + std::rand() % 4) * (1000.f / 24);
+		}
+		times[k] = time;
+		for(size_t i = 0; i < GROUPS; i++) {
+			EERIE_GROUP & group = groups[i + k * GROUPS];
+			if(i % 3 == 0) {
+				// Unused by the animation
+				group.quat = axisRotation(0.f);
+				group.translate = Vec3f::ZERO;
+				group.zoom = Vec3f::ZERO;
+			} else if(i % 3 == 1) {
+				// Linear motion
+				float t = time * 0.001f;
+				group.quat = axisRotation(t * 0.01f);
+				group.translate = Vec3f(t * 2.f, 5.f, -t);
+				group.zoom = Vec3f::ZERO;
+			} else {
+				// Noisy motion
+				group.quat = axisRotation(float(std::rand() % 628) * 0.01f);
+				group.translate = Vec3f(float(std::rand() % 1000), float(std::rand() % 100), 0.f);
+				group.zoom = Vec3f::repeat(float(std::rand() % 100) * 0.01f);
+			}
+		}
+	}
+	
+	tracks.build(&groups[0], &times[0], KEYS, GROUPS);
+}
+
+void AnimationTracksTest::tolerance() {
+	
+	AnimationTracks::Tolerance limit;
+	
+	for(size_t k = 0; k < KEYS; k++) {
+		for(size_t i = 0; i < GROUPS; i++) {
+			
+			const EERIE_GROUP & expected = groups[i + k * GROUPS];
+			EERIE_GROUP result;
+			tracks.sample(i, k, result);
+			
+			CPPUNIT_ASSERT(near(result.quat.x, expected.quat.x, limit.rotation));
+			CPPUNIT_ASSERT(near(result.quat.y, expected.quat.y, limit.rotation));
+			CPPUNIT_ASSERT(near(result.quat.z, expected.quat.z, limit.rotation));
+			CPPUNIT_ASSERT(near(result.quat.w, expected.quat.w, limit.rotation));
+			CPPUNIT_ASSERT(near(result.translate.x, expected.translate.x, limit.translation));
+			CPPUNIT_ASSERT(near(result.translate.y, expected.translate.y, limit.translation));
+			CPPUNIT_ASSERT(near(result.translate.z, expected.translate.z, limit.translation));
+			CPPUNIT_ASSERT(near(result.zoom.x, expected.zoom.x, limit.zoom));
+			CPPUNIT_ASSERT(near(result.zoom.y, expected.zoom.y, limit.zoom));
+			CPPUNIT_ASSERT(near(result.zoom.z, expected.zoom.z, limit.zoom));
+		}
+	}
+}
+
+void AnimationTracksTest::compression() {
+	
+	// Unused groups are constant, linear motion only needs the end points and
+	// noisy motion needs almost every key
+	size_t smooth = (GROUPS / 3) * (3 + 2 + 2 + 1);
+	CPPUNIT_ASSERT(tracks.storedKeys() <= smooth + (GROUPS / 3) * 3 * KEYS);
+	CPPUNIT_ASSERT(tracks.storedKeys() > smooth + (GROUPS / 3) * 3 * (KEYS - 4));
+	CPPUNIT_ASSERT(tracks.memorySize() < tracks.rawSize() / 2);
+	
+	// Unchanged groups must be exact
+	EERIE_GROUP result;
+	tracks.sample(0, KEYS / 2, result);
+	CPPUNIT_ASSERT(result.quat.w == 1.f && result.quat.x == 0.f);
+	CPPUNIT_ASSERT(result.translate == Vec3f::ZERO && result.zoom == Vec3f::ZERO);
+}
+
+void AnimationTracksTest::cache() {
+	
+	std::string buffer;
+	tracks.serialize(buffer, 42);
+	
+	AnimationTracks loaded;
+	CPPUNIT_ASSERT(!loaded.deserialize(buffer.data(), buffer.size(), 43));
+	CPPUNIT_ASSERT(!loaded.deserialize(buffer.data(), buffer.size() - 1, 42));
+	CPPUNIT_ASSERT(loaded.deserialize(buffer.data(), buffer.size(), 42));
+	
+	CPPUNIT_ASSERT_EQUAL(tracks.storedKeys(), loaded.storedKeys());
+	for(size_t k = 0; k < KEYS; k++) {
+		for(size_t i = 0; i < GROUPS; i++) {
+			EERIE_GROUP a, b;
+			tracks.sample(i, k, a);
+			loaded.sample(i, k, b);
+			CPPUNIT_ASSERT(a.translate == b.translate && a.zoom == b.zoom);
+			CPPUNIT_ASSERT(a.quat.x == b.quat.x && a.quat.y == b.quat.y
+			               && a.quat.z == b.quat.z && a.quat.w == b.quat.w);
+		}
+	}
+}
+
+void AnimationTracksTest::frameTimes() {
+	
+	// Key frames as loaded from a .tea file: the time of each frame is its absolute
+	// frame number at 24 frames per second, and key frames are not evenly spaced.
+	const long frameNumbers[] = { 0, 2, 3, 7, 8, 14, 20, 21, 30, 45 };
+	const size_t keys = ARRAY_SIZE(frameNumbers);
+	
+	std::vector<EERIE_FRAME> frames(keys);
+	std::vector<EERIE_GROUP> motion(keys);
+	for(size_t k = 0; k < keys; k++) {
+		frames[k].num_frame = frameNumbers[k];
+		s32 time_frame = frameNumbers[k] * 1000;
+		frames[k].time = time_frame * (1.f/24);
+		// Constant speed
+		float t = frames[k].time * 0.001f;
+		motion[k].quat = axisRotation(0.5f);
+		motion[k].translate = Vec3f(t * 30.f, -t * 10.f, 2.f);
+		motion[k].zoom = Vec3f::ZERO;
+	}
+	
+	AnimationTracks built;
+	built.build(&motion[0], &frames[0], keys, 1);
+	
+	std::string buffer;
+	built.serialize(buffer, 7);
+	AnimationTracks loaded;
+	CPPUNIT_ASSERT(loaded.deserialize(buffer.data(), buffer.size(), 7));
+	CPPUNIT_ASSERT_EQUAL(keys, loaded.keys());
+	
+	AnimationTracks::Tolerance limit;
+	for(size_t k = 0; k < keys; k++) {
+		CPPUNIT_ASSERT_EQUAL(frames[k].time, loaded.keyTime(k));
+		EERIE_GROUP result;
+		loaded.sample(0, k, result);
+		CPPUNIT_ASSERT(near(result.translate.x, motion[k].translate.x, limit.translation));
+		CPPUNIT_ASSERT(near(result.translate.y, motion[k].translate.y, limit.translation));
+		CPPUNIT_ASSERT(near(result.translate.z, motion[k].translate.z, limit.translation));
+	}
+	
+	// Motion that is linear in the frame time only needs the end points
+	CPPUNIT_ASSERT_EQUAL(size_t(1 + 2 + 1), loaded.storedKeys());
+}
@@ -0,0 +1,53 @@
+/*
+ * Copyright 2013 Arx Libertatis Team (see the AUTHORS file)
+ *
+ * This file is part of Arx Libertatis.
+ *
+ * Arx Libertatis is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Arx Libertatis is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Arx Libertatis.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ARX_ANIMATION_ANIMATIONTRACKSTEST_H
+#define ARX_ANIMATION_ANIMATIONTRACKSTEST_H
+
+#include <vector>
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "animation/AnimationTracks.h"
+
+class AnimationTracksTest : public CppUnit::TestCase {
+	CPPUNIT_TEST_SUITE(AnimationTracksTest);
+	CPPUNIT_TEST(tolerance);
+	CPPUNIT_TEST(compression);
+	CPPUNIT_TEST(cache);
+	CPPUNIT_TEST(frameTimes);
+	CPPUNIT_TEST_SUITE_END();
+public:
+	AnimationTracksTest() : CppUnit::TestCase("AnimationTracksTest") {}
+
+	void setUp();
+
+	void tolerance();
+	void compression();
+	void cache();
+	void frameTimes();
+
+private:
+	std::vector<EERIE_GROUP> groups;
+	std::vector<float> times;
+	AnimationTracks tracks;
+};
+
+#endif // ARX_ANIMATION_ANIMATIONTRACKSTEST_H
@@ -0,0 +1,78 @@
+/*
+ * Copyright 2013 Arx Libertatis Team (see the AUTHORS file)
+ *
+ * This file is part of Arx Libertatis.
+ *
+ * Arx Libertatis is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Arx Libertatis is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Arx Libertatis.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cppunit/TestAssert.h>
+
+#include "FixedTimestepTest.h"
+
+#include "core/FixedTimestep.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION(FixedTimestepTest);
+
+void FixedTimestepTest::accumulate() {
+	
+	FixedTimestep timestep(10.f, 5);
+	
+	CPPUNIT_ASSERT_EQUAL(0u, timestep.advance(4.f));
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(0.4f, timestep.getAlpha(), 1e-5f);
+	
+	CPPUNIT_ASSERT_EQUAL(1u, timestep.advance(7.f));
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(0.1f, timestep.getAlpha(), 1e-5f);
+	
+	CPPUNIT_ASSERT_EQUAL(2u, timestep.advance(20.f));
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(0.1f, timestep.getAlpha(), 1e-5f);
+	
+	// Negative or zero frame times (paused game) never tick
+	CPPUNIT_ASSERT_EQUAL(0u, timestep.advance(0.f));
+	CPPUNIT_ASSERT_EQUAL(0u, timestep.advance(-5.f));
+	
+	timestep.reset();
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(0.f, timestep.getAlpha(), 1e-5f);
+}
+
+void FixedTimestepTest::catchUpLimit() {
+	
+	FixedTimestep timestep(10.f, 3);
+	
+	CPPUNIT_ASSERT_EQUAL(3u, timestep.advance(75.f));
+	CPPUNIT_ASSERT_EQUAL(4u, timestep.getDroppedTicks());
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(0.5f, timestep.getAlpha(), 1e-4f);
+	
+	// The dropped time does not carry over into the next frame
+	CPPUNIT_ASSERT_EQUAL(1u, timestep.advance(10.f));
+}
+
+void FixedTimestepTest::frameRateIndependence() {
+	
+	// One simulated second at 30, 60 and 144 fps must always give 60 ticks
+	const float rates[] = { 30.f, 60.f, 144.f };
+	for(size_t i = 0; i < sizeof(rates) / sizeof(*rates); i++) {
+		
+		FixedTimestep timestep(1000.f / 60.f, 5);
+		
+		unsigned ticks = 0;
+		for(int frame = 0; frame < int(rates[i]); frame++) {
+			ticks += timestep.advance(1000.f / rates[i]);
+		}
+		
+		// Allow for float rounding at the last frame
+		CPPUNIT_ASSERT(ticks == 60 || ticks == 59);
+		CPPUNIT_ASSERT_EQUAL(0u, timestep.getDroppedTicks());
+	}
+}
@@ -0,0 +1,120 @@
+/*
+ * Copyright 2013 Arx Libertatis Team (see the AUTHORS file)
+ *
+ * This file is part of Arx Libertatis.
+ *
+ * Arx Libertatis is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Arx Libertatis is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Arx Libertatis.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*!
+ * Timings for the image kernels at texture sizes.
+ * Not part of arxtest so that the unit tests stay fast and quiet.
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "graphics/image/ImageKernels.h"
+
+namespace {
+
+std::vector<u8> randomImage(size_t size) {
+	std::vector<u8> data(size);
+	for(size_t i = 0; i < size; i++) {
+		data[i] = u8(std::rand());
+	}
+	return data;
+}
+
+//! Microseconds per call, averaged over all iterations
+double elapsedUs(std::clock_t start, size_t iterations) {
+	return double(std::clock() - start) * 1000000.0 / CLOCKS_PER_SEC / double(iterations);
+}
+
+} // anonymous namespace
+
+int main() {
+	
+	std::srand(1234);
+	
+	std::cout << std::fixed << std::setprecision(1);
+	
+	for(size_t size = 64; size <= 1024; size *= 2) {
+		
+		size_t count = size * size;
+		// Process about the same number of pixels for each size
+		size_t iterations = std::max(size_t(4), size_t(16 * 1024 * 1024) / count);
+		
+		const std::vector<u8> rgba = randomImage(count * 4);
+		// Color-keyed textures usually have large transparent areas
+		std::vector<u8> rgb = randomImage(count * 3);
+		std::fill(rgb.begin(), rgb.begin() + count * 3 / 4, 0);
+		std::vector<u8> image, output(count * 4);
+		std::clock_t start;
+		
+		std::cout << size << "x" << size << " (reference / optimized, us):";
+		
+		image = rgba, start = std::clock();
+		for(size_t i = 0; i < iterations; i++) {
+			imagekernels::blurReference(&image[0], size, size, 4, 5);
+		}
+		std::cout << " blur " << elapsedUs(start, iterations);
+		image = rgba, start = std::clock();
+		for(size_t i = 0; i < iterations; i++) {
+			imagekernels::blur(&image[0], size, size, 4, 5);
+		}
+		std::cout << " / " << elapsedUs(start, iterations);
+		
+		image = rgba, start = std::clock();
+		for(size_t i = 0; i < iterations; i++) {
+			imagekernels::quakeGammaReference(&image[0], 4, count, 1.01f);
+		}
+		std::cout << ", gamma " << elapsedUs(start, iterations);
+		image = rgba, start = std::clock();
+		for(size_t i = 0; i < iterations; i++) {
+			imagekernels::quakeGamma(&image[0], 4, count, 1.01f);
+		}
+		std::cout << " / " << elapsedUs(start, iterations);
+		
+		start = std::clock();
+		for(size_t i = 0; i < iterations; i++) {
+			imagekernels::toGrayscaleReference(&rgba[0], 4, &output[0], 2, count);
+		}
+		std::cout << ", grayscale " << elapsedUs(start, iterations);
+		start = std::clock();
+		for(size_t i = 0; i < iterations; i++) {
+			imagekernels::toGrayscale(&rgba[0], 4, &output[0], 2, count);
+		}
+		std::cout << " / " << elapsedUs(start, iterations);
+		
+		start = std::clock();
+		for(size_t i = 0; i < iterations; i++) {
+			imagekernels::applyColorKeyReference(&rgb[0], &output[0], size, size, Color(0, 0, 0));
+		}
+		std::cout << ", color key " << elapsedUs(start, iterations);
+		start = std::clock();
+		for(size_t i = 0; i < iterations; i++) {
+			imagekernels::applyColorKey(&rgb[0], &output[0], size, size, Color(0, 0, 0));
+		}
+		std::cout << " / " << elapsedUs(start, iterations);
+		
+		std::cout << std::endl;
+	}
+	
+	return 0;
+}
@@ -0,0 +1,169 @@
+/*
+ * Copyright 2013 Arx Libertatis Team (see the AUTHORS file)
+ *
+ * This file is part of Arx Libertatis.
+ *
+ * Arx Libertatis is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Arx Libertatis is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Arx Libertatis.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cppunit/TestAssert.h>
+
+#include "ImageKernelsTest.h"
+
+#include <cstdlib>
+#include <vector>
+
+#include "graphics/image/ImageKernels.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION(ImageKernelsTest);
+
+namespace {
+
+//! Sizes to test - odd sizes exercise the scalar tails
+const size_t SIZES[][2] = {
+	{ 1, 1 }, { 2, 7 }, { 5, 3 }, { 13, 17 }, { 31, 8 }, { 64, 64 }, { 67, 45 }
+};
+
+std::vector<u8> randomImage(size_t size) {
+	std::vector<u8> data(size);
+	for(size_t i = 0; i < size; i++) {
+		data[i] = u8(std::rand());
+	}
+	return data;
+}
+
+//! Random RGB image where roughly every fourth pixel is black
+std::vector<u8> randomColorKeyImage(size_t count) {
+	std::vector<u8> data = randomImage(count * 3);
+	for(size_t i = 0; i < count; i++) {
+		if(std::rand() % 4 == 0) {
+			data[i * 3] = data[i * 3 + 1] = data[i * 3 + 2] = 0;
+		}
+	}
+	return data;
+}
+
+} // anonymous namespace
+
+void ImageKernelsTest::setUp() {
+	std::srand(1234);
+}
+
+void ImageKernelsTest::grayscale() {
+	
+	for(size_t s = 0; s < ARRAY_SIZE(SIZES); s++) {
+		size_t count = SIZES[s][0] * SIZES[s][1];
+		for(size_t src = 3; src <= 4; src++) {
+			for(size_t dst = 1; dst <= 2; dst++) {
+				std::vector<u8> image = randomImage(count * src);
+				std::vector<u8> expected(count * dst), result(count * dst);
+				imagekernels::toGrayscaleReference(&image[0], src, &expected[0], dst, count);
+				imagekernels::toGrayscale(&image[0], src, &result[0], dst, count);
+				CPPUNIT_ASSERT(expected == result);
+			}
+		}
+	}
+}
+
+void ImageKernelsTest::colorKey() {
+	
+	const Color key(0, 0, 0);
+	
+	for(size_t s = 0; s < ARRAY_SIZE(SIZES); s++) {
+		
+		size_t w = SIZES[s][0], h = SIZES[s][1];
+		std::vector<u8> image = randomColorKeyImage(w * h);
+		
+		CPPUNIT_ASSERT_EQUAL(imagekernels::containsColorReference(&image[0], w * h, key),
+		                     imagekernels::containsColor(&image[0], w * h, key));
+		
+		std::vector<u8> expected(w * h * 4), result(w * h * 4);
+		imagekernels::applyColorKeyReference(&image[0], &expected[0], w, h, key);
+		imagekernels::applyColorKey(&image[0], &result[0], w, h, key);
+		CPPUNIT_ASSERT(expected == result);
+		
+		// Only the last pixel matches
+		std::vector<u8> gray(w * h * 3, 0x80);
+		CPPUNIT_ASSERT(!imagekernels::containsColor(&gray[0], w * h, key));
+		gray[gray.size() - 1] = gray[gray.size() - 2] = gray[gray.size() - 3] = 0;
+		CPPUNIT_ASSERT(imagekernels::containsColor(&gray[0], w * h, key));
+	}
+}
+
+void ImageKernelsTest::quakeGamma() {
+	
+	const float gammas[] = { 0.5f, 1.5f, 2.f, 10.f };
+	
+	for(size_t s = 0; s < ARRAY_SIZE(SIZES); s++) {
+		size_t count = SIZES[s][0] * SIZES[s][1];
+		for(size_t channels = 1; channels <= 4; channels++) {
+			for(size_t g = 0; g < ARRAY_SIZE(gammas); g++) {
+				std::vector<u8> expected = randomImage(count * channels), result = expected;
+				imagekernels::quakeGammaReference(&expected[0], channels, count, gammas[g]);
+				imagekernels::quakeGamma(&result[0], channels, count, gammas[g]);
+				CPPUNIT_ASSERT(expected == result);
+			}
+		}
+	}
+}
+
+void ImageKernelsTest::blur() {
+	
+	for(size_t s = 0; s < ARRAY_SIZE(SIZES); s++) {
+		size_t w = SIZES[s][0], h = SIZES[s][1];
+		for(size_t channels = 1; channels <= 4; channels++) {
+			for(int radius = 1; radius <= 8; radius++) {
+				std::vector<u8> expected = randomImage(w * h * channels), result = expected;
+				imagekernels::blurReference(&expected[0], w, h, channels, radius);
+				imagekernels::blur(&result[0], w, h, channels, radius);
+				CPPUNIT_ASSERT(expected == result);
+			}
+		}
+	}
+}
+
+void ImageKernelsTest::resize() {
+	
+	// Uniform areas stay uniform
+	std::vector<u8> image(40 * 30 * 3);
+	for(size_t y = 0; y < 30; y++) {
+		for(size_t x = 0; x < 40; x++) {
+			u8 * p = &image[(y * 40 + x) * 3];
+			p[0] = (x < 20) ? 200 : 10, p[1] = 50, p[2] = u8(y < 15 ? 0 : 255);
+		}
+	}
+	
+	std::vector<u8> result(4 * 2 * 3);
+	imagekernels::resize(&image[0], 40, 30, &result[0], 4, 2, 3, false);
+	for(size_t y = 0; y < 2; y++) {
+		for(size_t x = 0; x < 4; x++) {
+			const u8 * p = &result[(y * 4 + x) * 3];
+			CPPUNIT_ASSERT_EQUAL(int(x < 2 ? 200 : 10), int(p[0]));
+			CPPUNIT_ASSERT_EQUAL(50, int(p[1]));
+			CPPUNIT_ASSERT_EQUAL(int(y == 0 ? 0 : 255), int(p[2]));
+		}
+	}
+	
+	// Destination pixels straddling the edge get the area-weighted average
+	std::vector<u8> row(3);
+	const u8 strip[] = { 0, 90, 180 };
+	imagekernels::resize(strip, 3, 1, &row[0], 2, 1, 1, false);
+	CPPUNIT_ASSERT_EQUAL(30, int(row[0])); // (2 * 0 + 1 * 90) / 3
+	CPPUNIT_ASSERT_EQUAL(150, int(row[1])); // (1 * 90 + 2 * 180) / 3
+	
+	// Flipped
+	imagekernels::resize(&image[0], 40, 30, &result[0], 4, 2, 3, true);
+	CPPUNIT_ASSERT_EQUAL(255, int(result[2]));
+	CPPUNIT_ASSERT_EQUAL(0, int(result[4 * 3 + 2]));
+}
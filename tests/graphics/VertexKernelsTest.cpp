@@ -0,0 +1,166 @@
+/*
+ * Copyright 2013 Arx Libertatis Team (see the AUTHORS file)
+ *
+ * This file is part of Arx Libertatis.
+ *
+ * Arx Libertatis is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Arx Libertatis is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Arx Libertatis.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cppunit/TestAssert.h>
+
+#include "VertexKernelsTest.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "graphics/data/VertexKernels.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION(VertexKernelsTest);
+
+namespace {
+
+//! Vertex counts to test - odd counts exercise the scalar tails
+const size_t COUNTS[] = { 0, 1, 3, 4, 7, 16, 33, 250 };
+
+float randomFloat(float range) {
+	return (float(std::rand()) / float(RAND_MAX) * 2.f - 1.f) * range;
+}
+
+Vec3f randomVec3(float range) {
+	return Vec3f(randomFloat(range), randomFloat(range), randomFloat(range));
+}
+
+std::vector<EERIE_3DPAD> randomPositions(size_t count) {
+	std::vector<EERIE_3DPAD> positions(count);
+	for(size_t i = 0; i < count; i++) {
+		static_cast<Vec3f &>(positions[i]) = randomVec3(100.f);
+		positions[i].w = 1.f;
+	}
+	return positions;
+}
+
+std::vector<EERIE_VERTEX> randomVertices(size_t count) {
+	std::vector<EERIE_VERTEX> vertices(count);
+	for(size_t i = 0; i < count; i++) {
+		vertices[i].v = randomVec3(500.f);
+		vertices[i].vert.p = randomVec3(500.f);
+		vertices[i].vert.rhw = 0.f;
+		vertices[i].vworld = Vec3f::ZERO;
+	}
+	return vertices;
+}
+
+//! Every other vertex of a shuffled index list, like a bone's vertex group
+std::vector<long> randomIndices(size_t count) {
+	std::vector<long> indices;
+	for(size_t i = 0; i < count; i += 2) {
+		indices.push_back(long(i));
+	}
+	std::random_shuffle(indices.begin(), indices.end());
+	return indices;
+}
+
+EERIEMATRIX randomMatrix() {
+	EERIEMATRIX matrix;
+	matrix._11 = randomFloat(2.f), matrix._12 = randomFloat(2.f), matrix._13 = randomFloat(2.f);
+	matrix._21 = randomFloat(2.f), matrix._22 = randomFloat(2.f), matrix._23 = randomFloat(2.f);
+	matrix._31 = randomFloat(2.f), matrix._32 = randomFloat(2.f), matrix._33 = randomFloat(2.f);
+	return matrix;
+}
+
+vertexkernels::ProjectionParams randomProjection() {
+	vertexkernels::ProjectionParams params;
+	params.pos = randomVec3(100.f);
+	float a = randomFloat(3.f), b = randomFloat(3.f), c = randomFloat(3.f);
+	params.xsin = std::sin(a), params.xcos = std::cos(a);
+	params.ysin = std::sin(b), params.ycos = std::cos(b);
+	params.zsin = std::sin(c), params.zcos = std::cos(c);
+	params.scaleX = 1.5f, params.scaleY = 2.f;
+	params.depthScale = -1.f, params.depthOffset = 1.f;
+	params.offset = Vec2f(320.f, 240.f);
+	return params;
+}
+
+template <class T>
+bool sameBits(const T & a, const T & b) {
+	return !std::memcmp(&a, &b, sizeof(T));
+}
+
+bool sameVertices(const std::vector<EERIE_VERTEX> & a, const std::vector<EERIE_VERTEX> & b) {
+	for(size_t i = 0; i < a.size(); i++) {
+		if(!sameBits(a[i].v, b[i].v) || !sameBits(a[i].vworld, b[i].vworld)
+		   || !sameBits(a[i].vert.p, b[i].vert.p) || !sameBits(a[i].vert.rhw, b[i].vert.rhw)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+} // anonymous namespace
+
+void VertexKernelsTest::setUp() {
+	std::srand(1234);
+}
+
+void VertexKernelsTest::skin() {
+	
+	for(size_t c = 0; c < ARRAY_SIZE(COUNTS); c++) {
+		
+		size_t count = COUNTS[c];
+		std::vector<EERIE_3DPAD> positions = randomPositions(count);
+		std::vector<long> indices = randomIndices(count);
+		EERIEMATRIX matrix = randomMatrix();
+		Vec3f translation = randomVec3(50.f);
+		
+		std::vector<EERIE_VERTEX> expected = randomVertices(count), result = expected;
+		vertexkernels::skinVerticesReference(matrix, translation, positions.empty() ? NULL : &positions[0],
+		                                     indices.empty() ? NULL : &indices[0], indices.size(),
+		                                     expected.empty() ? NULL : &expected[0]);
+		vertexkernels::skinVertices(matrix, translation, positions.empty() ? NULL : &positions[0],
+		                            indices.empty() ? NULL : &indices[0], indices.size(),
+		                            result.empty() ? NULL : &result[0]);
+		
+		CPPUNIT_ASSERT(sameVertices(expected, result));
+	}
+}
+
+void VertexKernelsTest::project() {
+	
+	for(size_t c = 0; c < ARRAY_SIZE(COUNTS); c++) {
+		
+		size_t count = COUNTS[c];
+		vertexkernels::ProjectionParams params = randomProjection();
+		std::vector<EERIE_VERTEX> expected = randomVertices(count), result = expected;
+		
+		Vec3f min3D = Vec3f::repeat(99999999.f), max3D = Vec3f::repeat(-99999999.f);
+		Vec2f min2D(32000.f, 32000.f), max2D(-32000.f, -32000.f);
+		Vec3f expectedMin3D = min3D, expectedMax3D = max3D;
+		Vec2f expectedMin2D = min2D, expectedMax2D = max2D;
+		
+		vertexkernels::projectVerticesReference(params, expected.empty() ? NULL : &expected[0],
+		                                        count, expectedMin3D, expectedMax3D,
+		                                        expectedMin2D, expectedMax2D);
+		vertexkernels::projectVertices(params, result.empty() ? NULL : &result[0],
+		                               count, min3D, max3D, min2D, max2D);
+		
+		CPPUNIT_ASSERT(sameVertices(expected, result));
+		CPPUNIT_ASSERT(sameBits(expectedMin3D, min3D));
+		CPPUNIT_ASSERT(sameBits(expectedMax3D, max3D));
+		CPPUNIT_ASSERT(sameBits(expectedMin2D, min2D));
+		CPPUNIT_ASSERT(sameBits(expectedMax2D, max2D));
+	}
+}
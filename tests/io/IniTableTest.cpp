@@ -0,0 +1,129 @@
+/*
+ * Copyright 2013 Arx Libertatis Team (see the AUTHORS file)
+ *
+ * This file is part of Arx Libertatis.
+ *
+ * Arx Libertatis is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Arx Libertatis is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Arx Libertatis.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cppunit/TestAssert.h>
+
+#include "IniTableTest.h"
+
+#include <sstream>
+#include <string>
+
+#include "io/IniReader.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION(IniTableTest);
+
+namespace {
+
+const char * const INI =
+	"# comment before the first section\n"
+	"[Menu]\n"
+	"title = Main Menu\n"
+	"Quit=\"Quit game\"\n"
+	"// another comment\n"
+	"quit = duplicate\n"
+	"\n"
+	"[description]\n"
+	"  padded   =   spaces around   \n"
+	"quoted = \"  keep spaces  \"\n"
+	"broken\"=quote before the separator\"\n"
+	"hash = \"# not a comment\"\n"
+	"empty =\n"
+	"\n"
+	"[empty_section]\n"
+	"# only a comment\n";
+
+std::string get(const IniTable & table, const std::string & section, const std::string & key) {
+	return table.get(section, key, "<missing>");
+}
+
+} // anonymous namespace
+
+void IniTableTest::setUp() {
+	std::istringstream iss(INI);
+	IniReader reader;
+	CPPUNIT_ASSERT(reader.read(iss));
+	table.build(reader);
+}
+
+void IniTableTest::sections() {
+	
+	CPPUNIT_ASSERT(!table.empty());
+	
+	// Section names are lowercased by IniReader
+	CPPUNIT_ASSERT_EQUAL(size_t(3), table.getKeyCount("menu"));
+	CPPUNIT_ASSERT_EQUAL(size_t(0), table.getKeyCount("Menu"));
+	CPPUNIT_ASSERT_EQUAL(size_t(5), table.getKeyCount("description"));
+	CPPUNIT_ASSERT_EQUAL(size_t(0), table.getKeyCount("empty_section"));
+	CPPUNIT_ASSERT_EQUAL(size_t(0), table.getKeyCount("missing"));
+	
+	// An empty key resolves to the first key in the section
+	CPPUNIT_ASSERT_EQUAL(std::string("Main Menu"), get(table, "menu", ""));
+	CPPUNIT_ASSERT(!table.get("empty_section", ""));
+	CPPUNIT_ASSERT(!table.get("missing", ""));
+}
+
+void IniTableTest::keys() {
+	
+	CPPUNIT_ASSERT_EQUAL(std::string("Main Menu"), get(table, "menu", "title"));
+	
+	// Key names are lowercased and the first of several identical keys wins
+	CPPUNIT_ASSERT_EQUAL(std::string("Quit game"), get(table, "menu", "quit"));
+	CPPUNIT_ASSERT(!table.get("menu", "Quit"));
+	
+	// Keys are only found in their own section
+	CPPUNIT_ASSERT(!table.get("description", "title"));
+	CPPUNIT_ASSERT(!table.get("menu", "padded"));
+	CPPUNIT_ASSERT(!table.get("menu", "missing"));
+	CPPUNIT_ASSERT_EQUAL(std::string("<missing>"), get(table, "menu", "missing"));
+	
+	// Comment lines don't produce keys
+	CPPUNIT_ASSERT(!table.get("menu", "#"));
+	CPPUNIT_ASSERT(!table.get("menu", "comment"));
+}
+
+void IniTableTest::values() {
+	
+	// Unquoted values are trimmed, quoted values are kept as they are
+	CPPUNIT_ASSERT_EQUAL(std::string("spaces around"), get(table, "description", "padded"));
+	CPPUNIT_ASSERT_EQUAL(std::string("  keep spaces  "), get(table, "description", "quoted"));
+	CPPUNIT_ASSERT_EQUAL(std::string("quote before the separator"),
+	                     get(table, "description", "broken"));
+	CPPUNIT_ASSERT_EQUAL(std::string("# not a comment"), get(table, "description", "hash"));
+	
+	// Empty values are found, unlike missing keys
+	const std::string * empty = table.get("description", "empty");
+	CPPUNIT_ASSERT(empty != NULL);
+	CPPUNIT_ASSERT(empty->empty());
+}
+
+void IniTableTest::rebuild() {
+	
+	std::istringstream iss("[other]\nkey = value\n");
+	IniReader reader;
+	CPPUNIT_ASSERT(reader.read(iss));
+	table.build(reader);
+	
+	CPPUNIT_ASSERT_EQUAL(std::string("value"), get(table, "other", "key"));
+	CPPUNIT_ASSERT(!table.get("menu", "title"));
+	CPPUNIT_ASSERT_EQUAL(size_t(0), table.getKeyCount("menu"));
+	
+	table.clear();
+	CPPUNIT_ASSERT(table.empty());
+	CPPUNIT_ASSERT(!table.get("other", "key"));
+}
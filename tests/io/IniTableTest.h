@@ -0,0 +1,50 @@
+/*
+ * Copyright 2013 Arx Libertatis Team (see the AUTHORS file)
+ *
+ * This file is part of Arx Libertatis.
+ *
+ * Arx Libertatis is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Arx Libertatis is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Arx Libertatis.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ARX_IO_INITABLETEST_H
+#define ARX_IO_INITABLETEST_H
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "io/IniTable.h"
+
+class IniTableTest : public CppUnit::TestCase {
+	CPPUNIT_TEST_SUITE(IniTableTest);
+	CPPUNIT_TEST(sections);
+	CPPUNIT_TEST(keys);
+	CPPUNIT_TEST(values);
+	CPPUNIT_TEST(rebuild);
+	CPPUNIT_TEST_SUITE_END();
+public:
+	IniTableTest() : CppUnit::TestCase("IniTableTest") {}
+
+	void setUp();
+
+	void sections();
+	void keys();
+	void values();
+	void rebuild();
+	
+private:
+	
+	IniTable table;
+};
+
+#endif // ARX_IO_INITABLETEST_H
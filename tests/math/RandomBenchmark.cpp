@@ -0,0 +1,100 @@
+/*
+ * Copyright 2013 Arx Libertatis Team (see the AUTHORS file)
+ *
+ * This file is part of Arx Libertatis.
+ *
+ * Arx Libertatis is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Arx Libertatis is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Arx Libertatis.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*!
+ * Timings for the random number generator compared to the C library rand().
+ * Not part of arxtest so that the unit tests stay fast and quiet.
+ */
+
+#include <cstdlib>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "math/Random.h"
+
+namespace {
+
+double elapsedMs(std::clock_t start) {
+	return double(std::clock() - start) * 1000.0 / CLOCKS_PER_SEC;
+}
+
+} // anonymous namespace
+
+int main() {
+	
+	const size_t count = 1 << 24;
+	std::vector<float> values(count);
+	RandomStream stream("benchmark");
+	std::clock_t start;
+	
+	Random::seed(1234);
+	std::srand(1234);
+	
+	std::cout << std::fixed << std::setprecision(1);
+	std::cout << count << " floats (ms):";
+	
+	start = std::clock();
+	for(size_t i = 0; i < count; i++) {
+		values[i] = std::rand() * (1.0f / RAND_MAX);
+	}
+	std::cout << " rand " << elapsedMs(start);
+	
+	start = std::clock();
+	for(size_t i = 0; i < count; i++) {
+		values[i] = Random::getf();
+	}
+	std::cout << ", getf " << elapsedMs(start);
+	
+	start = std::clock();
+	for(size_t i = 0; i < count; i++) {
+		values[i] = stream.getf();
+	}
+	std::cout << ", stream getf " << elapsedMs(start);
+	
+	start = std::clock();
+	Random::fill(&values[0], &values[0] + count);
+	std::cout << ", fill " << elapsedMs(start) << std::endl;
+	
+	std::cout << count << " ints (ms):";
+	
+	// Sum the values so that the loops can't be optimized away
+	unsigned sum = 0;
+	
+	start = std::clock();
+	for(size_t i = 0; i < count; i++) {
+		sum += unsigned(std::rand() % 100);
+	}
+	std::cout << " rand " << elapsedMs(start);
+	
+	start = std::clock();
+	for(size_t i = 0; i < count; i++) {
+		sum += unsigned(Random::get(0, 99));
+	}
+	std::cout << ", get " << elapsedMs(start);
+	
+	start = std::clock();
+	for(size_t i = 0; i < count; i++) {
+		sum += unsigned(stream.get(0, 99));
+	}
+	std::cout << ", stream get " << elapsedMs(start) << std::endl;
+	
+	return (sum == 0 && values[0] < 0.f) ? 1 : 0;
+}
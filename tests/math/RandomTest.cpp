@@ -0,0 +1,137 @@
+/*
+ * Copyright 2013 Arx Libertatis Team (see the AUTHORS file)
+ *
+ * This file is part of Arx Libertatis.
+ *
+ * Arx Libertatis is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Arx Libertatis is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Arx Libertatis.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cppunit/TestAssert.h>
+
+#include "RandomTest.h"
+
+#include <limits>
+#include <vector>
+
+#include "math/Random.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION(RandomTest);
+
+void RandomTest::ranges() {
+	
+	Random::seed(42);
+	
+	bool seen[7] = { false };
+	for(int i = 0; i < 1000; i++) {
+		int value = Random::get(-3, 3);
+		CPPUNIT_ASSERT(value >= -3 && value <= 3);
+		seen[value + 3] = true;
+	}
+	for(int i = 0; i < 7; i++) {
+		CPPUNIT_ASSERT(seen[i]);
+	}
+	
+	for(int i = 0; i < 1000; i++) {
+		CPPUNIT_ASSERT_EQUAL(5, Random::get(5, 5));
+		
+		float f = Random::getf(-2.f, 2.f);
+		CPPUNIT_ASSERT(f >= -2.f && f < 2.f);
+		
+		double d = Random::getf<double>();
+		CPPUNIT_ASSERT(d >= 0.0 && d < 1.0);
+		
+		u64 big = Random::get<u64>(0, 3000000000ull * 3);
+		CPPUNIT_ASSERT(big <= 3000000000ull * 3);
+		
+		long long neg = Random::get<long long>(-5000000000ll, -4000000000ll);
+		CPPUNIT_ASSERT(neg >= -5000000000ll && neg <= -4000000000ll);
+	}
+	
+	std::vector<float> values(1001);
+	Random::fill(&values[0], &values[0] + values.size(), 10.f, 20.f);
+	double sum = 0.0;
+	for(size_t i = 0; i < values.size(); i++) {
+		CPPUNIT_ASSERT(values[i] >= 10.f && values[i] < 20.f);
+		sum += values[i];
+	}
+	double mean = sum / values.size();
+	CPPUNIT_ASSERT(mean > 14.5 && mean < 15.5);
+	
+	// Most values in a range this narrow would round up to the upper bound
+	const float min = 1.f, max = 1.f + std::numeric_limits<float>::epsilon();
+	for(int i = 0; i < 1000; i++) {
+		CPPUNIT_ASSERT_EQUAL(min, Random::getf(min, max));
+	}
+	Random::fill(&values[0], &values[0] + values.size(), min, max);
+	for(size_t i = 0; i < values.size(); i++) {
+		CPPUNIT_ASSERT_EQUAL(min, values[i]);
+	}
+}
+
+void RandomTest::reproducible() {
+	
+	std::vector<float> a(64), b(64);
+	
+	Random::seed(1234);
+	for(size_t i = 0; i < a.size(); i++) {
+		a[i] = Random::getf();
+	}
+	
+	Random::seed(1234);
+	Random::fill(&b[0], &b[0] + b.size());
+	
+	// Bulk fill must consume the generator exactly like single calls.
+	for(size_t i = 0; i < a.size(); i++) {
+		CPPUNIT_ASSERT_EQUAL(a[i], b[i]);
+	}
+	
+	Random::seed(1235);
+	CPPUNIT_ASSERT(Random::getf() != a[0]);
+}
+
+void RandomTest::streams() {
+	
+	RandomStream effects("effects");
+	RandomStream ai("ai");
+	
+	Random::seed(7);
+	int first[16];
+	for(int i = 0; i < 16; i++) {
+		first[i] = effects.get(0, 1000000);
+	}
+	
+	Random::seed(7);
+	
+	// Using other generators in between must not change the stream.
+	for(int i = 0; i < 16; i++) {
+		Random::get();
+		ai.getf();
+		CPPUNIT_ASSERT_EQUAL(first[i], effects.get(0, 1000000));
+	}
+	
+	// Differently named streams are independent sequences.
+	Random::seed(7);
+	int same = 0;
+	for(int i = 0; i < 16; i++) {
+		same += (ai.get(0, 1000000) == first[i]) ? 1 : 0;
+	}
+	CPPUNIT_ASSERT(same < 4);
+	
+	// A second stream object with the same name replays the same values.
+	RandomStream effects2("effects");
+	Random::seed(7);
+	for(int i = 0; i < 16; i++) {
+		CPPUNIT_ASSERT_EQUAL(first[i], effects2.get(0, 1000000));
+	}
+}
@@ -0,0 +1,364 @@
+/*
+ * Copyright 2013 Arx Libertatis Team (see the AUTHORS file)
+ *
+ * This file is part of Arx Libertatis.
+ *
+ * Arx Libertatis is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Arx Libertatis is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Arx Libertatis.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cppunit/TestAssert.h>
+
+#include "MPSCQueueTest.h"
+
+#include <vector>
+
+#include <pthread.h>
+
+#include "platform/MPSCQueue.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION(MPSCQueueTest);
+
+namespace {
+
+struct Collect {
+	
+	std::vector<u32> * values;
+	
+	explicit Collect(std::vector<u32> & _values) : values(&_values) { }
+	
+	void operator()(u32 value) const {
+		values->push_back(value);
+	}
+	
+};
+
+template <typename Queue>
+void push(Queue & queue, u32 value) {
+	u32 ticket;
+	u32 * slot = queue.reserve(ticket);
+	CPPUNIT_ASSERT(slot != NULL);
+	*slot = value;
+	queue.commit(ticket);
+}
+
+const u32 ProducerCount = 4;
+const u32 ValuesPerProducer = 20000;
+
+//! Values are tagged with the producer id in the high bits
+u32 makeValue(u32 producer, u32 i) {
+	return (producer << 24) | i;
+}
+
+/*!
+ * Check that all values from all producers have been received and that the values
+ * from each producer are in order
+ */
+void checkProducerOrder(const std::vector<u32> & values) {
+	
+	CPPUNIT_ASSERT_EQUAL(size_t(ProducerCount * ValuesPerProducer), values.size());
+	
+	std::vector<u32> next(ProducerCount, 0);
+	for(size_t i = 0; i < values.size(); i++) {
+		u32 producer = values[i] >> 24;
+		CPPUNIT_ASSERT(producer < ProducerCount);
+		CPPUNIT_ASSERT_EQUAL(makeValue(producer, next[producer]), values[i]);
+		next[producer]++;
+	}
+}
+
+template <typename Queue>
+struct Producer {
+	
+	Queue * queue;
+	u32 id;
+	
+	static void * run(void * param) {
+		
+		Producer * producer = static_cast<Producer *>(param);
+		
+		for(u32 i = 0; i < ValuesPerProducer; i++) {
+			post(*producer->queue, makeValue(producer->id, i));
+		}
+		
+		return NULL;
+	}
+	
+	static void post(platform::MPSCQueue<u32, 64> & queue, u32 value) {
+		u32 ticket;
+		u32 * slot;
+		// Spin until the consumer has made room
+		while(!(slot = queue.reserve(ticket))) { }
+		*slot = value;
+		queue.commit(ticket);
+	}
+	
+	static void post(platform::UnboundedMPSCQueue<u32, 64> & queue, u32 value) {
+		queue.push(value);
+	}
+	
+};
+
+//! Run ProducerCount producer threads while consuming all values on this thread
+template <typename Queue>
+std::vector<u32> produceAndConsume(Queue & queue) {
+	
+	Producer<Queue> producers[ProducerCount];
+	pthread_t threads[ProducerCount];
+	for(u32 i = 0; i < ProducerCount; i++) {
+		producers[i].queue = &queue;
+		producers[i].id = i;
+		CPPUNIT_ASSERT_EQUAL(0, pthread_create(&threads[i], NULL, Producer<Queue>::run,
+		                                       &producers[i]));
+	}
+	
+	std::vector<u32> values;
+	while(values.size() < size_t(ProducerCount * ValuesPerProducer)) {
+		queue.consume(Collect(values));
+	}
+	
+	for(u32 i = 0; i < ProducerCount; i++) {
+		pthread_join(threads[i], NULL);
+	}
+	
+	CPPUNIT_ASSERT_EQUAL(size_t(0), queue.consume(Collect(values)));
+	
+	return values;
+}
+
+volatile u32 g_blockedValueReserved = 0;
+volatile u32 g_blockedValueRelease = 0;
+
+//! Value that keeps its producer between reserving and committing a ring slot
+struct BlockingValue {
+	
+	u32 value;
+	bool block;
+	
+	BlockingValue() : value(0), block(false) { }
+	BlockingValue(u32 _value, bool _block = false) : value(_value), block(_block) { }
+	BlockingValue(const BlockingValue & o) : value(o.value), block(o.block) { }
+	
+	BlockingValue & operator=(const BlockingValue & o) {
+		if(o.block) {
+			platform::atomicStore(&g_blockedValueReserved, 1);
+			while(!platform::atomicLoad(&g_blockedValueRelease)) { }
+		}
+		value = o.value;
+		block = false;
+		return *this;
+	}
+	
+};
+
+struct CollectBlocking {
+	
+	std::vector<u32> * values;
+	
+	explicit CollectBlocking(std::vector<u32> & _values) : values(&_values) { }
+	
+	void operator()(const BlockingValue & value) const {
+		values->push_back(value.value);
+	}
+	
+};
+
+typedef platform::UnboundedMPSCQueue<BlockingValue, 4> BlockingQueue;
+
+void * pushBlocked(void * param) {
+	static_cast<BlockingQueue *>(param)->push(BlockingValue(0, true));
+	return NULL;
+}
+
+} // anonymous namespace
+
+void MPSCQueueTest::order() {
+	
+	platform::MPSCQueue<u32, 8> queue;
+	std::vector<u32> values;
+	
+	CPPUNIT_ASSERT_EQUAL(size_t(0), queue.consume(Collect(values)));
+	
+	push(queue, 1);
+	push(queue, 2);
+	push(queue, 3);
+	
+	CPPUNIT_ASSERT_EQUAL(size_t(3), queue.consume(Collect(values)));
+	CPPUNIT_ASSERT_EQUAL(size_t(3), values.size());
+	CPPUNIT_ASSERT_EQUAL(u32(1), values[0]);
+	CPPUNIT_ASSERT_EQUAL(u32(2), values[1]);
+	CPPUNIT_ASSERT_EQUAL(u32(3), values[2]);
+	
+	CPPUNIT_ASSERT_EQUAL(size_t(0), queue.consume(Collect(values)));
+}
+
+void MPSCQueueTest::wraparound() {
+	
+	platform::MPSCQueue<u32, 8> queue;
+	std::vector<u32> values;
+	
+	// 5 does not divide the size so every slot is used at every offset
+	u32 next = 0;
+	for(u32 round = 0; round < 100; round++) {
+		for(u32 i = 0; i < 5; i++) {
+			push(queue, next + i);
+		}
+		values.clear();
+		CPPUNIT_ASSERT_EQUAL(size_t(5), queue.consume(Collect(values)));
+		for(u32 i = 0; i < 5; i++) {
+			CPPUNIT_ASSERT_EQUAL(next + i, values[i]);
+		}
+		next += 5;
+	}
+}
+
+void MPSCQueueTest::full() {
+	
+	platform::MPSCQueue<u32, 8> queue;
+	std::vector<u32> values;
+	
+	for(u32 i = 0; i < 8; i++) {
+		push(queue, i);
+	}
+	
+	u32 ticket;
+	CPPUNIT_ASSERT(queue.reserve(ticket) == NULL);
+	
+	CPPUNIT_ASSERT_EQUAL(size_t(8), queue.consume(Collect(values)));
+	
+	// Consuming frees up all slots again
+	for(u32 i = 0; i < 8; i++) {
+		push(queue, 8 + i);
+	}
+	CPPUNIT_ASSERT(queue.reserve(ticket) == NULL);
+	
+	CPPUNIT_ASSERT_EQUAL(size_t(8), queue.consume(Collect(values)));
+	for(u32 i = 0; i < 16; i++) {
+		CPPUNIT_ASSERT_EQUAL(i, values[i]);
+	}
+}
+
+void MPSCQueueTest::uncommitted() {
+	
+	platform::MPSCQueue<u32, 8> queue;
+	std::vector<u32> values;
+	
+	push(queue, 1);
+	
+	u32 ticket;
+	u32 * slot = queue.reserve(ticket);
+	CPPUNIT_ASSERT(slot != NULL);
+	
+	push(queue, 3);
+	
+	// Consumption stops at the first slot that has not been committed
+	CPPUNIT_ASSERT_EQUAL(size_t(1), queue.consume(Collect(values)));
+	
+	*slot = 2;
+	queue.commit(ticket);
+	
+	CPPUNIT_ASSERT_EQUAL(size_t(2), queue.consume(Collect(values)));
+	CPPUNIT_ASSERT_EQUAL(size_t(3), values.size());
+	CPPUNIT_ASSERT_EQUAL(u32(2), values[1]);
+	CPPUNIT_ASSERT_EQUAL(u32(3), values[2]);
+}
+
+void MPSCQueueTest::highWaterMark() {
+	
+	platform::MPSCQueue<u32, 8> queue;
+	std::vector<u32> values;
+	
+	CPPUNIT_ASSERT_EQUAL(u32(0), queue.highWaterMark());
+	
+	for(u32 i = 0; i < 6; i++) {
+		push(queue, i);
+	}
+	queue.consume(Collect(values));
+	CPPUNIT_ASSERT_EQUAL(u32(6), queue.highWaterMark());
+	
+	push(queue, 6);
+	push(queue, 7);
+	queue.consume(Collect(values));
+	CPPUNIT_ASSERT_EQUAL(u32(6), queue.highWaterMark());
+	
+	for(u32 i = 0; i < 8; i++) {
+		push(queue, i);
+	}
+	queue.consume(Collect(values));
+	CPPUNIT_ASSERT_EQUAL(u32(8), queue.highWaterMark());
+}
+
+void MPSCQueueTest::multipleProducers() {
+	platform::MPSCQueue<u32, 64> queue;
+	checkProducerOrder(produceAndConsume(queue));
+}
+
+void MPSCQueueTest::overflow() {
+	
+	platform::UnboundedMPSCQueue<u32, 4> queue;
+	std::vector<u32> values;
+	
+	// More values than fit in the ring buffer
+	for(u32 i = 0; i < 10; i++) {
+		queue.push(i);
+	}
+	
+	CPPUNIT_ASSERT_EQUAL(size_t(10), queue.consume(Collect(values)));
+	for(u32 i = 0; i < 10; i++) {
+		CPPUNIT_ASSERT_EQUAL(i, values[i]);
+	}
+	CPPUNIT_ASSERT_EQUAL(u32(4), queue.highWaterMark());
+	
+	// The ring buffer is used again once the overflow has been consumed
+	queue.push(10);
+	CPPUNIT_ASSERT_EQUAL(size_t(1), queue.consume(Collect(values)));
+	CPPUNIT_ASSERT_EQUAL(u32(10), values.back());
+	
+	for(u32 i = 0; i < 10; i++) {
+		queue.push(i);
+	}
+	queue.clear();
+	CPPUNIT_ASSERT_EQUAL(size_t(0), queue.consume(Collect(values)));
+}
+
+void MPSCQueueTest::overflowMultipleProducers() {
+	platform::UnboundedMPSCQueue<u32, 64> queue;
+	checkProducerOrder(produceAndConsume(queue));
+}
+
+void MPSCQueueTest::overflowUncommitted() {
+	
+	BlockingQueue queue;
+	std::vector<u32> values;
+	
+	// Another thread reserves the first ring slot but does not commit it yet
+	pthread_t thread;
+	CPPUNIT_ASSERT_EQUAL(0, pthread_create(&thread, NULL, pushBlocked, &queue));
+	while(!platform::atomicLoad(&g_blockedValueReserved)) { }
+	
+	// Fill the rest of the ring, then overflow
+	for(u32 i = 1; i <= 5; i++) {
+		queue.push(BlockingValue(i));
+	}
+	
+	// Values 1-3 are stuck behind the uncommitted slot, so 4 and 5 must wait too
+	CPPUNIT_ASSERT_EQUAL(size_t(0), queue.consume(CollectBlocking(values)));
+	
+	platform::atomicStore(&g_blockedValueRelease, 1);
+	pthread_join(thread, NULL);
+	
+	CPPUNIT_ASSERT_EQUAL(size_t(6), queue.consume(CollectBlocking(values)));
+	for(u32 i = 0; i < 6; i++) {
+		CPPUNIT_ASSERT_EQUAL(i, values[i]);
+	}
+}
@@ -0,0 +1,52 @@
+/*
+ * Copyright 2013 Arx Libertatis Team (see the AUTHORS file)
+ *
+ * This file is part of Arx Libertatis.
+ *
+ * Arx Libertatis is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Arx Libertatis is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Arx Libertatis.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ARX_PLATFORM_MPSCQUEUETEST_H
+#define ARX_PLATFORM_MPSCQUEUETEST_H
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+class MPSCQueueTest : public CppUnit::TestCase {
+	CPPUNIT_TEST_SUITE(MPSCQueueTest);
+	CPPUNIT_TEST(order);
+	CPPUNIT_TEST(wraparound);
+	CPPUNIT_TEST(full);
+	CPPUNIT_TEST(uncommitted);
+	CPPUNIT_TEST(highWaterMark);
+	CPPUNIT_TEST(multipleProducers);
+	CPPUNIT_TEST(overflow);
+	CPPUNIT_TEST(overflowMultipleProducers);
+	CPPUNIT_TEST(overflowUncommitted);
+	CPPUNIT_TEST_SUITE_END();
+public:
+	MPSCQueueTest() : CppUnit::TestCase("MPSCQueueTest") {}
+
+	void order();
+	void wraparound();
+	void full();
+	void uncommitted();
+	void highWaterMark();
+	void multipleProducers();
+	void overflow();
+	void overflowMultipleProducers();
+	void overflowUncommitted();
+};
+
+#endif // ARX_PLATFORM_MPSCQUEUETEST_H
@@ -0,0 +1,191 @@
+/*
+ * Copyright 2013 Arx Libertatis Team (see the AUTHORS file)
+ *
+ * This file is part of Arx Libertatis.
+ *
+ * Arx Libertatis is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Arx Libertatis is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Arx Libertatis.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cppunit/TestAssert.h>
+
+#include "RoomCullingTest.h"
+
+#include <cstdlib>
+
+CPPUNIT_TEST_SUITE_REGISTRATION(RoomCullingTest);
+
+namespace {
+
+float randomFloat(float min, float max) {
+	return min + (max - min) * (float(std::rand()) / float(RAND_MAX));
+}
+
+Vec3f randomVector(float min, float max) {
+	return Vec3f(randomFloat(min, max), randomFloat(min, max), randomFloat(min, max));
+}
+
+// Per-polygon tests as done by ARX_PORTALS_Frustrum_RenderRoomTCullSoft before batching
+
+bool isSphereInFrustrum(float radius, const Vec3f & point, const EERIE_FRUSTRUM & frustrum) {
+	for(long p = 0; p < 4; p++) {
+		const EERIE_FRUSTRUM_PLANE & plane = frustrum.plane[p];
+		float dist = point.x * plane.a + point.y * plane.b + point.z * plane.c + plane.d;
+		if(!(dist + radius > 0)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool isPolyVisible(const EERIEPOLY & ep, const EERIE_FRUSTRUM_DATA & frustrums,
+                   const EERIE_FRUSTRUM_PLANE & near, const Vec3f & camera, float & fDist) {
+	
+	bool inside = false;
+	for(long i = 0; i < frustrums.nb_frustrums; i++) {
+		if(isSphereInFrustrum(ep.v[0].rhw, ep.center, frustrums.frustrums[i])) {
+			inside = true;
+			break;
+		}
+	}
+	if(!inside) {
+		return false;
+	}
+	
+	fDist = ep.center.x * near.a + ep.center.y * near.b + ep.center.z * near.c + near.d;
+	if(ep.v[0].rhw < -fDist) {
+		return false;
+	}
+	fDist -= ep.v[0].rhw;
+	
+	Vec3f nrm = ep.v[2].p - camera;
+	if(ep.type & POLY_QUAD) {
+		if(!(ep.type & POLY_DOUBLESIDED) && dot(ep.norm, nrm) > 0.f && dot(ep.norm2, nrm) > 0.f) {
+			return false;
+		}
+	} else {
+		if(!(ep.type & POLY_DOUBLESIDED) && dot(ep.norm, nrm) > 0.f) {
+			return false;
+		}
+	}
+	
+	return true;
+}
+
+void setPlane(EERIE_FRUSTRUM_PLANE & plane, const Vec3f & normal, float d) {
+	Vec3f n = normal.getNormalized();
+	plane.a = n.x, plane.b = n.y, plane.c = n.z, plane.d = d;
+}
+
+} // anonymous namespace
+
+void RoomCullingTest::setUp() {
+	
+	std::srand(1234);
+	
+	// Odd number of polygons to exercise the padding
+	polys.resize(1023);
+	drawable.resize(polys.size());
+	data.clear();
+	
+	for(size_t i = 0; i < polys.size(); i++) {
+		EERIEPOLY & ep = polys[i];
+		// Only the fields read by the culling code are set
+		ep.type = PolyType::load(0);
+		if(std::rand() % 2) {
+			ep.type |= POLY_QUAD;
+		}
+		if(std::rand() % 4 == 0) {
+			ep.type |= POLY_DOUBLESIDED;
+		}
+		ep.center = randomVector(-2000.f, 2000.f);
+		ep.v[0].rhw = randomFloat(0.f, 150.f);
+		for(long k = 0; k < 4; k++) {
+			ep.v[k].p = ep.center + randomVector(-100.f, 100.f);
+		}
+		ep.norm = randomVector(-1.f, 1.f).getNormalized();
+		ep.norm2 = randomVector(-1.f, 1.f).getNormalized();
+		drawable[i] = (std::rand() % 8 != 0);
+		data.add(ep, drawable[i]);
+	}
+	
+	frustrums.nb_frustrums = 3;
+	for(long f = 0; f < frustrums.nb_frustrums; f++) {
+		for(long p = 0; p < 4; p++) {
+			setPlane(frustrums.frustrums[f].plane[p], randomVector(-1.f, 1.f), randomFloat(-500.f, 1500.f));
+		}
+	}
+	
+	setPlane(near, Vec3f(0.2f, 0.1f, 1.f), 50.f);
+	camera = randomVector(-500.f, 500.f);
+}
+
+void RoomCullingTest::reference() {
+	
+	std::vector<u32> visible(polys.size());
+	std::vector<float> dist(polys.size());
+	size_t count = data.cullScalar(frustrums, near, camera, &visible[0], &dist[0]);
+	
+	size_t expected = 0;
+	for(size_t i = 0; i < polys.size(); i++) {
+		float fDist;
+		if(!drawable[i] || !isPolyVisible(polys[i], frustrums, near, camera, fDist)) {
+			continue;
+		}
+		CPPUNIT_ASSERT(expected < count);
+		CPPUNIT_ASSERT_EQUAL(u32(i), visible[expected]);
+		CPPUNIT_ASSERT_EQUAL(fDist, dist[expected]);
+		expected++;
+	}
+	
+	CPPUNIT_ASSERT_EQUAL(expected, count);
+	CPPUNIT_ASSERT(count > 0 && count < polys.size());
+}
+
+void RoomCullingTest::noFrustums() {
+	
+	frustrums.nb_frustrums = 0;
+	
+	std::vector<u32> visible(polys.size());
+	std::vector<float> dist(polys.size());
+	CPPUNIT_ASSERT_EQUAL(size_t(0), data.cull(frustrums, near, camera, &visible[0], &dist[0]));
+}
+
+void RoomCullingTest::simd() {
+	
+#ifdef ARX_HAVE_SSE2_CULLING
+	
+	for(long n = 1; n <= MAX_FRUSTRUMS; n *= 2) {
+		
+		frustrums.nb_frustrums = n;
+		for(long f = 0; f < n; f++) {
+			for(long p = 0; p < 4; p++) {
+				setPlane(frustrums.frustrums[f].plane[p], randomVector(-1.f, 1.f),
+				         randomFloat(-500.f, 1500.f));
+			}
+		}
+		
+		std::vector<u32> visible(polys.size()), visibleSSE2(polys.size());
+		std::vector<float> dist(polys.size()), distSSE2(polys.size());
+		size_t count = data.cullScalar(frustrums, near, camera, &visible[0], &dist[0]);
+		size_t countSSE2 = data.cullSSE2(frustrums, near, camera, &visibleSSE2[0], &distSSE2[0]);
+		
+		CPPUNIT_ASSERT_EQUAL(count, countSSE2);
+		for(size_t i = 0; i < count; i++) {
+			CPPUNIT_ASSERT_EQUAL(visible[i], visibleSSE2[i]);
+			CPPUNIT_ASSERT_EQUAL(dist[i], distSSE2[i]);
+		}
+	}
+	
+#endif
+}
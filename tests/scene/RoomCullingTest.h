@@ -0,0 +1,52 @@
+/*
+ * Copyright 2013 Arx Libertatis Team (see the AUTHORS file)
+ *
+ * This file is part of Arx Libertatis.
+ *
+ * Arx Libertatis is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Arx Libertatis is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Arx Libertatis.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ARX_SCENE_ROOMCULLINGTEST_H
+#define ARX_SCENE_ROOMCULLINGTEST_H
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "scene/RoomCulling.h"
+
+class RoomCullingTest : public CppUnit::TestCase {
+	CPPUNIT_TEST_SUITE(RoomCullingTest);
+	CPPUNIT_TEST(reference);
+	CPPUNIT_TEST(noFrustums);
+	CPPUNIT_TEST(simd);
+	CPPUNIT_TEST_SUITE_END();
+public:
+	RoomCullingTest() : CppUnit::TestCase("RoomCullingTest") {}
+
+	void setUp();
+
+	void reference();
+	void noFrustums();
+	void simd();
+
+private:
+	std::vector<EERIEPOLY> polys;
+	std::vector<bool> drawable;
+	RoomCullData data;
+	EERIE_FRUSTRUM_DATA frustrums;
+	EERIE_FRUSTRUM_PLANE near;
+	Vec3f camera;
+};
+
+#endif // ARX_SCENE_ROOMCULLINGTEST_H
@@ -0,0 +1,137 @@
+/*
+ * Copyright 2013 Arx Libertatis Team (see the AUTHORS file)
+ *
+ * This file is part of Arx Libertatis.
+ *
+ * Arx Libertatis is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Arx Libertatis is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Arx Libertatis.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cppunit/TestAssert.h>
+
+#include "TimerQueueTest.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TimerQueueTest);
+
+void TimerQueueTest::setUp() {
+	queue.reset(300);
+}
+
+void TimerQueueTest::order() {
+	
+	queue.schedule(0, 30);
+	queue.schedule(1, 10);
+	queue.schedule(2, 20);
+	queue.schedule(3, 20);
+	
+	long index;
+	CPPUNIT_ASSERT(queue.pop(100, index));
+	CPPUNIT_ASSERT_EQUAL(1l, index);
+	// Timers with the same fire time are returned in slot order
+	CPPUNIT_ASSERT(queue.pop(100, index));
+	CPPUNIT_ASSERT_EQUAL(2l, index);
+	CPPUNIT_ASSERT(queue.pop(100, index));
+	CPPUNIT_ASSERT_EQUAL(3l, index);
+	CPPUNIT_ASSERT(queue.pop(100, index));
+	CPPUNIT_ASSERT_EQUAL(0l, index);
+	CPPUNIT_ASSERT(!queue.pop(100, index));
+	CPPUNIT_ASSERT_EQUAL(size_t(0), queue.size());
+}
+
+void TimerQueueTest::due() {
+	
+	queue.schedule(0, 10);
+	queue.schedule(1, 20);
+	
+	long index;
+	CPPUNIT_ASSERT(!queue.pop(9, index));
+	CPPUNIT_ASSERT(queue.pop(10, index));
+	CPPUNIT_ASSERT_EQUAL(0l, index);
+	CPPUNIT_ASSERT(!queue.pop(19, index));
+	CPPUNIT_ASSERT(queue.pop(25, index));
+	CPPUNIT_ASSERT_EQUAL(1l, index);
+}
+
+void TimerQueueTest::invalidate() {
+	
+	queue.schedule(0, 10);
+	queue.schedule(1, 20);
+	queue.schedule(2, 30);
+	
+	// Cleared timer
+	queue.invalidate(1);
+	
+	// Re-used slot - only the new entry must fire
+	queue.invalidate(0);
+	queue.schedule(0, 40);
+	
+	long index;
+	CPPUNIT_ASSERT(queue.pop(100, index));
+	CPPUNIT_ASSERT_EQUAL(2l, index);
+	CPPUNIT_ASSERT(queue.pop(100, index));
+	CPPUNIT_ASSERT_EQUAL(0l, index);
+	CPPUNIT_ASSERT(!queue.pop(100, index));
+}
+
+void TimerQueueTest::deferred() {
+	
+	queue.schedule(0, 10);
+	queue.schedule(1, 20);
+	
+	queue.beginDeferred();
+	
+	long index;
+	CPPUNIT_ASSERT(queue.pop(100, index));
+	CPPUNIT_ASSERT_EQUAL(0l, index);
+	
+	// Re-armed timers and new timers must not fire again until endDeferred()
+	queue.schedule(0, 15);
+	queue.schedule(2, 5);
+	
+	CPPUNIT_ASSERT(queue.pop(100, index));
+	CPPUNIT_ASSERT_EQUAL(1l, index);
+	CPPUNIT_ASSERT(!queue.pop(100, index));
+	
+	queue.endDeferred();
+	
+	CPPUNIT_ASSERT(queue.pop(100, index));
+	CPPUNIT_ASSERT_EQUAL(2l, index);
+	CPPUNIT_ASSERT(queue.pop(100, index));
+	CPPUNIT_ASSERT_EQUAL(0l, index);
+	CPPUNIT_ASSERT(!queue.pop(100, index));
+}
+
+void TimerQueueTest::compact() {
+	
+	for(long i = 0; i < 200; i++) {
+		queue.schedule(i, 1000 - i);
+	}
+	for(long i = 0; i < 150; i++) {
+		queue.invalidate(i);
+	}
+	
+	// Few stale entries compared to the number of active timers
+	queue.compact(200);
+	CPPUNIT_ASSERT_EQUAL(size_t(200), queue.size());
+	
+	queue.compact(50);
+	CPPUNIT_ASSERT_EQUAL(size_t(50), queue.size());
+	
+	for(long i = 199; i >= 150; i--) {
+		long index;
+		CPPUNIT_ASSERT(queue.pop(1000, index));
+		CPPUNIT_ASSERT_EQUAL(i, index);
+	}
+	long index;
+	CPPUNIT_ASSERT(!queue.pop(1000, index));
+}
@@ -0,0 +1,52 @@
+/*
+ * Copyright 2013 Arx Libertatis Team (see the AUTHORS file)
+ *
+ * This file is part of Arx Libertatis.
+ *
+ * Arx Libertatis is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Arx Libertatis is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Arx Libertatis.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ARX_SCRIPT_TIMERQUEUETEST_H
+#define ARX_SCRIPT_TIMERQUEUETEST_H
+
+#include <cppunit/TestCase.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "script/TimerQueue.h"
+
+class TimerQueueTest : public CppUnit::TestCase {
+	CPPUNIT_TEST_SUITE(TimerQueueTest);
+	CPPUNIT_TEST(order);
+	CPPUNIT_TEST(due);
+	CPPUNIT_TEST(invalidate);
+	CPPUNIT_TEST(deferred);
+	CPPUNIT_TEST(compact);
+	CPPUNIT_TEST_SUITE_END();
+public:
+	TimerQueueTest() : CppUnit::TestCase("TimerQueueTest") {}
+
+	void setUp();
+
+	void order();
+	void due();
+	void invalidate();
+	void deferred();
+	void compact();
+	
+private:
+	
+	TimerQueue queue;
+};
+
+#endif // ARX_SCRIPT_TIMERQUEUETEST_H